@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "bench.h"
+
+// Runs every registered benchmark, or those whose name contains the
+// filter, and prints per-operation times. --json saves them, raw samples
+// included, for diffing between commits.
+// Usage: GEARS_BENCH [--filter text] [--warmup n] [--repetitions n] [--json file] [--list] 2>/dev/null
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Benchmark
+    {
+        const char*          Name;
+        Gears::BenchFunction Function;
+    };
+
+    // Filled during static initialization, before main
+    std::vector<Benchmark>& GetRegistry()
+    {
+        static std::vector<Benchmark> registry;
+        return registry;
+    }
+
+    void PrintResult(const Gears::BenchResult& result)
+    {
+        if (!result.Skipped.empty())
+        {
+            printf("%-40s skipped: %s\n", result.Name.c_str(), result.Skipped.c_str());
+            return;
+        }
+
+        printf("%-40s %12.1f ns median %12.1f p10 %12.1f p90 %12.1f max\n",
+            result.Name.c_str(), result.MedianNs, result.P10Ns, result.P90Ns, result.MaxNs);
+    }
+
+    // Names are ours, quotes and backslashes are all that can need escaping
+    std::string JsonString(const std::string& text)
+    {
+        std::string escaped = "\"";
+
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                escaped += '\\';
+
+            escaped += c;
+        }
+
+        return escaped + "\"";
+    }
+
+    bool WriteJson(const char* path, const Gears::BenchSettings& settings, const std::vector<Gears::BenchResult>& results)
+    {
+        FILE* file = fopen(path, "w");
+
+        if (file == nullptr)
+            return false;
+
+        fprintf(file, "{\n  \"warmup\": %u,\n  \"repetitions\": %u,\n  \"threads\": %u,\n  \"benchmarks\": [",
+            settings.Warmup, settings.Repetitions, std::thread::hardware_concurrency());
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Gears::BenchResult& result = results[i];
+            fprintf(file, "%s\n    { \"name\": %s", i == 0 ? "" : ",", JsonString(result.Name).c_str());
+
+            if (!result.Skipped.empty())
+            {
+                fprintf(file, ", \"skipped\": %s }", JsonString(result.Skipped).c_str());
+                continue;
+            }
+
+            fprintf(file, ", \"operations\": %llu, \"min_ns\": %.3f, \"p10_ns\": %.3f, \"median_ns\": %.3f, \"p90_ns\": %.3f, \"max_ns\": %.3f, \"mean_ns\": %.3f, \"samples_ns\": [",
+                static_cast<unsigned long long>(result.Operations), result.MinNs, result.P10Ns, result.MedianNs, result.P90Ns, result.MaxNs, result.MeanNs);
+
+            for (size_t s = 0; s < result.SamplesNs.size(); ++s)
+                fprintf(file, "%s%.3f", s == 0 ? "" : ", ", result.SamplesNs[s]);
+
+            fprintf(file, "] }");
+        }
+
+        fprintf(file, "\n  ]\n}\n");
+        return fclose(file) == 0;
+    }
+}
+
+double Gears::Percentile(const std::vector<double>& sorted, double percentile)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    double rank = percentile / 100.0 * static_cast<double>(sorted.size() - 1);
+    size_t below = static_cast<size_t>(rank);
+    size_t above = std::min(below + 1, sorted.size() - 1);
+
+    return sorted[below] + (sorted[above] - sorted[below]) * (rank - static_cast<double>(below));
+}
+
+void Gears::BenchRun::Measure(uint64_t operations, const std::function<void()>& body, const std::function<void()>& reset)
+{
+    if (!m_Result.SamplesNs.empty() || operations == 0)
+        return;
+
+    m_Result.Operations = operations;
+    m_Result.SamplesNs.reserve(m_Settings.Repetitions);
+
+    for (uint32_t i = 0; i < m_Settings.Warmup + m_Settings.Repetitions; ++i)
+    {
+        auto start = Clock::now();
+        body();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+        if (reset)
+            reset();
+
+        if (i >= m_Settings.Warmup)
+            m_Result.SamplesNs.push_back(ns / static_cast<double>(operations));
+    }
+
+    std::vector<double>& samples = m_Result.SamplesNs;
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0.0;
+
+    for (double sample : samples)
+        sum += sample;
+
+    m_Result.MinNs = samples.front();
+    m_Result.P10Ns = Percentile(samples, 10.0);
+    m_Result.MedianNs = Percentile(samples, 50.0);
+    m_Result.P90Ns = Percentile(samples, 90.0);
+    m_Result.MaxNs = samples.back();
+    m_Result.MeanNs = sum / static_cast<double>(samples.size());
+}
+
+Gears::BenchRegistrar::BenchRegistrar(const char* name, BenchFunction function)
+{
+    GetRegistry().push_back({ name, function });
+}
+
+int main(int argc, char** argv)
+{
+    Gears::BenchSettings settings;
+    const char* filter = "";
+    const char* json = nullptr;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--filter") == 0 && hasValue)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--warmup") == 0 && hasValue)
+            settings.Warmup = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+        else if (strcmp(argv[i], "--repetitions") == 0 && hasValue)
+            settings.Repetitions = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        else if (strcmp(argv[i], "--json") == 0 && hasValue)
+            json = argv[++i];
+        else if (strcmp(argv[i], "--list") == 0)
+            list = true;
+        else
+        {
+            fprintf(stderr, "Usage: %s [--filter text] [--warmup n] [--repetitions n] [--json file] [--list]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Registration order depends on link order, names do not
+    std::vector<Benchmark> benchmarks = GetRegistry();
+    std::sort(benchmarks.begin(), benchmarks.end(), [](const Benchmark& a, const Benchmark& b) { return strcmp(a.Name, b.Name) < 0; });
+
+    std::vector<Gears::BenchResult> results;
+
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (strstr(benchmark.Name, filter) == nullptr)
+            continue;
+
+        if (list)
+        {
+            printf("%s\n", benchmark.Name);
+            continue;
+        }
+
+        Gears::BenchResult result;
+        result.Name = benchmark.Name;
+
+        Gears::BenchRun run{ settings, result };
+        benchmark.Function(run);
+
+        if (result.Skipped.empty() && result.SamplesNs.empty())
+            result.Skipped = "Nothing measured";
+
+        PrintResult(result);
+        fflush(stdout);
+        results.push_back(std::move(result));
+    }
+
+    if (json != nullptr && !list && !WriteJson(json, settings, results))
+    {
+        fprintf(stderr, "Could not write %s\n", json);
+        return 1;
+    }
+
+    return 0;
+}
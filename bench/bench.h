@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define GEARS_BENCH_CONCAT_IMPL(a, b) a##b
+#define GEARS_BENCH_CONCAT(a, b) GEARS_BENCH_CONCAT_IMPL(a, b)
+
+// Registers a benchmark with GEARS_BENCH, named "module/case" for --filter.
+// The body sets up once and hands the part to time to run.Measure.
+#define GEARS_BENCHMARK(name) GEARS_BENCHMARK_IMPL(name, GEARS_BENCH_CONCAT(gearsBenchmark, __LINE__))
+#define GEARS_BENCHMARK_IMPL(name, function) \
+    static void function(::Gears::BenchRun& run); \
+    static const ::Gears::BenchRegistrar GEARS_BENCH_CONCAT(function, Registrar){ name, function }; \
+    static void function(::Gears::BenchRun& run)
+
+namespace Gears
+{
+    struct BenchSettings
+    {
+        uint32_t Warmup      = 3;  // Samples taken and thrown away first, caches and pools settle
+        uint32_t Repetitions = 15; // Samples kept
+    };
+
+    struct BenchResult
+    {
+        std::string         Name;
+        std::string         Skipped;        // Why it did not run, empty when it did
+        uint64_t            Operations = 0; // Per sample, every time is per operation
+        std::vector<double> SamplesNs;      // Sorted
+        double              MinNs      = 0.0;
+        double              P10Ns      = 0.0;
+        double              MedianNs   = 0.0;
+        double              P90Ns      = 0.0;
+        double              MaxNs      = 0.0;
+        double              MeanNs     = 0.0;
+    };
+
+    // Linear between the two closest ranks, percentile in [0, 100]
+    double Percentile(const std::vector<double>& sorted, double percentile);
+
+    class BenchRun
+    {
+        public:
+
+        BenchRun(const BenchSettings& settings, BenchResult& result) : m_Settings( settings ), m_Result( result ) {}
+
+        // Calls body Warmup + Repetitions times and times each call, which
+        // performs operations of whatever is measured. reset runs untimed
+        // after every call, e.g. to flush or rewind. Once per benchmark.
+        void                 Measure(uint64_t operations, const std::function<void()>& body, const std::function<void()>& reset = {});
+
+        // For benchmarks that cannot run here, e.g. without a Vulkan driver
+        void                 Skip(const char* reason) { m_Result.Skipped = reason; }
+
+        private:
+
+        const BenchSettings& m_Settings;
+        BenchResult&         m_Result;
+    };
+
+    using BenchFunction = void (*)(BenchRun& run);
+
+    struct BenchRegistrar
+    {
+        BenchRegistrar(const char* name, BenchFunction function);
+    };
+}
@@ -0,0 +1,95 @@
+#include <cstdlib>
+#include <vector>
+
+#include "bench.h"
+#include "frame_arena.h"
+#include "ring_allocator.h"
+#include "tlsf.h"
+
+// Per-allocation cost of the engine's CPU-side allocators, with malloc as
+// the baseline. Sizes follow a fixed pseudo-random sequence, the same every
+// run, between 16 bytes and 4 KiB.
+
+namespace
+{
+    constexpr uint32_t ALLOCATIONS = 4096;
+
+    std::vector<uint32_t> MakeSizes()
+    {
+        std::vector<uint32_t> sizes(ALLOCATIONS);
+        uint32_t state = 0x9E3779B9u;
+
+        for (uint32_t& size : sizes)
+        {
+            state = state * 1664525u + 1013904223u;
+            size = 16 + (state >> 8) % 4080;
+        }
+
+        return sizes;
+    }
+
+    const std::vector<uint32_t> s_Sizes = MakeSizes();
+}
+
+GEARS_BENCHMARK("allocators/frame_arena")
+{
+    Gears::FrameArena arena;
+    arena.Reserve(ALLOCATIONS * 4096);
+
+    run.Measure(ALLOCATIONS, [&arena]() {
+        for (uint32_t size : s_Sizes)
+            arena.Allocate(size, 16);
+    }, [&arena]() {
+        arena.Reset();
+    });
+}
+
+GEARS_BENCHMARK("allocators/ring")
+{
+    Gears::RingAllocator ring;
+    ring.Init(ALLOCATIONS * 4096);
+
+    run.Measure(ALLOCATIONS, [&ring]() {
+        uint64_t offset;
+
+        for (uint32_t size : s_Sizes)
+            ring.Allocate(size, 16, offset);
+    }, [&ring]() {
+        ring.Release(ring.GetMarker());
+    });
+}
+
+// Allocates all, then frees every other one and the rest, so frees merge with and without neighbours
+GEARS_BENCHMARK("allocators/tlsf")
+{
+    Gears::Tlsf tlsf;
+    tlsf.Init(ALLOCATIONS * 4096);
+    std::vector<Gears::TlsfAllocation> allocations(ALLOCATIONS);
+
+    run.Measure(ALLOCATIONS, [&tlsf, &allocations]() {
+        for (uint32_t i = 0; i < ALLOCATIONS; ++i)
+            tlsf.Allocate(s_Sizes[i], 16, allocations[i]);
+
+        for (uint32_t i = 0; i < ALLOCATIONS; i += 2)
+            tlsf.Free(allocations[i]);
+
+        for (uint32_t i = 1; i < ALLOCATIONS; i += 2)
+            tlsf.Free(allocations[i]);
+    });
+}
+
+GEARS_BENCHMARK("allocators/malloc")
+{
+    std::vector<void*> allocations(ALLOCATIONS);
+
+    run.Measure(ALLOCATIONS, [&allocations]() {
+        for (uint32_t i = 0; i < ALLOCATIONS; ++i)
+            allocations[i] = malloc(s_Sizes[i]);
+
+        for (uint32_t i = 0; i < ALLOCATIONS; i += 2)
+            free(allocations[i]);
+
+        for (uint32_t i = 1; i < ALLOCATIONS; i += 2)
+            free(allocations[i]);
+    });
+}
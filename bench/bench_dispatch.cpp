@@ -0,0 +1,125 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "vk_loader.h"
+
+// Per-call cost of device functions fetched through the loader's
+// trampolines against pointers straight from vkGetDeviceProcAddr.
+// Usage: GEARS_BENCH_DISPATCH [calls]
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t BATCH = 10000; // Commands per recording, keeps the driver's command list small
+
+    // Both pointers end up in the same driver function, only the hop in between differs
+    double RecordNs(VkCommandBuffer cmd, PFN_vkCmdSetViewport setViewport, uint32_t calls)
+    {
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        VkViewport viewport{ 0.0f, 0.0f, 64.0f, 64.0f, 0.0f, 1.0f };
+        double ns = 0.0;
+
+        for (uint32_t done = 0; done < calls; done += BATCH)
+        {
+            vkResetCommandBuffer(cmd, 0);
+            vkBeginCommandBuffer(cmd, &beginInfo);
+
+            auto start = Clock::now();
+
+            for (uint32_t i = 0; i < BATCH; ++i)
+                setViewport(cmd, 0, 1, &viewport);
+
+            ns += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            vkEndCommandBuffer(cmd);
+        }
+
+        return ns / calls;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t calls = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1000000;
+    calls = (calls + BATCH - 1) / BATCH * BATCH;
+
+    if (!Gears::LoadVulkan())
+        return 1;
+
+    VkInstanceCreateInfo instanceInfo{};
+    instanceInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+
+    VkInstance instance;
+
+    if (vkCreateInstance(&instanceInfo, nullptr, &instance) != VK_SUCCESS)
+        return 1;
+
+    Gears::LoadInstanceFunctions(instance);
+
+    uint32_t count = 1;
+    VkPhysicalDevice physicalDevice;
+
+    if (vkEnumeratePhysicalDevices(instance, &count, &physicalDevice) < 0 || count == 0)
+        return 1;
+
+    float priority = 1.0f;
+
+    VkDeviceQueueCreateInfo queueInfo{};
+    queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    queueInfo.queueFamilyIndex = 0;
+    queueInfo.queueCount = 1;
+    queueInfo.pQueuePriorities = &priority;
+
+    VkDeviceCreateInfo deviceInfo{};
+    deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceInfo.queueCreateInfoCount = 1;
+    deviceInfo.pQueueCreateInfos = &queueInfo;
+
+    VkDevice device;
+
+    if (vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device) != VK_SUCCESS)
+        return 1;
+
+    // Fetched before the device table is loaded, so this is the loader's trampoline
+    PFN_vkCmdSetViewport trampoline = vkCmdSetViewport;
+
+    Gears::LoadDeviceFunctions(device);
+
+    PFN_vkCmdSetViewport direct = vkCmdSetViewport;
+
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+    VkCommandPool pool;
+    vkCreateCommandPool(device, &poolInfo, nullptr, &pool);
+
+    VkCommandBufferAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocateInfo.commandPool = pool;
+    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocateInfo.commandBufferCount = 1;
+
+    VkCommandBuffer cmd;
+    vkAllocateCommandBuffers(device, &allocateInfo, &cmd);
+
+    // Warms caches and lets the driver grow its command storage once
+    RecordNs(cmd, direct, BATCH);
+
+    double trampolineNs = RecordNs(cmd, trampoline, calls);
+    double directNs = RecordNs(cmd, direct, calls);
+
+    printf("loader trampoline %8.2f ns/call\n", trampolineNs);
+    printf("direct dispatch   %8.2f ns/call\n", directNs);
+
+    vkDestroyCommandPool(device, pool, nullptr);
+    vkDestroyDevice(device, nullptr);
+    vkDestroyInstance(instance, nullptr);
+
+    return 0;
+}
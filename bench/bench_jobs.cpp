@@ -0,0 +1,67 @@
+#include <cmath>
+#include <vector>
+
+#include "bench.h"
+#include "job_system.h"
+
+// Scheduling overhead and parallel-for throughput of Gears::JobSystem, on
+// the calling thread alone and with a worker per remaining core. The
+// parallel-for body is a small float kernel, times are per element.
+
+namespace
+{
+    constexpr uint32_t BATCH = Gears::JOB_POOL_SIZE / 2;
+    constexpr uint32_t EMPTY_JOBS = BATCH * 16;
+
+    void BenchEmptyJobs(Gears::BenchRun& run, uint32_t workers)
+    {
+        Gears::JobSystem jobs{ workers };
+
+        run.Measure(EMPTY_JOBS, [&jobs]() {
+            // Spawned in batches so the per-thread pool never wraps onto live jobs
+            for (uint32_t done = 0; done < EMPTY_JOBS; done += BATCH)
+            {
+                Gears::Job* root = jobs.CreateEmpty();
+
+                for (uint32_t i = 0; i < BATCH - 1; ++i)
+                    jobs.Run(jobs.CreateEmpty(root));
+
+                jobs.Run(root);
+                jobs.Wait(root);
+            }
+        });
+    }
+
+    void BenchParallelFor(Gears::BenchRun& run, uint32_t workers)
+    {
+        Gears::JobSystem jobs{ workers };
+        std::vector<float> data(1 << 22, 1.0f);
+
+        run.Measure(data.size(), [&jobs, &data]() {
+            jobs.ParallelFor(static_cast<uint32_t>(data.size()), [&data](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i)
+                    data[i] = std::sqrt(data[i] * 1.0001f + 1.0f);
+            }, 1024);
+        });
+    }
+}
+
+GEARS_BENCHMARK("jobs/empty_jobs/caller_only")
+{
+    BenchEmptyJobs(run, 0);
+}
+
+GEARS_BENCHMARK("jobs/empty_jobs/all_cores")
+{
+    BenchEmptyJobs(run, Gears::JOB_AUTO_WORKERS);
+}
+
+GEARS_BENCHMARK("jobs/parallel_for/caller_only")
+{
+    BenchParallelFor(run, 0);
+}
+
+GEARS_BENCHMARK("jobs/parallel_for/all_cores")
+{
+    BenchParallelFor(run, Gears::JOB_AUTO_WORKERS);
+}
@@ -0,0 +1,88 @@
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "Logger.h"
+#include "bench.h"
+
+// Caller-side cost of the asynchronous logger against a synchronous fprintf.
+// Both write to a tmpfile() rewound between samples, so neither spams stderr
+// and the baseline pays for formatting and stdio, not for a terminal.
+
+namespace
+{
+    // Stays below the ring size so the caller never waits on the writer
+    constexpr uint32_t BATCH = Gears::LOG_RING_SIZE / 2;
+
+    const char* s_Extension = "VK_KHR_get_physical_device_properties2";
+
+    class FileSink : public Gears::LogSink
+    {
+        public:
+
+        explicit FileSink(FILE* file) : m_File(file) {}
+
+        void Write(Gears::LogLevel, const char* message, size_t length) override
+        {
+            fwrite(message, 1, length, m_File);
+            fputc('\n', m_File);
+        }
+
+        void Flush() override { fflush(m_File); }
+
+        private:
+
+        FILE* m_File;
+    };
+}
+
+GEARS_BENCHMARK("logger/async")
+{
+    FILE* file = tmpfile();
+    if (!file)
+    {
+        run.Skip("tmpfile() failed");
+        return;
+    }
+
+    std::vector<std::unique_ptr<Gears::LogSink>> sinks;
+    sinks.push_back(std::make_unique<FileSink>(file));
+    sinks = Gears::SwapLogSinks(std::move(sinks));
+
+    // Starts the writer thread outside the timed region
+    Gears::Log(Gears::LogLevel::Info, "warmup");
+    Gears::FlushLog();
+
+    run.Measure(BATCH, []() {
+        for (uint32_t i = 0; i < BATCH; ++i)
+            Gears::Log(Gears::LogLevel::Info, "Extension Name: %s (%u)", s_Extension, i);
+    }, [file]() {
+        Gears::FlushLog();
+        rewind(file);
+    });
+
+    // Restores the default sinks before the file goes away
+    Gears::FlushLog();
+    sinks = Gears::SwapLogSinks(std::move(sinks));
+    fclose(file);
+}
+
+GEARS_BENCHMARK("logger/fprintf")
+{
+    FILE* file = tmpfile();
+    if (!file)
+    {
+        run.Skip("tmpfile() failed");
+        return;
+    }
+
+    run.Measure(BATCH, [file]() {
+        for (uint32_t i = 0; i < BATCH; ++i)
+            fprintf(file, "Extension Name: %s (%u)\n", s_Extension, i);
+    }, [file]() {
+        fflush(file);
+        rewind(file);
+    });
+
+    fclose(file);
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Logger.h"
+#include "graphics.h"
+#include "headless_platform.h"
+
+// Graphics construction time with and without the capability snapshot, and
+// the resume path that only rebuilds the window part, e.g. on lavapipe.
+// Usage: GEARS_BENCH_STARTUP [runs] [storageDir] 2>/dev/null
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double ConstructMs(Gears::Platform& platform, bool expectWarm)
+    {
+        auto start = Clock::now();
+        Gears::Graphics graphics{ platform };
+        graphics.AttachWindow();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        if (graphics.UsedCapabilitySnapshot() != expectWarm)
+            fprintf(stderr, "Expected a %s start\n", expectWarm ? "warm" : "cold");
+
+        return ms;
+    }
+
+    // What a pause and resume costs once the core survives the window
+    double ResumeMs(Gears::Graphics& graphics)
+    {
+        graphics.DetachWindow();
+
+        auto start = Clock::now();
+        graphics.AttachWindow();
+        graphics.RenderFrame();
+
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    double Median(std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t runs = argc > 1 ? static_cast<uint32_t>(std::max(1, std::atoi(argv[1]))) : 10;
+    std::string storage = argc > 2 ? argv[2] : ".";
+    std::string snapshot = storage + "/capabilities.bin";
+
+    Gears::HeadlessPlatform platform{ 64, 64, storage };
+
+    // Loads the ICD and fills the pipeline cache so neither lands in the first sample
+    std::remove(snapshot.c_str());
+    ConstructMs(platform, false);
+
+    std::vector<double> cold;
+    std::vector<double> warm;
+
+    for (uint32_t i = 0; i < runs; ++i)
+    {
+        std::remove(snapshot.c_str());
+        cold.push_back(ConstructMs(platform, false));
+        warm.push_back(ConstructMs(platform, true));
+    }
+
+    std::vector<double> resume;
+
+    {
+        Gears::Graphics graphics{ platform };
+        graphics.AttachWindow();
+        graphics.RenderFrame();
+
+        for (uint32_t i = 0; i < runs; ++i)
+            resume.push_back(ResumeMs(graphics));
+    }
+
+    Gears::FlushLog();
+
+    printf("cold start   %8.3f ms median of %u\n", Median(cold), runs);
+    printf("warm start   %8.3f ms median of %u\n", Median(warm), runs);
+    printf("resume       %8.3f ms median of %u\n", Median(resume), runs);
+
+    return 0;
+}
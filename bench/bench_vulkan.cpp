@@ -0,0 +1,147 @@
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "bench.h"
+#include "graphics.h"
+#include "headless_platform.h"
+#include "job_system.h"
+
+// The engine's own CPU cost of startup, of recording and submitting a
+// frame and of device memory sub-allocation, against the mock ICD in
+// mock_icd/ so no driver or GPU time lands in the numbers and they repeat
+// across runs and machines. Setting VK_DRIVER_FILES or VK_ICD_FILENAMES
+// measures a real driver instead.
+
+namespace
+{
+    constexpr uint32_t FRAMES = 64;   // Per sample, times are per frame
+    constexpr uint32_t PASSES = 32;
+    constexpr uint32_t DRAWS = 64;    // Per pass
+    constexpr uint32_t ALLOCATIONS = 1024;
+
+    void UseMockDriver()
+    {
+#if defined(GEARS_MOCK_ICD_MANIFEST)
+        if (getenv("VK_DRIVER_FILES") == nullptr && getenv("VK_ICD_FILENAMES") == nullptr)
+        {
+            setenv("VK_DRIVER_FILES", GEARS_MOCK_ICD_MANIFEST, 1);
+            setenv("VK_ICD_FILENAMES", GEARS_MOCK_ICD_MANIFEST, 1); // Loaders older than 1.3.207
+        }
+#endif
+        // Overlays and capture layers would be measured along with the engine
+        setenv("VK_LOADER_LAYERS_DISABLE", "~implicit~", 0);
+    }
+
+    // What a shipping build runs, nothing here depends on the build type
+    Gears::GraphicsConfig BenchConfig(Gears::JobSystem* jobs)
+    {
+        Gears::GraphicsConfig config;
+        config.Build = Gears::BuildConfig::Release;
+        config.CacheCapabilities = false;
+        config.GpuZones = 0;
+        config.TrackHostMemory = false;
+        config.Jobs = jobs;
+        return config;
+    }
+
+    // Skips the benchmark when there is no driver to run on
+    std::unique_ptr<Gears::Graphics> CreateGraphics(Gears::BenchRun& run, Gears::Platform& platform, Gears::JobSystem* jobs)
+    {
+        UseMockDriver();
+
+        auto graphics = std::make_unique<Gears::Graphics>(platform, BenchConfig(jobs));
+
+        if (!graphics->IsValid() || !graphics->AttachWindow())
+        {
+            run.Skip("No Vulkan device, is GEARS_MOCK_ICD built?");
+            return nullptr;
+        }
+
+        return graphics;
+    }
+
+    void BenchFrames(Gears::BenchRun& run, Gears::JobSystem* jobs, uint32_t passes)
+    {
+        Gears::HeadlessPlatform platform{ 1280, 720 };
+        std::unique_ptr<Gears::Graphics> graphics = CreateGraphics(run, platform, jobs);
+
+        if (!graphics)
+            return;
+
+        for (uint32_t i = 0; i < passes; ++i)
+        {
+            graphics->AddRecordPass([](const Gears::RecordContext& context) {
+                for (uint32_t draw = 0; draw < DRAWS; ++draw)
+                    vkCmdDraw(context.CommandBuffer, 3, 1, 0, 0);
+            }, "BenchPass");
+        }
+
+        run.Measure(FRAMES, [&graphics]() {
+            for (uint32_t i = 0; i < FRAMES; ++i)
+                graphics->RenderFrame();
+        });
+    }
+}
+
+GEARS_BENCHMARK("vulkan/startup")
+{
+    Gears::HeadlessPlatform platform{ 1280, 720 };
+
+    if (!CreateGraphics(run, platform, nullptr))
+        return;
+
+    std::unique_ptr<Gears::Graphics> graphics;
+
+    // Destruction is left out, it runs between samples
+    run.Measure(1, [&platform, &graphics]() {
+        graphics = std::make_unique<Gears::Graphics>(platform, BenchConfig(nullptr));
+        graphics->AttachWindow();
+    }, [&graphics]() {
+        graphics.reset();
+    });
+}
+
+GEARS_BENCHMARK("vulkan/frame/empty")
+{
+    BenchFrames(run, nullptr, 0);
+}
+
+GEARS_BENCHMARK("vulkan/frame/passes")
+{
+    BenchFrames(run, nullptr, PASSES);
+}
+
+GEARS_BENCHMARK("vulkan/frame/passes_job_system")
+{
+    Gears::JobSystem jobs;
+    BenchFrames(run, &jobs, PASSES);
+}
+
+// Sub-allocation and free in the device memory allocator, blocks already exist after warmup
+GEARS_BENCHMARK("vulkan/memory_allocator")
+{
+    Gears::HeadlessPlatform platform{ 1280, 720 };
+    std::unique_ptr<Gears::Graphics> graphics = CreateGraphics(run, platform, nullptr);
+
+    if (!graphics)
+        return;
+
+    Gears::MemoryAllocator& allocator = graphics->GetMemoryAllocator();
+    std::vector<Gears::Allocation> allocations(ALLOCATIONS);
+
+    run.Measure(ALLOCATIONS, [&allocator, &allocations]() {
+        for (uint32_t i = 0; i < ALLOCATIONS; ++i)
+        {
+            VkMemoryRequirements requirements{};
+            requirements.size = 256 * (1 + i % 64);
+            requirements.alignment = 256;
+            requirements.memoryTypeBits = ~0u;
+
+            allocator.Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, Gears::ResourceKind::Linear, allocations[i]);
+        }
+
+        for (const Gears::Allocation& allocation : allocations)
+            allocator.Free(allocation);
+    });
+}
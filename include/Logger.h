@@ -1,21 +1,189 @@
 #pragma once
 
-#include <android/log.h>
-#include <vulkan/vulkan.h>
-
-#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, "native-activity", __VA_ARGS__))
-
-// TODO: Move to graphics?
-inline VKAPI_ATTR VkBool32 VKAPI_CALL DebugReportCallback(
-    VkDebugReportFlagsEXT       flags,
-    VkDebugReportObjectTypeEXT  objectType,
-    uint64_t                    object,
-    size_t                      location,
-    int32_t                     messageCode,
-    const char* pLayerPrefix,
-    const char* pMessage,
-    void* pUserData)
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#define GEARS_LOG_LEVEL_DEBUG   0
+#define GEARS_LOG_LEVEL_INFO    1
+#define GEARS_LOG_LEVEL_WARNING 2
+#define GEARS_LOG_LEVEL_ERROR   3
+#define GEARS_LOG_LEVEL_NONE    4
+
+// Calls below this level compile to nothing, arguments included
+#ifndef GEARS_LOG_LEVEL
+#ifdef NDEBUG
+#define GEARS_LOG_LEVEL GEARS_LOG_LEVEL_INFO
+#else
+#define GEARS_LOG_LEVEL GEARS_LOG_LEVEL_DEBUG
+#endif
+#endif
+
+// printf never runs, it only lets the compiler check the format against the arguments
+#define GEARS_LOG(level, ...) ((void)sizeof(printf(__VA_ARGS__)), ::Gears::Log(level, __VA_ARGS__))
+
+#if GEARS_LOG_LEVEL <= GEARS_LOG_LEVEL_DEBUG
+#define LOGD(...) GEARS_LOG(::Gears::LogLevel::Debug, __VA_ARGS__)
+#else
+#define LOGD(...) ((void)0)
+#endif
+
+#if GEARS_LOG_LEVEL <= GEARS_LOG_LEVEL_INFO
+#define LOGI(...) GEARS_LOG(::Gears::LogLevel::Info, __VA_ARGS__)
+#else
+#define LOGI(...) ((void)0)
+#endif
+
+#if GEARS_LOG_LEVEL <= GEARS_LOG_LEVEL_WARNING
+#define LOGW(...) GEARS_LOG(::Gears::LogLevel::Warning, __VA_ARGS__)
+#else
+#define LOGW(...) ((void)0)
+#endif
+
+#if GEARS_LOG_LEVEL <= GEARS_LOG_LEVEL_ERROR
+#define LOGE(...) GEARS_LOG(::Gears::LogLevel::Error, __VA_ARGS__)
+#else
+#define LOGE(...) ((void)0)
+#endif
+
+namespace Gears
 {
-    LOGI("GearsError::VULKAN: %s", pMessage);
-    return VK_FALSE;
-}
\ No newline at end of file
+    constexpr uint32_t LOG_RECORD_SIZE  = 256;
+    constexpr uint32_t LOG_RING_SIZE    = 512; // Records per thread
+    constexpr uint32_t LOG_MESSAGE_SIZE = 1024;
+
+    enum class LogLevel : uint8_t
+    {
+        Debug,
+        Info,
+        Warning,
+        Error
+    };
+
+    enum class LogArgType : uint8_t
+    {
+        Signed,
+        Unsigned,
+        Double,
+        Pointer,
+        String
+    };
+
+    // The format string is kept by pointer and must be a literal; arguments
+    // are stored by value behind a type tag, strings copied inline and
+    // truncated to whatever room the record has left.
+    struct LogRecord
+    {
+        uint64_t Sequence; // Global order across threads, cheaper than reading a clock
+        const char* Format;
+        uint32_t ThreadId;
+        LogLevel Level;
+        uint8_t  ArgCount;
+        uint16_t PayloadSize;
+        uint8_t  Payload[LOG_RECORD_SIZE - 24];
+    };
+
+    static_assert(sizeof(LogRecord) == LOG_RECORD_SIZE, "Log records must stay fixed-size");
+
+    class LogSink
+    {
+        public:
+
+        virtual ~LogSink() = default;
+
+        virtual void         Write(LogLevel level, const char* message, size_t length) = 0;
+        virtual void         Flush() {}
+    };
+
+    // Starts at first use with logcat on Android, stderr elsewhere, plus
+    // the file named by GEARS_LOG_FILE when set
+    void                     AddLogSink(std::unique_ptr<LogSink> sink);
+
+    // Replaces every sink and hands back the old ones, e.g. to keep a
+    // test's output off stderr. Records not yet drained go to the new ones.
+    std::vector<std::unique_ptr<LogSink>> SwapLogSinks(std::vector<std::unique_ptr<LogSink>> sinks);
+
+    // Blocks until everything logged before the call has reached every sink
+    void                     FlushLog();
+
+    size_t                   FormatLogRecord(const LogRecord& record, char* buffer, size_t size);
+
+    // Producer side of the calling thread's ring. Begin blocks only while
+    // the ring is full, which means the writer thread is far behind.
+    LogRecord&               LogBegin(LogLevel level, const char* format);
+    void                     LogCommit(LogRecord& record);
+
+    class LogEncoder
+    {
+        public:
+
+        explicit LogEncoder(LogRecord& record) : m_Record(record) {}
+
+        template<typename T>
+        void Add(T value)
+        {
+            if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>)
+            {
+                AddString(value ? value : "(null)");
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                AddScalar(LogArgType::Double, static_cast<double>(value), sizeof(double));
+            }
+            else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+            {
+                AddScalar(LogArgType::Pointer, reinterpret_cast<uintptr_t>(value), sizeof(void*));
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                Add(static_cast<std::underlying_type_t<T>>(value));
+            }
+            else
+            {
+                static_assert(std::is_integral_v<T>, "Only scalars and C strings can be logged");
+
+                if constexpr (std::is_signed_v<T>)
+                    AddScalar(LogArgType::Signed, static_cast<int64_t>(value), sizeof(T));
+                else
+                    AddScalar(LogArgType::Unsigned, static_cast<uint64_t>(value), sizeof(T));
+            }
+        }
+
+        private:
+
+        LogRecord& m_Record;
+
+        template<typename V>
+        void AddScalar(LogArgType type, V value, size_t size)
+        {
+            if (m_Record.PayloadSize + 2u + sizeof(V) > sizeof(m_Record.Payload))
+                return;
+
+            uint8_t* out = m_Record.Payload + m_Record.PayloadSize;
+            out[0] = static_cast<uint8_t>(type);
+            out[1] = static_cast<uint8_t>(size);
+            memcpy(out + 2, &value, sizeof(V));
+
+            m_Record.PayloadSize += static_cast<uint16_t>(2 + sizeof(V));
+            ++m_Record.ArgCount;
+        }
+
+        // Out of line: inlined into callers with small literals, GCC misreads the room bound as an overread
+        void AddString(const char* value);
+    };
+
+    // Arguments are taken by value so char arrays decay to strings
+    template<typename... Args>
+    void Log(LogLevel level, const char* format, Args... args)
+    {
+        LogRecord& record = LogBegin(level, format);
+        LogEncoder encoder{ record };
+        (encoder.Add(args), ...);
+        LogCommit(record);
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <android_native_app_glue.h>
+#include "platform.h"
+
+namespace Gears
+{
+    class AndroidPlatform : public Platform
+    {
+        public:
+
+        AndroidPlatform(android_app* app);
+
+        const char*              GetName() const override { return "Android"; }
+        std::vector<const char*> GetInstanceExtensions() const override;
+        VkResult                 CreateSurface(VkInstance instance, const VkAllocationCallbacks* allocator, VkSurfaceKHR* surface) const override;
+        VkExtent2D               GetWindowExtent() const override;
+        std::string              GetStoragePath() const override;
+
+        private:
+
+        android_app*             m_AndroidApp;
+    };
+}
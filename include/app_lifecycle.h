@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace Gears
+{
+    // Wait while background work is pending but nothing can be rendered,
+    // short enough to pick up its result within a frame or two
+    constexpr int PENDING_POLL_MS = 16;
+
+    // Abstracts the OS event queue so the loop can be driven by a fake in tests
+    class Looper
+    {
+        public:
+
+        virtual ~Looper() = default;
+
+        // Waits up to timeoutMs, -1 for no limit, and dispatches at most one
+        // event. Returns false when the wait ended without one.
+        virtual bool             PollOnce(int timeoutMs) = 0;
+    };
+
+    // What one step of the loop did, which decides how long the next poll waits
+    enum class StepResult : uint32_t
+    {
+        Idle,     // Nothing rendered and nothing pending, sleep until an event
+        Pending,  // Background work to poll for, e.g. graphics init
+        Rendered  // A frame went out, poll without waiting
+    };
+
+    enum class LifecycleEvent : uint32_t
+    {
+        Start,
+        Resume,
+        Pause,
+        Stop,
+        WindowCreated,
+        WindowDestroyed,
+        Destroy
+    };
+
+    // Tracks what the OS allows right now. Rendering needs both a resumed
+    // activity and a window, which Android delivers in either order.
+    class AppLifecycle
+    {
+        public:
+
+        void                     OnEvent(LifecycleEvent event);
+
+        bool                     IsStarted() const { return m_Started; }
+        bool                     IsResumed() const { return m_Resumed; }
+        bool                     HasWindow() const { return m_Window; }
+        bool                     IsDestroyRequested() const { return m_Destroyed; }
+        bool                     ShouldRender() const { return m_Resumed && m_Window && !m_Destroyed; }
+
+        // Never blocks after a rendered frame, blocks indefinitely when the
+        // last step did nothing and no background work is pending
+        int                      GetPollTimeout(StepResult last) const;
+
+        private:
+
+        bool                     m_Started = false;
+        bool                     m_Resumed = false;
+        bool                     m_Window = false;
+        bool                     m_Destroyed = false;
+    };
+
+    // Runs until Destroy. Drains every queued event, then calls step once,
+    // which renders when ShouldRender and reports what it did. Being
+    // allowed to render is not enough to spin, a frame has to come out.
+    void                         RunEventLoop(Looper& looper, AppLifecycle& lifecycle, const std::function<StepResult()>& step);
+}
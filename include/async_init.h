@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace Gears
+{
+    enum class InitState : uint32_t
+    {
+        Idle,
+        Running,
+        Ready,  // The result waits to be taken
+        Failed
+    };
+
+    // Builds an object on its own thread so the caller's loop keeps
+    // servicing lifecycle events. The result is handed over by Take on the
+    // caller's thread, never touched by both at once.
+    template<typename T>
+    class AsyncInit
+    {
+        public:
+
+        AsyncInit() = default;
+        ~AsyncInit() { Wait(); }
+
+        AsyncInit(const AsyncInit&) = delete;
+        AsyncInit& operator=(const AsyncInit&) = delete;
+
+        // create returns std::unique_ptr<T>, nullptr on failure. Ignored
+        // unless Idle, i.e. until the previous result has been taken.
+        template<typename F>
+        void                     Start(F&& create);
+
+        InitState                GetState() const { return m_State.load(std::memory_order_acquire); }
+        bool                     IsRunning() const { return GetState() == InitState::Running; }
+
+        // Hands over the result once the worker is done and resets to Idle,
+        // so a failed init can be started again. Never blocks on the work
+        // itself, returns nullptr while running or after a failure.
+        std::unique_ptr<T>       Take();
+
+        // Blocks until the worker has finished
+        void                     Wait();
+
+        private:
+
+        std::thread              m_Thread;
+        std::unique_ptr<T>       m_Result;
+        std::atomic<InitState>   m_State{ InitState::Idle };
+    };
+
+    template<typename T>
+    template<typename F>
+    void AsyncInit<T>::Start(F&& create)
+    {
+        if (GetState() != InitState::Idle)
+            return;
+
+        m_State.store(InitState::Running, std::memory_order_relaxed);
+
+        m_Thread = std::thread([this, create = std::forward<F>(create)]() mutable {
+            m_Result = create();
+
+            // Release publishes the result along with everything it built
+            m_State.store(m_Result ? InitState::Ready : InitState::Failed, std::memory_order_release);
+        });
+    }
+
+    template<typename T>
+    std::unique_ptr<T> AsyncInit<T>::Take()
+    {
+        InitState state = GetState();
+
+        if (state != InitState::Ready && state != InitState::Failed)
+            return nullptr;
+
+        // The worker is done once either is visible, joining only reclaims the thread
+        Wait();
+        m_State.store(InitState::Idle, std::memory_order_relaxed);
+
+        return std::move(m_Result);
+    }
+
+    template<typename T>
+    void AsyncInit<T>::Wait()
+    {
+        if (m_Thread.joinable())
+            m_Thread.join();
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Gears
+{
+    // FNV-1a over a cache file's payload, only needs to catch truncated or torn writes
+    uint64_t                 HashCacheData(const void* data, size_t size);
+
+    // The whole file, empty when it is missing or unreadable
+    std::vector<uint8_t>     ReadCacheFile(const std::string& path);
+
+    // Written aside and renamed, so a kill mid-write never leaves a torn file behind
+    bool                     WriteCacheFile(const std::string& path, const std::vector<uint8_t>& data);
+}
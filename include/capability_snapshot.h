@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "vk_loader.h"
+
+namespace Gears
+{
+    constexpr uint32_t CAPABILITY_SNAPSHOT_MAGIC   = 0x50414347; // "GCAP"
+    constexpr uint32_t CAPABILITY_SNAPSHOT_VERSION = 2;
+
+    // What device scoring and queue setup learned about one physical device
+    struct CachedDevice
+    {
+        uint32_t                             VendorID      = 0;
+        uint32_t                             DeviceID      = 0;
+        uint32_t                             DriverVersion = 0;
+        uint8_t                              PipelineCacheUUID[VK_UUID_SIZE] = {};
+        int64_t                              Score         = 0;
+        bool                                 Suitable      = false;
+        std::string                          Reason;
+        std::vector<std::string>             Extensions;
+        std::vector<VkQueueFamilyProperties> Queues;
+    };
+
+    // Results of the startup probing, reusable while the loader, the build
+    // configuration, every driver and the scoring rules are unchanged.
+    // Devices are kept in vkEnumeratePhysicalDevices order.
+    struct CapabilitySnapshot
+    {
+        uint32_t                             InstanceVersion = 0;
+        uint32_t                             Build           = 0;
+        std::vector<std::string>             Layers;
+        std::vector<std::string>             InstanceExtensions;
+        std::vector<CachedDevice>            Devices;
+    };
+
+    std::vector<uint8_t>     SerializeCapabilities(const CapabilitySnapshot& snapshot);
+
+    // Rejects foreign, older-version, truncated or torn data, and scores from other scoring rules
+    bool                     DeserializeCapabilities(const uint8_t* data, size_t size, CapabilitySnapshot& snapshot);
+
+    // True when the same devices, with the same drivers, enumerate in the same order
+    bool                     MatchesDevices(const CapabilitySnapshot& snapshot, const std::vector<VkPhysicalDeviceProperties>& devices);
+
+    bool                     LoadCapabilities(const std::string& path, CapabilitySnapshot& snapshot);
+    bool                     SaveCapabilities(const std::string& path, const CapabilitySnapshot& snapshot);
+}
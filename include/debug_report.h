@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "vk_loader.h"
+
+namespace Gears
+{
+    constexpr uint32_t DEBUG_REPORT_TABLE_SIZE  = 1024; // Distinct (messageCode, objectType) pairs
+    constexpr uint32_t DEBUG_REPORT_MESSAGE_SIZE = 256;
+
+    struct DebugReportEntry
+    {
+        std::atomic<uint64_t> Key{ UINT64_MAX };
+        std::atomic<uint32_t> Count{ 0 };
+        std::atomic<bool>     Ready{ false }; // First occurrence fully written
+        VkDebugReportFlagsEXT Flags = 0;
+        uint32_t              SummarizedCount = 0; // Only touched by LogSummary
+        char                  FirstMessage[DEBUG_REPORT_MESSAGE_SIZE];
+    };
+
+    // Validation layers call back on whichever thread made the Vulkan call,
+    // often once per draw. Each distinct message is logged once, then only
+    // counted in a lock-free table and reported in periodic summaries.
+    class DebugReportAggregator
+    {
+        public:
+
+        static VKAPI_ATTR VkBool32 VKAPI_CALL Callback(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objectType,
+            uint64_t object, size_t location, int32_t messageCode, const char* pLayerPrefix, const char* pMessage, void* pUserData);
+
+        void                     Report(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objectType, int32_t messageCode, const char* message);
+
+        // Closes the frame's performance warning count, call once per frame
+        void                     EndFrame();
+
+        // Logs a summary when the interval has passed since the last one
+        void                     Tick();
+        void                     LogSummary();
+
+        uint32_t                 GetLastFramePerformanceWarnings() const { return m_LastFramePerformanceWarnings; }
+        uint64_t                 GetTotalPerformanceWarnings() const { return m_TotalPerformanceWarnings.load(std::memory_order_relaxed); }
+        uint32_t                 GetCount(int32_t messageCode, VkDebugReportObjectTypeEXT objectType) const;
+        uint32_t                 GetDistinctCount() const { return m_Distinct.load(std::memory_order_relaxed); }
+
+        void                     SetSummaryInterval(std::chrono::milliseconds interval) { m_SummaryInterval = interval; }
+
+        private:
+
+        DebugReportEntry                      m_Entries[DEBUG_REPORT_TABLE_SIZE];
+        std::atomic<uint32_t>                 m_Distinct{ 0 };
+        std::atomic<uint32_t>                 m_Overflow{ 0 };
+        std::atomic<uint32_t>                 m_FramePerformanceWarnings{ 0 };
+        std::atomic<uint64_t>                 m_TotalPerformanceWarnings{ 0 };
+        uint32_t                              m_LastFramePerformanceWarnings = 0;
+        std::chrono::milliseconds             m_SummaryInterval{ 5000 };
+        std::chrono::steady_clock::time_point m_LastSummary = std::chrono::steady_clock::now();
+
+        static uint64_t          MakeKey(int32_t messageCode, VkDebugReportObjectTypeEXT objectType);
+        static uint32_t          HomeSlot(uint64_t key);
+    };
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "vk_loader.h"
+#include "memory_allocator.h"
+
+namespace Gears
+{
+    enum class RetiredKind : uint32_t
+    {
+        Buffer,
+        Image,
+        ImageView,
+        Sampler,
+        Pipeline,
+        PipelineLayout,
+        ShaderModule,
+        Memory      // An allocation without a resource of its own
+    };
+
+    struct RetiredResource
+    {
+        RetiredKind          Kind;
+        uint64_t             Value;   // Released once the GPU reaches it
+        Allocation           Memory;  // Freed along with the resource when set
+
+        union
+        {
+            VkBuffer         Buffer;
+            VkImage          Image;
+            VkImageView      ImageView;
+            VkSampler        Sampler;
+            VkPipeline       Pipeline;
+            VkPipelineLayout PipelineLayout;
+            VkShaderModule   ShaderModule;
+        };
+    };
+
+    // Destroys resources once the GPU is done with them instead of waiting
+    // for the device to go idle. Each is retired with the value the GPU has
+    // to reach first: a frame count, so GetFrameIndex() + 1 of the last
+    // frame using it, or the timeline semaphore value of its last submission.
+    // Named per type rather than overloaded, 32-bit builds define every
+    // non-dispatchable handle as the same uint64_t.
+    class DeletionQueue
+    {
+        public:
+
+        ~DeletionQueue();
+
+        // allocator frees the memory retired alongside resources, may be nullptr when none ever is.
+        // callbacks must be the ones every retired resource was created with.
+        void                     Init(VkDevice device, MemoryAllocator* allocator, const VkAllocationCallbacks* callbacks = nullptr);
+
+        // Retiring from any thread is fine. Values should not decrease, a
+        // smaller one is raised to the latest so release stays in order.
+        void                     RetireBuffer(VkBuffer buffer, const Allocation& memory, uint64_t value);
+        void                     RetireImage(VkImage image, const Allocation& memory, uint64_t value);
+        void                     RetireImageView(VkImageView view, uint64_t value);
+        void                     RetireSampler(VkSampler sampler, uint64_t value);
+        void                     RetirePipeline(VkPipeline pipeline, uint64_t value);
+        void                     RetirePipelineLayout(VkPipelineLayout layout, uint64_t value);
+        void                     RetireShaderModule(VkShaderModule module, uint64_t value);
+        void                     RetireMemory(const Allocation& memory, uint64_t value);
+
+        // Releases, in one batch, everything retired with a value up to
+        // completed. Returns how many resources were destroyed.
+        size_t                   Collect(uint64_t completed);
+
+        // Releases everything regardless of value, the device must be idle
+        void                     Flush() { Collect(UINT64_MAX); }
+
+        size_t                   GetPendingCount() const;
+
+        private:
+
+        VkDevice                    m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_AllocationCallbacks = nullptr;
+        MemoryAllocator*            m_Allocator = nullptr;
+        std::deque<RetiredResource> m_Pending; // Ascending by value
+        mutable std::mutex          m_Mutex;
+
+        void                     Push(RetiredResource resource);
+        void                     Release(const RetiredResource& resource);
+    };
+}
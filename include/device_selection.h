@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "vk_loader.h"
+
+namespace Gears
+{
+    // Everything the scoring pass looks at, gathered up front so scoring
+    // itself never calls into the driver
+    struct DeviceCandidate
+    {
+        VkPhysicalDevice                     Device = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties           Properties{};
+        VkPhysicalDeviceMemoryProperties     Memory{};
+        std::vector<VkQueueFamilyProperties> Queues;
+        std::vector<std::string>             Extensions;
+    };
+
+    struct DeviceScore
+    {
+        uint32_t    Index    = 0;
+        int64_t     Score    = 0;
+        bool        Suitable = false;
+        const char* Reason   = "";   // Why an unsuitable device was rejected
+    };
+
+    // Bump with any change to what ScoreDevice returns, capability
+    // snapshots holding scores from other rules are then discarded
+    constexpr uint32_t       DEVICE_SCORING_VERSION = 1;
+
+    DeviceScore              ScoreDevice(const DeviceCandidate& candidate, const std::vector<const char*>& requiredExtensions);
+
+    // Honors overrideIndex when it names a suitable device, otherwise picks
+    // the best score. Returns UINT32_MAX when nothing is suitable.
+    uint32_t                 SelectDevice(const std::vector<DeviceScore>& scores, int32_t overrideIndex = -1);
+}
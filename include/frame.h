@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include "vk_loader.h"
+#include "frame_arena.h"
+
+namespace Gears
+{
+    // Command pools are externally synchronized, so every recording thread
+    // gets its own per frame slot. Buffers are kept and reused after the
+    // pool is reset rather than freed one by one.
+    struct ThreadCommands
+    {
+        VkCommandPool                CommandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> SecondaryBuffers;
+        uint32_t                     UsedBuffers = 0;
+    };
+
+    // Everything a single frame in flight owns, so recording frame N+1
+    // never touches objects the GPU may still be reading for frame N.
+    struct FrameData
+    {
+        VkCommandPool   CommandPool    = VK_NULL_HANDLE;
+        VkCommandBuffer CommandBuffer  = VK_NULL_HANDLE;
+        VkFence         InFlightFence  = VK_NULL_HANDLE;
+        VkSemaphore     ImageAvailable = VK_NULL_HANDLE;
+        VkSemaphore     RenderFinished = VK_NULL_HANDLE;
+        FrameArena      Arena;
+
+        std::vector<ThreadCommands> Threads; // Indexed by JobSystem::GetThreadIndex()
+    };
+}
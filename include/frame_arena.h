@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Gears
+{
+    // Linear allocator for data that only lives until the frame slot is
+    // reused, reset in one step once the slot's fence has signaled.
+    class FrameArena
+    {
+        public:
+
+        void                 Reserve(size_t size);
+        void*                Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+        void                 Reset() { m_Offset = 0; }
+
+        size_t               GetUsedBytes() const { return m_Offset; }
+        size_t               GetCapacity() const { return m_Storage.size(); }
+
+        template<typename T>
+        T*                   AllocateArray(size_t count) { return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T))); }
+
+        private:
+
+        std::vector<uint8_t> m_Storage;
+        size_t               m_Offset = 0;
+    };
+}
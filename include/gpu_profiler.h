@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "vk_loader.h"
+
+#define GEARS_GPU_ZONE_CONCAT_IMPL(a, b) a##b
+#define GEARS_GPU_ZONE_CONCAT(a, b) GEARS_GPU_ZONE_CONCAT_IMPL(a, b)
+
+// Times the commands recorded into commandBuffer until the end of the scope
+#define GEARS_GPU_ZONE(profiler, commandBuffer, name) ::Gears::GpuZone GEARS_GPU_ZONE_CONCAT(gearsGpuZone, __LINE__){ profiler, commandBuffer, name }
+
+namespace Gears
+{
+    constexpr uint32_t GPU_ZONE_NONE = UINT32_MAX;
+
+    struct GpuZoneTiming
+    {
+        const char* Name;
+        uint64_t    StartNs;    // Relative to the start of the frame on the GPU
+        uint64_t    DurationNs;
+    };
+
+    // Ticks between two timestamps in ns, wrapping within the queue's valid bits
+    uint64_t TimestampDeltaNs(uint64_t begin, uint64_t end, uint32_t validBits, float timestampPeriod);
+
+    // Timestamp queries around the zones of each frame, one pool per frame
+    // slot. A slot's results are read when it is reused, after its fence has
+    // signaled, so reading never stalls. Zones may be opened from any
+    // recording thread, but only in command buffers executed by the frame's
+    // primary buffer on the graphics queue.
+    class GpuProfiler
+    {
+        public:
+
+        ~GpuProfiler();
+
+        // Stays disabled, every zone a no-op, when the queue has no timestamp support
+        bool                         Init(VkDevice device, uint32_t frameSlots, uint32_t maxZones, float timestampPeriod, uint32_t validBits,
+                                          const VkAllocationCallbacks* callbacks = nullptr);
+        void                         Destroy();
+
+        bool                         IsEnabled() const { return !m_Slots.empty(); }
+
+        // Resolves what the slot recorded frameSlots frames ago, then opens
+        // the frame's own zone. The slot's fence must have been waited on.
+        void                         BeginFrame(VkCommandBuffer commandBuffer, uint64_t frameIndex);
+        void                         EndFrame(VkCommandBuffer commandBuffer);
+
+        // Call right after the frame's submission, anchors its GPU zones on the CPU timeline
+        void                         MarkSubmitted();
+
+        // Returns GPU_ZONE_NONE when disabled, outside a frame or out of queries
+        uint32_t                     BeginZone(VkCommandBuffer commandBuffer, const char* name);
+        void                         EndZone(VkCommandBuffer commandBuffer, uint32_t zone);
+
+        // The latest resolved frame, its own "GpuFrame" zone first
+        const std::vector<GpuZoneTiming>& GetLastTimings() const { return m_Timings; }
+        uint64_t                     GetLastFrameIndex() const { return m_LastFrameIndex; }
+
+        private:
+
+        struct Slot
+        {
+            VkQueryPool              Pool = VK_NULL_HANDLE;
+            std::vector<const char*> Names;          // Per zone, written by the thread that opened it
+            std::atomic<uint32_t>    Used{ 0 };      // Zones handed out this frame
+            uint64_t                 FrameIndex = 0;
+            uint64_t                 SubmitNs = 0;   // Profiler clock at submission
+            bool                     Submitted = false;
+        };
+
+        VkDevice                     m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_AllocationCallbacks = nullptr;
+        std::vector<Slot>            m_Slots;
+        std::vector<uint64_t>        m_Results;
+        std::vector<GpuZoneTiming>   m_Timings;
+        uint32_t                     m_MaxZones = 0;
+        uint32_t                     m_ValidBits = 0;
+        float                        m_TimestampPeriod = 1.0f;
+        uint32_t                     m_Current = 0;
+        uint32_t                     m_FrameZone = GPU_ZONE_NONE;
+        bool                         m_InFrame = false;
+        uint64_t                     m_LastFrameIndex = 0;
+
+        void                         Resolve(Slot& slot);
+    };
+
+    class GpuZone
+    {
+        public:
+
+        GpuZone(GpuProfiler& profiler, VkCommandBuffer commandBuffer, const char* name) :
+            m_Profiler( profiler ),
+            m_CommandBuffer( commandBuffer ),
+            m_Zone( profiler.BeginZone(commandBuffer, name) )
+        {
+        }
+
+        ~GpuZone() { m_Profiler.EndZone(m_CommandBuffer, m_Zone); }
+
+        GpuZone(const GpuZone&) = delete;
+        GpuZone& operator=(const GpuZone&) = delete;
+
+        private:
+
+        GpuProfiler&                 m_Profiler;
+        VkCommandBuffer              m_CommandBuffer;
+        uint32_t                     m_Zone;
+    };
+}
@@ -1,49 +1,232 @@
 #pragma once
 
+#include <functional>
+#include <mutex>
+#include <string>
 #include <vector>
-#include <android_native_app_glue.h>
-#include <vulkan/vulkan.h>
 #include "Logger.h"
+#include "capability_snapshot.h"
+#include "debug_report.h"
+#include "deletion_queue.h"
+#include "device_selection.h"
+#include "frame.h"
+#include "gpu_profiler.h"
+#include "host_allocator.h"
+#include "memory_allocator.h"
+#include "pipeline_cache.h"
+#include "platform.h"
+#include "staging_manager.h"
+#include "startup_timeline.h"
+#include "swapchain_selection.h"
+#include "vk_loader.h"
+#include "window_surface.h"
 
 namespace Gears
 {
+    class JobSystem;
+
+    // Release loads no layers or debug extensions, Profile adds only
+    // VK_EXT_debug_utils for capture tools, Debug adds validation
+    enum class BuildConfig : uint32_t
+    {
+        Release,
+        Profile,
+        Debug
+    };
+
+#if defined(GEARS_PROFILE)
+    constexpr BuildConfig DEFAULT_BUILD_CONFIG = BuildConfig::Profile;
+#elif defined(NDEBUG)
+    constexpr BuildConfig DEFAULT_BUILD_CONFIG = BuildConfig::Release;
+#else
+    constexpr BuildConfig DEFAULT_BUILD_CONFIG = BuildConfig::Debug;
+#endif
+
+    struct GraphicsConfig
+    {
+        uint32_t         FramesInFlight    = 2;       // At least 1, 0 is raised to 1
+        size_t           FrameArenaSize    = 64 * 1024;
+        VkDeviceSize     StagingSize       = STAGING_RING_SIZE;
+        int32_t          DeviceIndex       = -1;      // Overrides device scoring, as does GEARS_DEVICE_INDEX
+        BuildConfig      Build             = DEFAULT_BUILD_CONFIG;
+        bool             CacheCapabilities = true;    // Skips startup probing while loader and drivers are unchanged
+        PresentPolicy    Present           = PresentPolicy::Vsync;
+        JobSystem*       Jobs              = nullptr; // Records passes in parallel when set
+        StartupProgress* Progress          = nullptr; // Follows construction from another thread
+        uint32_t         GpuZones          = DEFAULT_BUILD_CONFIG == BuildConfig::Release ? 0 : 64; // Timed per frame, 0 disables GPU timestamps
+        bool             TrackHostMemory   = DEFAULT_BUILD_CONFIG != BuildConfig::Release; // Driver host allocations through our callbacks
+        size_t           HostPoolSize      = 0;       // Serves tracked driver allocations from a pool, 0 keeps them on the heap
+    };
+
+    // Handed to every record pass. The target image is in
+    // TRANSFER_DST_OPTIMAL layout for the duration of the passes.
+    struct RecordContext
+    {
+        VkCommandBuffer CommandBuffer;
+        VkImage         TargetImage;
+        uint64_t        FrameIndex;
+        GpuProfiler*    Profiler;      // For GEARS_GPU_ZONE around the pass's own dispatches and draws
+    };
+
+    using RecordPass = std::function<void(const RecordContext&)>;
+
+    struct QueueSelection
+    {
+        uint32_t Family = UINT32_MAX;
+        uint32_t Index  = 0; // Queue within the family, roles may share one when the family runs out
+    };
+
     class Graphics
     {
         public:
 
-        Graphics(android_app* app);
+        // Builds everything that outlives a window: instance, device, caches
+        // and per-frame objects. Nothing renders until AttachWindow. Safe to
+        // run off the window thread, see AsyncInit.
+        Graphics(Platform& platform, const GraphicsConfig& config = {});
+        ~Graphics();
+
+        // False when construction failed, e.g. no driver or no suitable device
+        bool                                 IsValid() const { return m_Valid; }
+
+        // Creates surface and swapchain for the platform's current window,
+        // call again after DetachWindow once a new window exists
+        bool                                 AttachWindow();
+
+        // Call before the native window is destroyed, e.g. on pause
+        void                                 DetachWindow();
+
+        bool                                 HasWindow() const { return m_Window.IsValid() || m_Window.IsDirty(); }
+
+        // Duration of the last AttachWindow, the resume latency once startup is done
+        double                               GetAttachMs() const { return m_AttachMs; }
+
+        // False when no frame came out and none will before the window
+        // changes: no window, a minimized one, or a failed frame that could
+        // not hand its slot back, after which nothing renders again
+        bool                                 RenderFrame();
+
+        // Each pass records into its own secondary buffer, possibly on a
+        // worker thread, and executes in the order it was added. The name
+        // labels its GPU zone and debug label and must outlive the Graphics.
+        void                                 AddRecordPass(RecordPass pass, const char* name = "Pass");
+
+        // Call when the app may be killed soon, e.g. on pause
+        void                                 SavePipelineCache() { m_PipelineCache.SaveAsync(); }
+
+        VkPipelineCache                      GetPipelineCache() const { return m_PipelineCache.Get(); }
+
+        MemoryAllocator&                     GetMemoryAllocator() { return m_MemoryAllocator; }
+
+        // Values are frame counts: retire with GetFrameIndex() + 1 of the last
+        // frame using the resource, it is destroyed once that frame completes
+        DeletionQueue&                       GetDeletionQueue() { return m_DeletionQueue; }
+
+        // Uploads queued here are flushed ahead of the next frame's submission
+        StagingManager&                      GetStaging() { return m_Staging; }
+
+        // Objects created outside Graphics but handed to it, e.g. retired to
+        // the deletion queue, must be created with these. nullptr when untracked.
+        const VkAllocationCallbacks*         GetAllocationCallbacks() const { return m_AllocationCallbacks; }
+
+        // Driver host memory by allocation scope, empty unless TrackHostMemory is set
+        const HostAllocator&                 GetHostAllocator() const { return m_HostAllocator; }
+
+        // Per-pass GPU times, resolved FramesInFlight frames after recording
+        const GpuProfiler&                   GetGpuProfiler() const { return m_GpuProfiler; }
+
+        uint64_t                             GetFrameIndex() const { return m_FrameIndex; }
+
+        // The swapchain is rebuilt before the next frame, out-of-date and suboptimal presents do this on their own
+        void                                 OnWindowResized() { m_Window.MarkDirty(); }
+
+        VkExtent2D                           GetSwapchainExtent() const { return m_Window.GetExtent(); }
+        VkFormat                             GetSwapchainFormat() const { return m_Window.GetFormat(); }
+
+        // Validation message counts, including per-frame performance warnings
+        const DebugReportAggregator&         GetDebugReport() const { return m_DebugReport; }
+
+        // One entry per enumerated device, in vkEnumeratePhysicalDevices order
+        const std::vector<DeviceScore>&      GetDeviceScores() const { return m_DeviceScores; }
+
+        // One event per constructor step, nested under a "Graphics" total
+        const StartupTimeline&               GetStartupTimeline() const { return m_StartupTimeline; }
+
+        // True when startup reused the saved probing instead of querying the driver
+        bool                                 UsedCapabilitySnapshot() const { return m_CapabilitiesCached; }
+
+        // Falls back to the graphics queue when the device has no async compute family
+        VkQueue                              GetComputeQueue() const { return m_ComputeQueue; }
+        uint32_t                             GetComputeQueueFamily() const { return m_ComputeSelection.Family; }
 
         private:
 
-        [[maybe_unused]] android_app         m_androidApp;
+        Platform*                            m_Platform;
+        GraphicsConfig                       m_Config;
+        StartupTimeline                      m_StartupTimeline;
+        HostAllocator                        m_HostAllocator; // Outlives every member holding Vulkan objects
+        const VkAllocationCallbacks*         m_AllocationCallbacks = nullptr;
 
-        std::vector<const char*>             m_LayerPropertyNames;
-        std::vector<const char*>             m_LayerExtensionNames;
-        std::vector<const char*>             m_DeviceExtensionNames;
+        std::vector<std::string>             m_LayerPropertyNames;
+        std::vector<std::string>             m_LayerExtensionNames;
+        std::vector<std::string>             m_DeviceExtensionNames;
         std::vector<VkPhysicalDevice>        m_PhysicalDevices;
+        std::vector<DeviceScore>             m_DeviceScores;
         std::vector<VkQueueFamilyProperties> m_PhysicalQueueProperties;
+        std::vector<std::vector<float>>      m_QueuePriorities; // Per family, must outlive vkCreateDevice
+        std::vector<FrameData>               m_Frames;
+        std::vector<RecordPass>              m_RecordPasses;
+        std::vector<const char*>             m_RecordPassNames;
+        CapabilitySnapshot                   m_Capabilities;
 
-        VkInstance                           m_VkInstance;
+        VkInstance                           m_VkInstance = VK_NULL_HANDLE;
+        VkDebugReportCallbackEXT             m_DebugCallback = VK_NULL_HANDLE;
+        DebugReportAggregator                m_DebugReport;
+        VkPhysicalDevice                     m_PhysicalDevice = VK_NULL_HANDLE;
         VkPhysicalDeviceProperties           m_MainDeviceProperties;
-        VkDevice                             m_Device;
-        VkCommandPool                        m_CommandPool;
-        VkSurfaceKHR                         m_Surface;
-        VkSurfaceCapabilitiesKHR             m_SurfaceCapabilities;
-        VkSwapchainKHR                       m_Swapchain;
+        VkDevice                             m_Device = VK_NULL_HANDLE;
+        VkQueue                              m_GraphicsQueue;
+        VkQueue                              m_ComputeQueue;
+        VkQueue                              m_TransferQueue;
+        std::mutex                           m_GraphicsQueueMutex;
+        PipelineCache                        m_PipelineCache;
+        MemoryAllocator                      m_MemoryAllocator;
+        StagingManager                       m_Staging;
+        DeletionQueue                        m_DeletionQueue;
+        GpuProfiler                          m_GpuProfiler;
+        WindowSurface                        m_Window;
 
-        uint32_t                             m_SelectedGraphicQueueIndex;
+        QueueSelection                       m_GraphicsSelection;
+        QueueSelection                       m_ComputeSelection;
+        QueueSelection                       m_TransferSelection;
+        uint64_t                             m_FrameIndex = 0;
+        bool                                 m_DebugReportEnabled = false;
+        bool                                 m_DebugUtilsEnabled = false; // Labels the frame and each record pass
+        bool                                 m_CapabilitiesCached = false;
+        bool                                 m_Lost = false;
+        bool                                 m_Valid = false; // Every CreateCore step succeeded
+        double                               m_AttachMs = 0.0;
     
-        void                    EnumerateLayerProperties();
-        void                    CreateSurface(ANativeWindow* nativeWindow);
-        void                    EnumerateLayerExtensions();
-        void                    EnumerateDeviceExtensions();
-        void                    EnumeratePhysicalDevices();
-        void                    CreateInstance();
-        void                    SetupDebugCallbacks();
-        void                    CreateLogicalDevice(VkDeviceQueueCreateInfo queueCreateInfo);
-        void                    CreateCommandBufferPool();
-        void                    CreateSwapChain();
-        void                    CachePhysicalDeviceCapabilities();
-        VkDeviceQueueCreateInfo SetupDeviceQueues();
+        bool                    CreateCore();
+        bool                    EnumerateLayerProperties();
+        bool                    EnumerateLayerExtensions();
+        bool                    EnumeratePhysicalDevices();
+        void                    ProbePhysicalDevices(const std::vector<VkPhysicalDeviceProperties>& properties);
+        bool                    LoadCapabilitySnapshot();
+        bool                    SaveCapabilitySnapshot();
+        bool                    CreateInstance();
+        bool                    SetupDebugCallbacks();
+        bool                    CreateLogicalDevice(const std::vector<VkDeviceQueueCreateInfo>& queueInfos);
+        bool                    CreatePipelineCache();
+        bool                    CreateMemoryAllocator();
+        bool                    CreateStaging();
+        bool                    CreateCommandBufferPool();
+        bool                    CreateSyncObjects();
+        bool                    CreateGpuProfiler();
+        bool                    RecordFrame(FrameData& frame, uint32_t imageIndex);
+        void                    SkipFrame(FrameData& frame);
+        void                    RecordPasses(FrameData& frame, VkImage image);
+        VkCommandBuffer         AcquireSecondaryBuffer(ThreadCommands& commands);
+        std::vector<VkDeviceQueueCreateInfo> SetupDeviceQueues();
     };
 }
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "platform.h"
+
+namespace Gears
+{
+    // Presents into a VK_EXT_headless_surface, which software ICDs such as
+    // lavapipe expose, so the full swapchain path runs without a display.
+    class HeadlessPlatform : public Platform
+    {
+        public:
+
+        HeadlessPlatform(uint32_t width, uint32_t height, std::string storagePath = ".");
+
+        const char*              GetName() const override { return "Headless"; }
+        std::vector<const char*> GetInstanceExtensions() const override;
+        VkResult                 CreateSurface(VkInstance instance, const VkAllocationCallbacks* allocator, VkSurfaceKHR* surface) const override;
+        VkExtent2D               GetWindowExtent() const override;
+        std::string              GetStoragePath() const override;
+
+        private:
+
+        VkExtent2D               m_Extent;
+        std::string              m_StoragePath;
+    };
+}
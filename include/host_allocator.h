@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "vk_loader.h"
+#include "tlsf.h"
+
+namespace Gears
+{
+    // Command, object, cache, device and instance, as the driver tags them
+    constexpr uint32_t HOST_SCOPE_COUNT = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+
+    struct HostAllocationStats
+    {
+        uint64_t LiveBytes       = 0;
+        uint64_t PeakBytes       = 0;
+        uint64_t Allocations     = 0; // Since startup, reallocations included, the churn
+        uint64_t LiveAllocations = 0;
+        uint64_t InternalBytes   = 0; // Allocated by the driver itself and only reported to us
+    };
+
+    // Accounts for the driver's host memory through VkAllocationCallbacks,
+    // per allocation scope. Objects must be destroyed with the callbacks they
+    // were created with, so the same ones go to every create and destroy.
+    // Can serve allocations from a TLSF pool of its own, falling back to the
+    // heap once it is full.
+    class HostAllocator
+    {
+        public:
+
+        HostAllocator();
+        ~HostAllocator();
+
+        HostAllocator(const HostAllocator&) = delete;
+        HostAllocator& operator=(const HostAllocator&) = delete;
+
+        // Before the callbacks are first used, poolSize 0 keeps everything on the heap
+        void                         Init(size_t poolSize = 0);
+
+        const VkAllocationCallbacks* GetCallbacks() const { return &m_Callbacks; }
+
+        HostAllocationStats          GetStats(VkSystemAllocationScope scope) const;
+
+        // Summed over every scope, the peak is of the sum rather than a sum of peaks
+        HostAllocationStats          GetTotal() const;
+
+        void                         LogSummary() const;
+
+        private:
+
+        struct Counters
+        {
+            std::atomic<uint64_t>    LiveBytes{ 0 };
+            std::atomic<uint64_t>    PeakBytes{ 0 };
+            std::atomic<uint64_t>    Allocations{ 0 };
+            std::atomic<uint64_t>    LiveAllocations{ 0 };
+            std::atomic<uint64_t>    InternalBytes{ 0 };
+        };
+
+        VkAllocationCallbacks        m_Callbacks{};
+        Counters                     m_Scopes[HOST_SCOPE_COUNT];
+        Counters                     m_Total;
+
+        std::unique_ptr<std::max_align_t[]> m_Pool;
+        Tlsf                         m_PoolRanges;
+        std::mutex                   m_PoolMutex;
+
+        void*                        Allocate(size_t size, size_t alignment, VkSystemAllocationScope scope);
+        void*                        Reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        void                         Free(void* memory);
+        void                         Track(Counters& counters, size_t size, bool allocated);
+
+        static VKAPI_ATTR void* VKAPI_CALL AllocationCallback(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        static VKAPI_ATTR void* VKAPI_CALL ReallocationCallback(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+        static VKAPI_ATTR void VKAPI_CALL FreeCallback(void* userData, void* memory);
+        static VKAPI_ATTR void VKAPI_CALL InternalAllocationCallback(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+        static VKAPI_ATTR void VKAPI_CALL InternalFreeCallback(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+    };
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Gears
+{
+    constexpr uint32_t JOB_DATA_SIZE          = 48;
+    constexpr uint32_t JOB_MAX_CONTINUATIONS  = 8;
+    constexpr uint32_t JOB_POOL_SIZE          = 4096; // Jobs alive per thread at any one time
+    constexpr uint32_t JOB_QUEUE_SIZE         = 4096;
+    constexpr uint32_t JOB_AUTO_WORKERS       = UINT32_MAX;
+
+    struct Job
+    {
+        using Function = void(*)(Job*);
+
+        Function              Execute;
+        Function              Destroy;
+        Job*                  Parent;
+        std::atomic<int32_t>  Unfinished;
+        std::atomic<int32_t>  PendingDependencies;
+        std::atomic<uint32_t> ContinuationCount;
+        Job*                  Continuations[JOB_MAX_CONTINUATIONS];
+
+        alignas(16) uint8_t   Data[JOB_DATA_SIZE];
+    };
+
+    // Chase-Lev deque: the owning thread pushes and pops at the bottom,
+    // every other thread steals from the top.
+    class JobQueue
+    {
+        public:
+
+        bool                      Push(Job* job);
+        Job*                      Pop();
+        Job*                      Steal();
+
+        private:
+
+        std::atomic<int64_t>      m_Top{ 0 };
+        std::atomic<int64_t>      m_Bottom{ 0 };
+        std::atomic<Job*>         m_Jobs[JOB_QUEUE_SIZE];
+    };
+
+    // Work-stealing scheduler. The constructing thread becomes thread 0 and
+    // helps execute jobs whenever it waits; every worker owns its own deque
+    // and job pool so the fast path never takes a lock.
+    class JobSystem
+    {
+        public:
+
+        JobSystem(uint32_t workerCount = JOB_AUTO_WORKERS); // Auto picks one worker per remaining core
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        template<typename F>
+        Job*                      Create(F&& function, Job* parent = nullptr);
+        Job*                      CreateEmpty(Job* parent = nullptr);
+
+        // Both jobs must be created but not yet run
+        void                      AddDependency(Job* job, Job* dependsOn);
+
+        // Waiting from a thread the system does not own only blocks, it never
+        // executes jobs itself, so per-thread resources stay GetThreadCount() wide
+        void                      Run(Job* job);
+        void                      Wait(const Job* job);
+
+        // Calls function(begin, end) over [0, count) split into chunks sized
+        // to keep every thread busy without drowning in scheduling overhead
+        template<typename F>
+        void                      ParallelFor(uint32_t count, F&& function, uint32_t minChunkSize = 1);
+
+        uint32_t                  GetThreadCount() const { return static_cast<uint32_t>(m_Queues.size()); }
+        static uint32_t           GetThreadIndex();
+
+        private:
+
+        struct JobPool
+        {
+            std::unique_ptr<Job[]> Jobs{ new Job[JOB_POOL_SIZE] };
+            uint32_t               Next = 0;
+        };
+
+        std::vector<std::unique_ptr<JobQueue>> m_Queues;
+        std::vector<std::unique_ptr<JobPool>>  m_Pools; // One per thread plus one shared by foreign threads
+        std::vector<std::thread>               m_Workers;
+        std::vector<Job*>                      m_ForeignJobs;
+
+        std::mutex                             m_ForeignMutex;
+        std::mutex                             m_SleepMutex;
+        std::condition_variable                m_SleepCondition;
+        std::atomic<int32_t>                   m_QueuedJobs{ 0 };
+        std::atomic<uint32_t>                  m_ForeignPending{ 0 };
+        std::atomic<uint32_t>                  m_SleepingWorkers{ 0 };
+        std::atomic<bool>                      m_Quit{ false };
+
+        Job*                      Allocate(Job* parent);
+        Job*                      GetJob(uint32_t threadIndex);
+        bool                      IsForeignThread() const;
+        void                      Execute(Job* job);
+        void                      Finish(Job* job);
+        void                      Release(Job* job);
+        void                      Submit(Job* job);
+        void                      WorkerLoop(uint32_t threadIndex);
+    };
+
+    template<typename F>
+    Job* JobSystem::Create(F&& function, Job* parent)
+    {
+        using Functor = std::decay_t<F>;
+        static_assert(sizeof(Functor) <= JOB_DATA_SIZE, "Job capture too large, capture by pointer instead");
+        static_assert(alignof(Functor) <= 16, "Job capture over-aligned");
+
+        Job* job = Allocate(parent);
+        new (job->Data) Functor(std::forward<F>(function));
+
+        job->Execute = [](Job* j) { (*std::launder(reinterpret_cast<Functor*>(j->Data)))(); };
+
+        if constexpr (!std::is_trivially_destructible_v<Functor>)
+            job->Destroy = [](Job* j) { std::launder(reinterpret_cast<Functor*>(j->Data))->~Functor(); };
+
+        return job;
+    }
+
+    template<typename F>
+    void JobSystem::ParallelFor(uint32_t count, F&& function, uint32_t minChunkSize)
+    {
+        if (count == 0)
+            return;
+
+        // A few chunks per thread leaves room for stealing to even out uneven work
+        uint32_t chunkSize = count / (GetThreadCount() * 4);
+        if (chunkSize < minChunkSize) chunkSize = minChunkSize;
+        if (chunkSize == 0) chunkSize = 1;
+
+        Job* root = CreateEmpty();
+        auto* fn = &function;
+
+        for (uint32_t begin = 0; begin < count; begin += chunkSize)
+        {
+            uint32_t end = begin + chunkSize < count ? begin + chunkSize : count;
+            Run(Create([fn, begin, end]() { (*fn)(begin, end); }, root));
+        }
+
+        Run(root);
+        Wait(root);
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "vk_loader.h"
+#include "tlsf.h"
+
+namespace Gears
+{
+    constexpr VkDeviceSize MEMORY_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+    // Linear resources (buffers, linear images) and optimal images may not
+    // share a bufferImageGranularity page, so the allocator needs to know which is which
+    enum class ResourceKind
+    {
+        Linear,
+        Optimal
+    };
+
+    struct Allocation
+    {
+        VkDeviceMemory Memory     = VK_NULL_HANDLE;
+        VkDeviceSize   Offset     = 0;
+        VkDeviceSize   Size       = 0;
+        void*          Mapped     = nullptr; // Set for host-visible memory
+        uint32_t       MemoryType = 0;
+        uint32_t       Block      = UINT32_MAX; // UINT32_MAX for dedicated allocations
+        TlsfAllocation Range;
+    };
+
+    struct MemoryStats
+    {
+        uint32_t  BlockCount            = 0;
+        uint32_t  DedicatedCount        = 0;
+        uint32_t  DeviceAllocationCount = 0; // Live vkAllocateMemory calls
+        TlsfStats Blocks;                    // Summed over every block
+    };
+
+    // Carves resources out of a few large vkAllocateMemory blocks per memory
+    // type instead of one allocation each, keeping well under
+    // maxMemoryAllocationCount and off the driver's slow path.
+    class MemoryAllocator
+    {
+        public:
+
+        ~MemoryAllocator();
+
+        void                       Init(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize = MEMORY_BLOCK_SIZE,
+                                        const VkAllocationCallbacks* callbacks = nullptr);
+        void                       Destroy();
+
+        bool                       Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, ResourceKind kind, Allocation& allocation);
+        void                       Free(const Allocation& allocation);
+
+        // Allocate and bind in one step
+        bool                       AllocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties, Allocation& allocation);
+        bool                       AllocateForImage(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags properties, Allocation& allocation);
+
+        uint32_t                   FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const;
+        MemoryStats                GetStats(uint32_t memoryType) const;
+        MemoryStats                GetStats() const;
+        void                       LogStats() const;
+
+        private:
+
+        struct Block
+        {
+            VkDeviceMemory Memory = VK_NULL_HANDLE;
+            void*          Mapped = nullptr;
+            Tlsf           Ranges;
+        };
+
+        struct MemoryPool
+        {
+            std::vector<std::unique_ptr<Block>> Blocks;
+            VkDeviceSize                        BlockSize = 0;
+            uint32_t                            DedicatedCount = 0;
+        };
+
+        VkDevice                         m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks*     m_AllocationCallbacks = nullptr;
+        VkPhysicalDeviceMemoryProperties m_MemoryProperties{};
+        VkDeviceSize                     m_BufferImageGranularity = 1;
+        uint32_t                         m_MaxAllocationCount = 0;
+        uint32_t                         m_DeviceAllocationCount = 0;
+        std::vector<MemoryPool>          m_Pools;
+        mutable std::mutex               m_Mutex;
+
+        bool                       AllocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory& memory, void*& mapped);
+        void                       FreeDeviceMemory(VkDeviceMemory memory, void* mapped);
+    };
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "vk_loader.h"
+
+namespace Gears
+{
+    constexpr uint32_t PIPELINE_CACHE_MAGIC   = 0x434C5047; // "GPLC"
+    constexpr uint32_t PIPELINE_CACHE_VERSION = 1;
+
+    // Written in front of the driver blob. Drivers already reject foreign
+    // blobs, but some only after partially parsing them, and driverVersion
+    // is not part of the Vulkan header at all.
+    struct PipelineCacheHeader
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t VendorID;
+        uint32_t DeviceID;
+        uint32_t DriverVersion;
+        uint8_t  PipelineCacheUUID[VK_UUID_SIZE];
+        uint32_t Reserved;
+        uint64_t DataSize;
+        uint64_t DataHash;
+    };
+
+    class PipelineCache
+    {
+        public:
+
+        ~PipelineCache();
+
+        // Seeds the cache from path when the saved blob matches this device,
+        // otherwise starts empty. Returns true if previous data was reused.
+        bool                     Create(VkDevice device, const VkPhysicalDeviceProperties& properties, std::string path,
+                                        const VkAllocationCallbacks* callbacks = nullptr);
+        void                     Destroy();
+
+        // Pulls the blob and writes it on a background thread, never blocks the caller on IO
+        void                     SaveAsync();
+        void                     WaitForSave();
+
+        VkPipelineCache          Get() const { return m_Cache; }
+
+        static PipelineCacheHeader MakeHeader(const VkPhysicalDeviceProperties& properties, const void* data, size_t size);
+        static bool              Validate(const PipelineCacheHeader& header, const VkPhysicalDeviceProperties& properties, const void* data, size_t size);
+
+        private:
+
+        VkDevice                 m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_AllocationCallbacks = nullptr;
+        VkPipelineCache          m_Cache = VK_NULL_HANDLE;
+        VkPhysicalDeviceProperties m_Properties{};
+        std::string              m_Path;
+
+        std::mutex               m_SaveMutex;
+        std::thread              m_SaveThread;
+    };
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "vk_loader.h"
+
+namespace Gears
+{
+    // Abstracts everything Graphics needs from the windowing system so the
+    // same init, render and present path runs on Android and headless Linux.
+    class Platform
+    {
+        public:
+
+        virtual ~Platform() = default;
+
+        virtual const char*              GetName() const = 0;
+        virtual std::vector<const char*> GetInstanceExtensions() const = 0;
+        virtual VkResult                 CreateSurface(VkInstance instance, const VkAllocationCallbacks* allocator, VkSurfaceKHR* surface) const = 0;
+
+        // Used when the surface reports an undefined currentExtent (0xFFFFFFFF)
+        virtual VkExtent2D               GetWindowExtent() const = 0;
+
+        // Writable, app-private directory for caches that survive restarts
+        virtual std::string              GetStoragePath() const = 0;
+    };
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Zones, counters and frame marks compile to nothing, arguments included,
+// unless the profiler is enabled. Profile builds enable it, anything else
+// may by defining GEARS_PROFILER_ENABLED to 1.
+#ifndef GEARS_PROFILER_ENABLED
+#ifdef GEARS_PROFILE
+#define GEARS_PROFILER_ENABLED 1
+#else
+#define GEARS_PROFILER_ENABLED 0
+#endif
+#endif
+
+#define GEARS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define GEARS_PROFILE_CONCAT(a, b) GEARS_PROFILE_CONCAT_IMPL(a, b)
+
+#if GEARS_PROFILER_ENABLED
+#define GEARS_PROFILE_ZONE(name) ::Gears::ProfileZone GEARS_PROFILE_CONCAT(gearsProfileZone, __LINE__){ name }
+#define GEARS_PROFILE_COUNTER(name, value) ::Gears::ProfileCounter(name, static_cast<int64_t>(value))
+#define GEARS_PROFILE_FRAME() ::Gears::ProfileFrame()
+#else
+#define GEARS_PROFILE_ZONE(name) ((void)0)
+#define GEARS_PROFILE_COUNTER(name, value) ((void)0)
+#define GEARS_PROFILE_FRAME() ((void)0)
+#endif
+
+namespace Gears
+{
+    constexpr uint32_t PROFILE_RING_SIZE = 8192; // Events per thread between two collects
+    constexpr uint32_t PROFILE_GPU_THREAD_ID = UINT32_MAX; // Track for zones timed on the GPU
+
+    enum class ProfileEventType : uint8_t
+    {
+        Zone,
+        Counter,
+        Frame
+    };
+
+    struct ProfileEvent
+    {
+        const char*      Name;     // Must outlive the profiler, normally a literal
+        uint64_t         StartNs;  // Relative to the profiler's first use
+        int64_t          Value;    // Duration in ns for zones, the sample for counters, the frame number for marks
+        uint32_t         ThreadId;
+        ProfileEventType Type;
+    };
+
+    // Records into the calling thread's own ring, wait-free. Events are
+    // dropped, never blocked on, when the ring is full.
+    class ProfileZone
+    {
+        public:
+
+        explicit ProfileZone(const char* name);
+        ~ProfileZone();
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+        private:
+
+        const char*              m_Name;
+        uint64_t                 m_Start;
+#ifdef __ANDROID__
+        bool                     m_Traced = false; // Also sent to ATrace
+#endif
+    };
+
+    uint64_t                     ProfileNow();
+    void                         ProfileRecord(ProfileEventType type, const char* name, uint64_t startNs, int64_t value);
+    void                         ProfileCounter(const char* name, int64_t value);
+
+    // A zone measured on the GPU, already converted to the profiler's clock
+    void                         ProfileGpuZone(const char* name, uint64_t startNs, int64_t durationNs);
+
+    // Marks the start of a frame on the calling thread's timeline
+    void                         ProfileFrame();
+
+    // Drains every thread's ring, oldest first per thread. One collector at a time.
+    std::vector<ProfileEvent>    CollectProfileEvents();
+
+    // Events lost to full rings since startup
+    uint64_t                     GetDroppedProfileEvents();
+
+    // Opens in chrome://tracing and ui.perfetto.dev
+    std::string                  ProfileToChromeTrace(const std::vector<ProfileEvent>& events);
+
+    // Collects and writes everything recorded so far
+    bool                         WriteProfileTrace(const std::string& path);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Gears
+{
+    // FIFO allocator over an abstract [0, capacity) range. Positions grow
+    // monotonically; Release(marker) frees everything allocated before the
+    // marker was taken, which matches retiring GPU submissions in order.
+    class RingAllocator
+    {
+        public:
+
+        void                 Init(uint64_t capacity);
+
+        // Never splits an allocation across the wrap point
+        bool                 Allocate(uint64_t size, uint64_t alignment, uint64_t& offset);
+        void                 Release(uint64_t marker);
+
+        uint64_t             GetMarker() const { return m_Head; }
+        uint64_t             GetUsedBytes() const { return m_Head - m_Tail; }
+        uint64_t             GetCapacity() const { return m_Capacity; }
+
+        private:
+
+        uint64_t             m_Capacity = 0;
+        uint64_t             m_Head = 0;
+        uint64_t             m_Tail = 0;
+    };
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "vk_loader.h"
+#include "memory_allocator.h"
+#include "ring_allocator.h"
+
+namespace Gears
+{
+    constexpr VkDeviceSize STAGING_RING_SIZE = 16ull * 1024 * 1024;
+
+    // Uploads go through one persistently mapped ring instead of a staging
+    // buffer each. Copies queue up until Flush, which records them into a
+    // single command buffer; ring space comes back once that submission's
+    // fence signals.
+    //
+    // On a dedicated transfer family, exclusive resources are released to the
+    // destination family and reacquired by RecordAcquireBarriers, so
+    // consumers must not touch them before GetCompletedSerial() reaches the
+    // serial of their upload.
+    class StagingManager
+    {
+        public:
+
+        ~StagingManager();
+
+        // queueMutex guards a queue shared with other submitters, nullptr when it is ours alone
+        bool                     Init(VkDevice device, MemoryAllocator& allocator, uint32_t queueFamily, VkQueue queue,
+                                      uint32_t dstQueueFamily, std::mutex* queueMutex, VkDeviceSize size = STAGING_RING_SIZE,
+                                      const VkAllocationCallbacks* callbacks = nullptr);
+        void                     Destroy();
+
+        // Data is copied out before returning. Blocks on the oldest pending
+        // upload only when the ring is full.
+        bool                     UploadToBuffer(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size);
+
+        // The image must be in TRANSFER_DST_OPTIMAL when the flush executes;
+        // region.bufferOffset is filled in by the manager
+        bool                     UploadToImage(VkImage image, VkBufferImageCopy region, const void* data, VkDeviceSize size);
+
+        // Records and submits everything queued so far, returns without waiting
+        void                     Flush();
+
+        // Call on the destination queue before anything reads this frame's
+        // completed uploads; also publishes the new completed serial
+        void                     RecordAcquireBarriers(VkCommandBuffer commandBuffer);
+
+        // Uploads queued now complete with this serial
+        uint64_t                 GetPendingSerial();
+        uint64_t                 GetCompletedSerial() const { return m_CompletedSerial.load(std::memory_order_acquire); }
+
+        // Returns ring space of every submission the GPU has finished with
+        void                     Reclaim();
+        void                     WaitIdle();
+
+        VkDeviceSize             GetUsedBytes() const;
+
+        private:
+
+        struct BufferCopy
+        {
+            VkBuffer     Buffer;
+            VkBufferCopy Region;
+        };
+
+        struct ImageCopy
+        {
+            VkImage           Image;
+            VkBufferImageCopy Region;
+        };
+
+        struct Submission
+        {
+            VkFence                            Fence = VK_NULL_HANDLE;
+            VkCommandBuffer                    CommandBuffer = VK_NULL_HANDLE;
+            uint64_t                           RingMarker = 0;
+            uint64_t                           Serial = 0;
+            std::vector<VkBufferMemoryBarrier> BufferAcquires;
+            std::vector<VkImageMemoryBarrier>  ImageAcquires;
+        };
+
+        VkDevice                 m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks* m_AllocationCallbacks = nullptr;
+        VkQueue                  m_Queue = VK_NULL_HANDLE;
+        std::mutex*              m_QueueMutex = nullptr;
+        uint32_t                 m_QueueFamily = 0;
+        uint32_t                 m_DstQueueFamily = 0;
+        VkCommandPool            m_CommandPool = VK_NULL_HANDLE;
+        VkBuffer                 m_Buffer = VK_NULL_HANDLE;
+        MemoryAllocator*         m_Allocator = nullptr;
+        Allocation               m_Memory;
+        RingAllocator            m_Ring;
+
+        std::vector<BufferCopy>  m_BufferCopies;
+        std::vector<ImageCopy>   m_ImageCopies;
+        std::deque<Submission>   m_InFlight;
+        std::vector<Submission>  m_FreeSubmissions; // Signaled fences and reset buffers ready for reuse
+        std::vector<VkBufferMemoryBarrier> m_BufferAcquires; // Retired, waiting for the next RecordAcquireBarriers
+        std::vector<VkImageMemoryBarrier>  m_ImageAcquires;
+        uint64_t                 m_NextSerial = 1;
+        uint64_t                 m_RetiredSerial = 0;
+        std::atomic<uint64_t>    m_CompletedSerial{ 0 };
+        mutable std::mutex       m_Mutex;
+
+        void*                    Stage(const void* data, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+        void                     FlushLocked();
+        void                     ReclaimLocked(bool wait);
+        bool                     AcquireSubmission(Submission& submission);
+        void                     RecordOwnershipRelease(Submission& submission);
+    };
+}
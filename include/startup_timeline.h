@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Gears
+{
+    struct TimelineEvent
+    {
+        const char* Name;       // Must outlive the timeline, normally a literal
+        uint64_t    StartNs;    // Relative to the timeline's creation
+        uint64_t    DurationNs;
+        uint32_t    ThreadId;
+        uint32_t    Depth;      // Nesting among scopes open on the same thread
+    };
+
+    // Lets another thread follow init while it runs, e.g. to draw a progress bar
+    struct StartupProgress
+    {
+        std::atomic<const char*> Step{ "" };  // Most recently opened scope
+        std::atomic<uint32_t>    Completed{ 0 };
+    };
+
+    // Records how long each init step takes. Steps may nest and may run on
+    // any thread; the timeline is read back at runtime or exported for
+    // chrome://tracing and Perfetto.
+    class StartupTimeline
+    {
+        public:
+
+        using Clock = std::chrono::steady_clock;
+
+        class Scope
+        {
+            public:
+
+            Scope(StartupTimeline& timeline, const char* name);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            private:
+
+            StartupTimeline&  m_Timeline;
+            const char*       m_Name;
+            Clock::time_point m_Start;
+            uint32_t          m_Depth;
+        };
+
+        StartupTimeline();
+
+        // Scopes report to progress while set, nullptr detaches. Set it
+        // before and clear it after the scopes it should follow.
+        void                       SetProgress(StartupProgress* progress) { m_Progress = progress; }
+
+        void                       Record(const char* name, Clock::time_point start, Clock::time_point end, uint32_t depth = 0);
+
+        // Snapshot in completion order, so nested steps come before their parent
+        std::vector<TimelineEvent> GetEvents() const;
+
+        // Summed over every event with this name, 0 when it never ran
+        double                     GetDurationMs(const char* name) const;
+
+        std::string                ToChromeTrace() const;
+        bool                       WriteChromeTrace(const std::string& path) const;
+        void                       LogSummary() const;
+
+        private:
+
+        Clock::time_point          m_Origin;
+        StartupProgress*           m_Progress = nullptr;
+        mutable std::mutex         m_Mutex;
+        std::vector<TimelineEvent> m_Events;
+    };
+}
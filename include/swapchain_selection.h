@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "vk_loader.h"
+
+namespace Gears
+{
+    // Trades latency against power. FIFO is the only mode every driver
+    // supports, so each policy falls back to it.
+    enum class PresentPolicy : uint32_t
+    {
+        LowLatency, // MAILBOX, newest frame wins, the GPU keeps rendering at full rate
+        Vsync,      // FIFO, renders no faster than the display, lowest power
+        Adaptive    // FIFO_RELAXED, tears instead of stuttering when a frame is late
+    };
+
+    // Prefers 8-bit sRGB-encoded formats, then their UNORM equivalents,
+    // then whatever the surface lists first
+    VkSurfaceFormatKHR       ChooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& formats);
+
+    VkPresentModeKHR         ChoosePresentMode(const std::vector<VkPresentModeKHR>& modes, PresentPolicy policy);
+
+    // One more than the minimum so acquire rarely waits on the compositor,
+    // and at least three for mailbox to have a spare image to replace
+    uint32_t                 ChooseImageCount(const VkSurfaceCapabilitiesKHR& capabilities, VkPresentModeKHR mode);
+
+    // Uses currentExtent unless the surface leaves it up to the swapchain
+    VkExtent2D               ChooseExtent(const VkSurfaceCapabilitiesKHR& capabilities, VkExtent2D windowExtent);
+
+    VkCompositeAlphaFlagBitsKHR ChooseCompositeAlpha(const VkSurfaceCapabilitiesKHR& capabilities);
+
+    // Color attachment plus transfer destination, frames are cleared with
+    // vkCmdClearColorImage. 0 when the surface does not offer both.
+    VkImageUsageFlags        ChooseImageUsage(const VkSurfaceCapabilitiesKHR& capabilities);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace Gears
+{
+    constexpr uint32_t TLSF_SL_LOG2    = 5;                       // 32 second-level bins per power of two
+    constexpr uint32_t TLSF_SL_COUNT   = 1u << TLSF_SL_LOG2;
+    constexpr uint32_t TLSF_FL_COUNT   = 64 - TLSF_SL_LOG2 + 1;
+    constexpr uint32_t TLSF_NULL_NODE  = UINT32_MAX;
+
+    struct TlsfAllocation
+    {
+        uint64_t Offset = 0;
+        uint64_t Size   = 0;
+        uint32_t Node   = TLSF_NULL_NODE;
+    };
+
+    struct TlsfStats
+    {
+        uint64_t TotalSize        = 0;
+        uint64_t UsedSize         = 0;
+        uint64_t FreeSize         = 0;
+        uint64_t LargestFreeBlock = 0;
+        uint32_t AllocationCount  = 0;
+        uint32_t FreeBlockCount   = 0;
+
+        // 0 when all free space is one block, approaching 1 as it scatters
+        float    Fragmentation() const { return FreeSize ? 1.0f - float(LargestFreeBlock) / float(FreeSize) : 0.0f; }
+    };
+
+    // Two-level segregated fit allocator over an abstract [0, size) range.
+    // It never touches the memory it manages, so it works for device memory
+    // offsets as well as host ranges. Allocate and Free are O(1).
+    class Tlsf
+    {
+        public:
+
+        void                 Init(uint64_t size);
+
+        bool                 Allocate(uint64_t size, uint64_t alignment, TlsfAllocation& allocation);
+        void                 Free(const TlsfAllocation& allocation);
+
+        bool                 IsEmpty() const { return m_AllocationCount == 0; }
+        uint64_t             GetSize() const { return m_Size; }
+        TlsfStats            GetStats() const;
+
+        private:
+
+        struct Node
+        {
+            uint64_t Offset;
+            uint64_t Size;
+            uint32_t PrevPhysical;
+            uint32_t NextPhysical;
+            uint32_t PrevFree;
+            uint32_t NextFree;
+            bool     Free;
+        };
+
+        std::vector<Node>     m_Nodes;
+        std::vector<uint32_t> m_UnusedNodes;
+        uint32_t              m_FreeHeads[TLSF_FL_COUNT][TLSF_SL_COUNT];
+        uint64_t              m_FlBitmap = 0;
+        uint32_t              m_SlBitmaps[TLSF_FL_COUNT];
+        uint64_t              m_Size = 0;
+        uint64_t              m_UsedSize = 0;
+        uint32_t              m_AllocationCount = 0;
+
+        uint32_t             NewNode();
+        void                 ReleaseNode(uint32_t node);
+        void                 InsertFree(uint32_t node);
+        void                 RemoveFree(uint32_t node);
+        uint32_t             FindFree(uint64_t size) const;
+        uint32_t             Split(uint32_t node, uint64_t size);
+    };
+}
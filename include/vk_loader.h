@@ -0,0 +1,120 @@
+#pragma once
+
+// Every Vulkan entry point is a function pointer fetched at runtime, the
+// way volk does it. Instance functions come from vkGetInstanceProcAddr and
+// device functions from vkGetDeviceProcAddr, so command buffer recording
+// and submission call straight into the driver instead of going through
+// the loader's trampolines. Include this instead of <vulkan/vulkan.h>, and
+// never link against the loader as well: these pointers share its names.
+#ifndef VK_NO_PROTOTYPES
+#define VK_NO_PROTOTYPES
+#endif
+
+#include <vulkan/vulkan.h>
+
+// Callable before any instance exists
+#define GEARS_VK_GLOBAL_FUNCTIONS(X) \
+    X(vkCreateInstance) \
+    X(vkEnumerateInstanceExtensionProperties) \
+    X(vkEnumerateInstanceLayerProperties) \
+    X(vkEnumerateInstanceVersion)
+
+#define GEARS_VK_INSTANCE_FUNCTIONS(X) \
+    X(vkCreateDevice) \
+    X(vkDestroyInstance) \
+    X(vkDestroySurfaceKHR) \
+    X(vkEnumerateDeviceExtensionProperties) \
+    X(vkEnumeratePhysicalDevices) \
+    X(vkGetDeviceProcAddr) \
+    X(vkGetPhysicalDeviceMemoryProperties) \
+    X(vkGetPhysicalDeviceProperties) \
+    X(vkGetPhysicalDeviceQueueFamilyProperties) \
+    X(vkGetPhysicalDeviceSurfaceCapabilitiesKHR) \
+    X(vkGetPhysicalDeviceSurfaceFormatsKHR) \
+    X(vkGetPhysicalDeviceSurfacePresentModesKHR) \
+    X(vkGetPhysicalDeviceSurfaceSupportKHR)
+
+#define GEARS_VK_DEVICE_FUNCTIONS(X) \
+    X(vkAcquireNextImageKHR) \
+    X(vkAllocateCommandBuffers) \
+    X(vkAllocateMemory) \
+    X(vkBeginCommandBuffer) \
+    X(vkBindBufferMemory) \
+    X(vkBindImageMemory) \
+    X(vkCmdBeginDebugUtilsLabelEXT) \
+    X(vkCmdClearColorImage) \
+    X(vkCmdCopyBuffer) \
+    X(vkCmdCopyBufferToImage) \
+    X(vkCmdDispatch) \
+    X(vkCmdDraw) \
+    X(vkCmdDrawIndexed) \
+    X(vkCmdEndDebugUtilsLabelEXT) \
+    X(vkCmdExecuteCommands) \
+    X(vkCmdPipelineBarrier) \
+    X(vkCmdResetQueryPool) \
+    X(vkCmdSetScissor) \
+    X(vkCmdSetViewport) \
+    X(vkCmdWriteTimestamp) \
+    X(vkCreateBuffer) \
+    X(vkCreateCommandPool) \
+    X(vkCreateFence) \
+    X(vkCreatePipelineCache) \
+    X(vkCreateQueryPool) \
+    X(vkCreateSemaphore) \
+    X(vkCreateSwapchainKHR) \
+    X(vkDestroyBuffer) \
+    X(vkDestroyCommandPool) \
+    X(vkDestroyDevice) \
+    X(vkDestroyFence) \
+    X(vkDestroyImage) \
+    X(vkDestroyImageView) \
+    X(vkDestroyPipeline) \
+    X(vkDestroyPipelineCache) \
+    X(vkDestroyPipelineLayout) \
+    X(vkDestroyQueryPool) \
+    X(vkDestroySampler) \
+    X(vkDestroySemaphore) \
+    X(vkDestroyShaderModule) \
+    X(vkDestroySwapchainKHR) \
+    X(vkDeviceWaitIdle) \
+    X(vkEndCommandBuffer) \
+    X(vkFlushMappedMemoryRanges) \
+    X(vkFreeCommandBuffers) \
+    X(vkFreeMemory) \
+    X(vkGetBufferMemoryRequirements) \
+    X(vkGetDeviceQueue) \
+    X(vkGetFenceStatus) \
+    X(vkGetImageMemoryRequirements) \
+    X(vkGetPipelineCacheData) \
+    X(vkGetQueryPoolResults) \
+    X(vkGetSwapchainImagesKHR) \
+    X(vkMapMemory) \
+    X(vkQueuePresentKHR) \
+    X(vkQueueSubmit) \
+    X(vkResetCommandBuffer) \
+    X(vkResetCommandPool) \
+    X(vkResetFences) \
+    X(vkUnmapMemory) \
+    X(vkWaitForFences)
+
+#define GEARS_VK_DECLARE(name) extern PFN_##name name;
+
+extern PFN_vkGetInstanceProcAddr vkGetInstanceProcAddr;
+
+GEARS_VK_GLOBAL_FUNCTIONS(GEARS_VK_DECLARE)
+GEARS_VK_INSTANCE_FUNCTIONS(GEARS_VK_DECLARE)
+GEARS_VK_DEVICE_FUNCTIONS(GEARS_VK_DECLARE)
+
+namespace Gears
+{
+    // Opens the system loader and fetches the global functions. Safe to
+    // call repeatedly, returns false when no loader is installed.
+    bool                     LoadVulkan();
+
+    // Also fetches device functions, through the loader's trampolines, until LoadDeviceFunctions runs
+    void                     LoadInstanceFunctions(VkInstance instance);
+
+    // Points device functions at the driver. Gears only ever creates one
+    // device, so the table stays global rather than per device.
+    void                     LoadDeviceFunctions(VkDevice device);
+}
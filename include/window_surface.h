@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "platform.h"
+#include "swapchain_selection.h"
+#include "vk_loader.h"
+
+namespace Gears
+{
+    // Replaced swapchains live until every frame that may use their images has completed
+    struct RetiredSwapchain
+    {
+        VkSwapchainKHR Swapchain;
+        uint64_t       FrameIndex; // First frame rendered to the replacement
+    };
+
+    // Everything tied to the native window: the surface, its swapchain and
+    // images. Android destroys the window on every pause, so this part is
+    // torn down and rebuilt while instance, device and caches stay alive.
+    class WindowSurface
+    {
+        public:
+
+        ~WindowSurface();
+
+        // Fails when the platform has no window, presentFamily cannot present
+        // to it, or its images cannot be color attachments and cleared
+        bool                     Create(VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device,
+                                        uint32_t presentFamily, const Platform& platform, PresentPolicy policy,
+                                        const VkAllocationCallbacks* callbacks = nullptr);
+
+        // The GPU must be done with every swapchain image, e.g. after vkDeviceWaitIdle
+        void                     Destroy();
+
+        // Builds the replacement with oldSwapchain set. Returns false while
+        // the window has no area, the current swapchain stays usable then.
+        bool                     Recreate(uint64_t frameIndex);
+
+        // Destroys swapchains retired no later than completedFrames, the
+        // number of frames the GPU is known to have finished
+        void                     DestroyRetired(uint64_t completedFrames);
+
+        void                     MarkDirty() { m_Dirty = true; }
+        bool                     IsDirty() const { return m_Dirty; }
+        bool                     IsValid() const { return m_Swapchain != VK_NULL_HANDLE; }
+
+        VkSwapchainKHR           GetSwapchain() const { return m_Swapchain; }
+        VkImage                  GetImage(uint32_t index) const { return m_Images[index]; }
+        VkExtent2D               GetExtent() const { return m_Extent; }
+        VkFormat                 GetFormat() const { return m_Format.format; }
+        VkPresentModeKHR         GetPresentMode() const { return m_PresentMode; }
+
+        private:
+
+        VkInstance                      m_Instance = VK_NULL_HANDLE;
+        VkPhysicalDevice                m_PhysicalDevice = VK_NULL_HANDLE;
+        VkDevice                        m_Device = VK_NULL_HANDLE;
+        const VkAllocationCallbacks*    m_AllocationCallbacks = nullptr;
+        const Platform*                 m_Platform = nullptr;
+        PresentPolicy                   m_Policy = PresentPolicy::Vsync;
+
+        VkSurfaceKHR                    m_Surface = VK_NULL_HANDLE;
+        VkSurfaceCapabilitiesKHR        m_Capabilities{};
+        std::vector<VkSurfaceFormatKHR> m_SurfaceFormats;
+        std::vector<VkPresentModeKHR>   m_PresentModes;
+
+        VkSwapchainKHR                  m_Swapchain = VK_NULL_HANDLE;
+        VkSurfaceFormatKHR              m_Format{};
+        VkPresentModeKHR                m_PresentMode = VK_PRESENT_MODE_FIFO_KHR;
+        VkExtent2D                      m_Extent{};
+        std::vector<VkImage>            m_Images;
+        std::vector<RetiredSwapchain>   m_Retired; // Oldest first
+        bool                            m_Dirty = false;
+
+        bool                     QueryCapabilities();
+        bool                     CreateSwapchain(uint64_t frameIndex);
+    };
+}
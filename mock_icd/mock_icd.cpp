@@ -0,0 +1,1021 @@
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include <vulkan/vk_icd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+// A null Vulkan driver for measuring the engine's own CPU cost. Every call
+// the engine makes succeeds at once and does no work: commands are dropped,
+// submissions signal their fence on the spot and timestamps count up in
+// fixed steps, so timings repeat from run to run and machine to machine.
+// Only mapped memory is real, the engine writes through it. Driver objects
+// come from the VkAllocationCallbacks when given, like a real driver's.
+// The system loader picks it up through gears_mock_icd.json, see the
+// vulkan/* cases of GEARS_BENCH in bench/bench_vulkan.cpp.
+
+namespace
+{
+	constexpr uint32_t     ICD_INTERFACE_VERSION = 5;
+	constexpr uint32_t     MIN_ICD_INTERFACE_VERSION = 3;        // Surfaces are ours from 3 on
+	constexpr uint32_t     API_VERSION = VK_API_VERSION_1_0;     // What the engine asks for, spares the 1.1 entry points
+	constexpr uint32_t     DRIVER_VERSION = VK_MAKE_VERSION(1, 0, 0);
+	constexpr uint32_t     VENDOR_ID = 0x10000;                  // Khronos', no PCI vendor
+	constexpr uint32_t     DEVICE_ID = 0x6EA5;
+	constexpr uint64_t     TIMESTAMP_STEP = 1000;                // Ticks per written timestamp, 1us at a period of 1
+	constexpr uint32_t     MAX_SWAPCHAIN_IMAGES = 8;
+	constexpr VkDeviceSize BUFFER_ALIGNMENT = 256;
+	constexpr VkDeviceSize IMAGE_ALIGNMENT = 4096;
+
+	const uint8_t PIPELINE_CACHE_UUID[VK_UUID_SIZE] = { 'G', 'e', 'a', 'r', 's', 'M', 'o', 'c', 'k', 'I', 'C', 'D', 0, 0, 0, 1 };
+
+	// Graphics, async compute and dedicated transfer, like a desktop GPU
+	const VkQueueFlags QUEUE_FAMILY_FLAGS[] = {
+		VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT,
+		VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT,
+		VK_QUEUE_TRANSFER_BIT
+	};
+
+	constexpr uint32_t QUEUE_FAMILY_COUNT = sizeof(QUEUE_FAMILY_FLAGS) / sizeof(QUEUE_FAMILY_FLAGS[0]);
+
+	const VkFormat SURFACE_FORMATS[] = { VK_FORMAT_B8G8R8A8_UNORM, VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R8G8B8A8_UNORM };
+	const VkPresentModeKHR PRESENT_MODES[] = { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR };
+
+	std::atomic<uint64_t> s_Ticks{ 0 };
+
+	// Dispatchable handles start with the word the loader keeps its dispatch table in
+	struct PhysicalDevice
+	{
+		VK_LOADER_DATA          LoaderData{ ICD_LOADER_MAGIC };
+	};
+
+	struct Instance
+	{
+		VK_LOADER_DATA          LoaderData{ ICD_LOADER_MAGIC };
+		PhysicalDevice          Physical;
+	};
+
+	struct Queue
+	{
+		VK_LOADER_DATA          LoaderData{ ICD_LOADER_MAGIC };
+	};
+
+	struct Device
+	{
+		VK_LOADER_DATA          LoaderData{ ICD_LOADER_MAGIC };
+		Queue                   Queues[QUEUE_FAMILY_COUNT]; // One per family
+	};
+
+	struct CommandBuffer
+	{
+		VK_LOADER_DATA          LoaderData{ ICD_LOADER_MAGIC };
+	};
+
+	struct CommandPool
+	{
+		VkAllocationCallbacks   Allocator{};          // Its command buffers come from the pool's callbacks
+		bool                    HasAllocator = false;
+		std::vector<CommandBuffer*> Buffers;
+	};
+
+	struct DeviceMemory
+	{
+		VkDeviceSize            Size = 0;
+		void*                   Data = nullptr;       // Host visible types only, on first map
+	};
+
+	struct Buffer
+	{
+		VkDeviceSize            Size = 0;
+	};
+
+	struct Image
+	{
+		VkDeviceSize            Size = 0;
+	};
+
+	struct Fence
+	{
+		std::atomic<bool>       Signaled{ false };
+	};
+
+	struct QueryPool
+	{
+		std::vector<uint64_t>   Results;
+	};
+
+	struct Swapchain
+	{
+		Image                   Images[MAX_SWAPCHAIN_IMAGES];
+		uint32_t                ImageCount = 0;
+		uint32_t                Next = 0;
+	};
+
+	struct Semaphore {};
+	struct Surface {};
+	struct PipelineCache {};
+
+	// Non-dispatchable handles are pointers on 64-bit and uint64_t on 32-bit
+	// targets, only the C cast through uintptr_t covers both
+	template<typename Handle, typename T>
+	Handle ToHandle(T* object) { return (Handle)(uintptr_t)object; }
+
+	template<typename T, typename Handle>
+	T* FromHandle(Handle handle) { return (T*)(uintptr_t)handle; }
+
+	template<typename T, typename... Args>
+	T* New(const VkAllocationCallbacks* allocator, VkSystemAllocationScope scope, Args&&... args)
+	{
+		void* memory = allocator != nullptr ?
+			allocator->pfnAllocation(allocator->pUserData, sizeof(T), alignof(T), scope) : malloc(sizeof(T));
+
+		return memory != nullptr ? new (memory) T{ std::forward<Args>(args)... } : nullptr;
+	}
+
+	template<typename T>
+	void Delete(const VkAllocationCallbacks* allocator, T* object)
+	{
+		if (object == nullptr)
+			return;
+
+		object->~T();
+
+		if (allocator != nullptr)
+			allocator->pfnFree(allocator->pUserData, object);
+		else
+			free(object);
+	}
+
+	template<typename T, typename Handle>
+	void DeleteHandle(const VkAllocationCallbacks* allocator, Handle handle)
+	{
+		Delete(allocator, FromHandle<T>(handle));
+	}
+
+	// The usual two-call idiom, VK_INCOMPLETE when the caller's array is too short
+	template<typename T>
+	VkResult Enumerate(const T* items, uint32_t itemCount, uint32_t* count, T* out)
+	{
+		if (out == nullptr)
+		{
+			*count = itemCount;
+			return VK_SUCCESS;
+		}
+
+		const uint32_t written = std::min(*count, itemCount);
+		std::copy(items, items + written, out);
+		*count = written;
+
+		return written < itemCount ? VK_INCOMPLETE : VK_SUCCESS;
+	}
+
+	VkExtensionProperties Extension(const char* name, uint32_t specVersion)
+	{
+		VkExtensionProperties properties{};
+		strncpy(properties.extensionName, name, VK_MAX_EXTENSION_NAME_SIZE - 1);
+		properties.specVersion = specVersion;
+		return properties;
+	}
+
+	const VkExtensionProperties INSTANCE_EXTENSIONS[] = {
+		Extension(VK_KHR_SURFACE_EXTENSION_NAME, 25),
+		Extension(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME, 1)
+	};
+
+	const VkExtensionProperties DEVICE_EXTENSIONS[] = {
+		Extension(VK_KHR_SWAPCHAIN_EXTENSION_NAME, 70)
+	};
+
+	template<size_t N>
+	bool Supported(const VkExtensionProperties (&extensions)[N], uint32_t count, const char* const* names)
+	{
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			bool found = false;
+
+			for (const VkExtensionProperties& extension : extensions)
+				found = found || strcmp(extension.extensionName, names[i]) == 0;
+
+			if (!found)
+				return false;
+		}
+
+		return true;
+	}
+
+	// Device local, then host visible in two flavours, all backed by a large heap each
+	VkPhysicalDeviceMemoryProperties MemoryProperties()
+	{
+		VkPhysicalDeviceMemoryProperties properties{};
+		properties.memoryHeapCount = 2;
+		properties.memoryHeaps[0] = { VkDeviceSize(8) << 30, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT };
+		properties.memoryHeaps[1] = { VkDeviceSize(16) << 30, 0 };
+		properties.memoryTypeCount = 3;
+		properties.memoryTypes[0] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0 };
+		properties.memoryTypes[1] = { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 1 };
+		properties.memoryTypes[2] = { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, 1 };
+		return properties;
+	}
+
+	const VkPhysicalDeviceMemoryProperties MEMORY_PROPERTIES = MemoryProperties();
+	constexpr uint32_t ALL_MEMORY_TYPES = (1u << 3) - 1;
+
+	VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	// Instance and physical device
+
+	VKAPI_ATTR VkResult VKAPI_CALL EnumerateInstanceVersion(uint32_t* pApiVersion)
+	{
+		*pApiVersion = API_VERSION;
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL EnumerateInstanceLayerProperties(uint32_t* pPropertyCount, VkLayerProperties*)
+	{
+		*pPropertyCount = 0;
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL EnumerateInstanceExtensionProperties(const char* pLayerName, uint32_t* pPropertyCount, VkExtensionProperties* pProperties)
+	{
+		if (pLayerName != nullptr)
+			return VK_ERROR_LAYER_NOT_PRESENT;
+
+		return Enumerate(INSTANCE_EXTENSIONS, sizeof(INSTANCE_EXTENSIONS) / sizeof(INSTANCE_EXTENSIONS[0]), pPropertyCount, pProperties);
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL CreateInstance(const VkInstanceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkInstance* pInstance)
+	{
+		if (!Supported(INSTANCE_EXTENSIONS, pCreateInfo->enabledExtensionCount, pCreateInfo->ppEnabledExtensionNames))
+			return VK_ERROR_EXTENSION_NOT_PRESENT;
+
+		Instance* instance = New<Instance>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE);
+
+		if (instance == nullptr)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		*pInstance = reinterpret_cast<VkInstance>(instance);
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL DestroyInstance(VkInstance instance, const VkAllocationCallbacks* pAllocator)
+	{
+		Delete(pAllocator, reinterpret_cast<Instance*>(instance));
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL EnumeratePhysicalDevices(VkInstance instance, uint32_t* pPhysicalDeviceCount, VkPhysicalDevice* pPhysicalDevices)
+	{
+		VkPhysicalDevice physical = reinterpret_cast<VkPhysicalDevice>(&reinterpret_cast<Instance*>(instance)->Physical);
+		return Enumerate(&physical, 1, pPhysicalDeviceCount, pPhysicalDevices);
+	}
+
+	VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFeatures(VkPhysicalDevice, VkPhysicalDeviceFeatures* pFeatures)
+	{
+		*pFeatures = {};
+	}
+
+	VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceProperties(VkPhysicalDevice, VkPhysicalDeviceProperties* pProperties)
+	{
+		*pProperties = {};
+		pProperties->apiVersion = API_VERSION;
+		pProperties->driverVersion = DRIVER_VERSION;
+		pProperties->vendorID = VENDOR_ID;
+		pProperties->deviceID = DEVICE_ID;
+		pProperties->deviceType = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+		strncpy(pProperties->deviceName, "Gears Mock ICD", VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1);
+		memcpy(pProperties->pipelineCacheUUID, PIPELINE_CACHE_UUID, VK_UUID_SIZE);
+
+		// Roughly a current desktop GPU's, the engine only sizes things by these
+		VkPhysicalDeviceLimits& limits = pProperties->limits;
+		limits.maxImageDimension1D = 16384;
+		limits.maxImageDimension2D = 16384;
+		limits.maxImageDimension3D = 2048;
+		limits.maxImageDimensionCube = 16384;
+		limits.maxImageArrayLayers = 2048;
+		limits.maxUniformBufferRange = 65536;
+		limits.maxStorageBufferRange = 1u << 30;
+		limits.maxPushConstantsSize = 256;
+		limits.maxMemoryAllocationCount = 4096;
+		limits.maxSamplerAllocationCount = 4000;
+		limits.bufferImageGranularity = 1024;
+		limits.maxBoundDescriptorSets = 8;
+		limits.maxComputeSharedMemorySize = 32768;
+		limits.maxComputeWorkGroupCount[0] = 65535;
+		limits.maxComputeWorkGroupCount[1] = 65535;
+		limits.maxComputeWorkGroupCount[2] = 65535;
+		limits.maxComputeWorkGroupInvocations = 1024;
+		limits.maxComputeWorkGroupSize[0] = 1024;
+		limits.maxComputeWorkGroupSize[1] = 1024;
+		limits.maxComputeWorkGroupSize[2] = 64;
+		limits.maxViewports = 16;
+		limits.maxColorAttachments = 8;
+		limits.maxFramebufferWidth = 16384;
+		limits.maxFramebufferHeight = 16384;
+		limits.minMemoryMapAlignment = 64;
+		limits.minTexelBufferOffsetAlignment = 16;
+		limits.minUniformBufferOffsetAlignment = 256;
+		limits.minStorageBufferOffsetAlignment = 16;
+		limits.timestampPeriod = 1.0f;
+		limits.timestampComputeAndGraphics = VK_TRUE;
+		limits.optimalBufferCopyOffsetAlignment = 16;
+		limits.optimalBufferCopyRowPitchAlignment = 16;
+		limits.nonCoherentAtomSize = 64;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceQueueFamilyProperties(VkPhysicalDevice, uint32_t* pQueueFamilyPropertyCount, VkQueueFamilyProperties* pQueueFamilyProperties)
+	{
+		VkQueueFamilyProperties families[QUEUE_FAMILY_COUNT];
+
+		for (uint32_t i = 0; i < QUEUE_FAMILY_COUNT; ++i)
+			families[i] = { QUEUE_FAMILY_FLAGS[i], 1, 64, { 1, 1, 1 } };
+
+		Enumerate(families, QUEUE_FAMILY_COUNT, pQueueFamilyPropertyCount, pQueueFamilyProperties);
+	}
+
+	VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceMemoryProperties(VkPhysicalDevice, VkPhysicalDeviceMemoryProperties* pMemoryProperties)
+	{
+		*pMemoryProperties = MEMORY_PROPERTIES;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL EnumerateDeviceExtensionProperties(VkPhysicalDevice, const char* pLayerName, uint32_t* pPropertyCount, VkExtensionProperties* pProperties)
+	{
+		if (pLayerName != nullptr)
+			return VK_ERROR_LAYER_NOT_PRESENT;
+
+		return Enumerate(DEVICE_EXTENSIONS, sizeof(DEVICE_EXTENSIONS) / sizeof(DEVICE_EXTENSIONS[0]), pPropertyCount, pProperties);
+	}
+
+	// Surfaces, only headless ones
+
+	VKAPI_ATTR VkResult VKAPI_CALL CreateHeadlessSurfaceEXT(VkInstance, const VkHeadlessSurfaceCreateInfoEXT*, const VkAllocationCallbacks* pAllocator, VkSurfaceKHR* pSurface)
+	{
+		*pSurface = ToHandle<VkSurfaceKHR>(New<Surface>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+		return *pSurface != VK_NULL_HANDLE ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL DestroySurfaceKHR(VkInstance, VkSurfaceKHR surface, const VkAllocationCallbacks* pAllocator)
+	{
+		DeleteHandle<Surface>(pAllocator, surface);
+	}
+
+	// Only the graphics family presents
+	VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceSupportKHR(VkPhysicalDevice, uint32_t queueFamilyIndex, VkSurfaceKHR, VkBool32* pSupported)
+	{
+		*pSupported = queueFamilyIndex == 0 ? VK_TRUE : VK_FALSE;
+		return VK_SUCCESS;
+	}
+
+	// A headless surface has no size of its own, the swapchain's extent decides
+	VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceCapabilitiesKHR(VkPhysicalDevice, VkSurfaceKHR, VkSurfaceCapabilitiesKHR* pSurfaceCapabilities)
+	{
+		*pSurfaceCapabilities = {};
+		pSurfaceCapabilities->minImageCount = 2;
+		pSurfaceCapabilities->maxImageCount = MAX_SWAPCHAIN_IMAGES;
+		pSurfaceCapabilities->currentExtent = { UINT32_MAX, UINT32_MAX };
+		pSurfaceCapabilities->minImageExtent = { 1, 1 };
+		pSurfaceCapabilities->maxImageExtent = { 16384, 16384 };
+		pSurfaceCapabilities->maxImageArrayLayers = 1;
+		pSurfaceCapabilities->supportedTransforms = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+		pSurfaceCapabilities->currentTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+		pSurfaceCapabilities->supportedCompositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+		pSurfaceCapabilities->supportedUsageFlags = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+			VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceFormatsKHR(VkPhysicalDevice, VkSurfaceKHR, uint32_t* pSurfaceFormatCount, VkSurfaceFormatKHR* pSurfaceFormats)
+	{
+		constexpr uint32_t count = sizeof(SURFACE_FORMATS) / sizeof(SURFACE_FORMATS[0]);
+		VkSurfaceFormatKHR formats[count];
+
+		for (uint32_t i = 0; i < count; ++i)
+			formats[i] = { SURFACE_FORMATS[i], VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+
+		return Enumerate(formats, count, pSurfaceFormatCount, pSurfaceFormats);
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfacePresentModesKHR(VkPhysicalDevice, VkSurfaceKHR, uint32_t* pPresentModeCount, VkPresentModeKHR* pPresentModes)
+	{
+		return Enumerate(PRESENT_MODES, sizeof(PRESENT_MODES) / sizeof(PRESENT_MODES[0]), pPresentModeCount, pPresentModes);
+	}
+
+	// Device and queues
+
+	VKAPI_ATTR VkResult VKAPI_CALL CreateDevice(VkPhysicalDevice, const VkDeviceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDevice* pDevice)
+	{
+		if (!Supported(DEVICE_EXTENSIONS, pCreateInfo->enabledExtensionCount, pCreateInfo->ppEnabledExtensionNames))
+			return VK_ERROR_EXTENSION_NOT_PRESENT;
+
+		for (uint32_t i = 0; i < pCreateInfo->queueCreateInfoCount; ++i)
+		{
+			const VkDeviceQueueCreateInfo& queueInfo = pCreateInfo->pQueueCreateInfos[i];
+
+			if (queueInfo.queueFamilyIndex >= QUEUE_FAMILY_COUNT || queueInfo.queueCount > 1)
+				return VK_ERROR_INITIALIZATION_FAILED;
+		}
+
+		Device* device = New<Device>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+
+		if (device == nullptr)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		*pDevice = reinterpret_cast<VkDevice>(device);
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL DestroyDevice(VkDevice device, const VkAllocationCallbacks* pAllocator)
+	{
+		Delete(pAllocator, reinterpret_cast<Device*>(device));
+	}
+
+	VKAPI_ATTR void VKAPI_CALL GetDeviceQueue(VkDevice device, uint32_t queueFamilyIndex, uint32_t, VkQueue* pQueue)
+	{
+		*pQueue = reinterpret_cast<VkQueue>(&reinterpret_cast<Device*>(device)->Queues[queueFamilyIndex]);
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL DeviceWaitIdle(VkDevice)
+	{
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL QueueWaitIdle(VkQueue)
+	{
+		return VK_SUCCESS;
+	}
+
+	// The work is done the moment it is submitted
+	VKAPI_ATTR VkResult VKAPI_CALL QueueSubmit(VkQueue, uint32_t, const VkSubmitInfo*, VkFence fence)
+	{
+		if (fence != VK_NULL_HANDLE)
+			FromHandle<Fence>(fence)->Signaled.store(true, std::memory_order_release);
+
+		return VK_SUCCESS;
+	}
+
+	// Synchronization
+
+	VKAPI_ATTR VkResult VKAPI_CALL CreateFence(VkDevice, const VkFenceCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkFence* pFence)
+	{
+		Fence* fence = New<Fence>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+		if (fence == nullptr)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		fence->Signaled.store((pCreateInfo->flags & VK_FENCE_CREATE_SIGNALED_BIT) != 0, std::memory_order_relaxed);
+		*pFence = ToHandle<VkFence>(fence);
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL DestroyFence(VkDevice, VkFence fence, const VkAllocationCallbacks* pAllocator)
+	{
+		DeleteHandle<Fence>(pAllocator, fence);
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL ResetFences(VkDevice, uint32_t fenceCount, const VkFence* pFences)
+	{
+		for (uint32_t i = 0; i < fenceCount; ++i)
+			FromHandle<Fence>(pFences[i])->Signaled.store(false, std::memory_order_relaxed);
+
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL GetFenceStatus(VkDevice, VkFence fence)
+	{
+		return FromHandle<Fence>(fence)->Signaled.load(std::memory_order_acquire) ? VK_SUCCESS : VK_NOT_READY;
+	}
+
+	// Nothing is ever pending, so an unsignaled fence would wait forever: time out at once instead
+	VKAPI_ATTR VkResult VKAPI_CALL WaitForFences(VkDevice, uint32_t fenceCount, const VkFence* pFences, VkBool32 waitAll, uint64_t)
+	{
+		uint32_t signaled = 0;
+
+		for (uint32_t i = 0; i < fenceCount; ++i)
+			signaled += FromHandle<Fence>(pFences[i])->Signaled.load(std::memory_order_acquire) ? 1 : 0;
+
+		return (waitAll ? signaled == fenceCount : signaled > 0) ? VK_SUCCESS : VK_TIMEOUT;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL CreateSemaphore(VkDevice, const VkSemaphoreCreateInfo*, const VkAllocationCallbacks* pAllocator, VkSemaphore* pSemaphore)
+	{
+		*pSemaphore = ToHandle<VkSemaphore>(New<Semaphore>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+		return *pSemaphore != VK_NULL_HANDLE ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL DestroySemaphore(VkDevice, VkSemaphore semaphore, const VkAllocationCallbacks* pAllocator)
+	{
+		DeleteHandle<Semaphore>(pAllocator, semaphore);
+	}
+
+	// Memory and buffers
+
+	VKAPI_ATTR VkResult VKAPI_CALL AllocateMemory(VkDevice, const VkMemoryAllocateInfo* pAllocateInfo, const VkAllocationCallbacks* pAllocator, VkDeviceMemory* pMemory)
+	{
+		if (pAllocateInfo->memoryTypeIndex >= MEMORY_PROPERTIES.memoryTypeCount)
+			return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+		const VkMemoryType& type = MEMORY_PROPERTIES.memoryTypes[pAllocateInfo->memoryTypeIndex];
+
+		if (pAllocateInfo->allocationSize > MEMORY_PROPERTIES.memoryHeaps[type.heapIndex].size)
+			return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+		DeviceMemory* memory = New<DeviceMemory>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+		if (memory == nullptr)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		memory->Size = pAllocateInfo->allocationSize;
+		*pMemory = ToHandle<VkDeviceMemory>(memory);
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL FreeMemory(VkDevice, VkDeviceMemory memory, const VkAllocationCallbacks* pAllocator)
+	{
+		if (memory == VK_NULL_HANDLE)
+			return;
+
+		free(FromHandle<DeviceMemory>(memory)->Data);
+		DeleteHandle<DeviceMemory>(pAllocator, memory);
+	}
+
+	// Backed on first map, memory that is never mapped costs nothing
+	VKAPI_ATTR VkResult VKAPI_CALL MapMemory(VkDevice, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize, VkMemoryMapFlags, void** ppData)
+	{
+		DeviceMemory* deviceMemory = FromHandle<DeviceMemory>(memory);
+
+		if (deviceMemory->Data == nullptr)
+			deviceMemory->Data = malloc(static_cast<size_t>(deviceMemory->Size));
+
+		if (deviceMemory->Data == nullptr)
+			return VK_ERROR_MEMORY_MAP_FAILED;
+
+		*ppData = static_cast<uint8_t*>(deviceMemory->Data) + offset;
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL UnmapMemory(VkDevice, VkDeviceMemory)
+	{
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL FlushMappedMemoryRanges(VkDevice, uint32_t, const VkMappedMemoryRange*)
+	{
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL CreateBuffer(VkDevice, const VkBufferCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkBuffer* pBuffer)
+	{
+		Buffer* buffer = New<Buffer>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+		if (buffer == nullptr)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		buffer->Size = pCreateInfo->size;
+		*pBuffer = ToHandle<VkBuffer>(buffer);
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL DestroyBuffer(VkDevice, VkBuffer buffer, const VkAllocationCallbacks* pAllocator)
+	{
+		DeleteHandle<Buffer>(pAllocator, buffer);
+	}
+
+	VKAPI_ATTR void VKAPI_CALL GetBufferMemoryRequirements(VkDevice, VkBuffer buffer, VkMemoryRequirements* pMemoryRequirements)
+	{
+		pMemoryRequirements->size = AlignUp(FromHandle<Buffer>(buffer)->Size, BUFFER_ALIGNMENT);
+		pMemoryRequirements->alignment = BUFFER_ALIGNMENT;
+		pMemoryRequirements->memoryTypeBits = ALL_MEMORY_TYPES;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL GetImageMemoryRequirements(VkDevice, VkImage image, VkMemoryRequirements* pMemoryRequirements)
+	{
+		pMemoryRequirements->size = AlignUp(FromHandle<Image>(image)->Size, IMAGE_ALIGNMENT);
+		pMemoryRequirements->alignment = IMAGE_ALIGNMENT;
+		pMemoryRequirements->memoryTypeBits = 1u << 0;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL BindBufferMemory(VkDevice, VkBuffer, VkDeviceMemory, VkDeviceSize)
+	{
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL BindImageMemory(VkDevice, VkImage, VkDeviceMemory, VkDeviceSize)
+	{
+		return VK_SUCCESS;
+	}
+
+	// The mock never creates images outside swapchains, nor views, pipelines,
+	// layouts, samplers or shader modules: any handle here is VK_NULL_HANDLE
+
+	VKAPI_ATTR void VKAPI_CALL DestroyImage(VkDevice, VkImage, const VkAllocationCallbacks*) {}
+	VKAPI_ATTR void VKAPI_CALL DestroyImageView(VkDevice, VkImageView, const VkAllocationCallbacks*) {}
+	VKAPI_ATTR void VKAPI_CALL DestroyPipeline(VkDevice, VkPipeline, const VkAllocationCallbacks*) {}
+	VKAPI_ATTR void VKAPI_CALL DestroyPipelineLayout(VkDevice, VkPipelineLayout, const VkAllocationCallbacks*) {}
+	VKAPI_ATTR void VKAPI_CALL DestroySampler(VkDevice, VkSampler, const VkAllocationCallbacks*) {}
+	VKAPI_ATTR void VKAPI_CALL DestroyShaderModule(VkDevice, VkShaderModule, const VkAllocationCallbacks*) {}
+
+	// Pipeline cache, holds nothing but a valid header
+
+	VKAPI_ATTR VkResult VKAPI_CALL CreatePipelineCache(VkDevice, const VkPipelineCacheCreateInfo*, const VkAllocationCallbacks* pAllocator, VkPipelineCache* pPipelineCache)
+	{
+		*pPipelineCache = ToHandle<VkPipelineCache>(New<PipelineCache>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+		return *pPipelineCache != VK_NULL_HANDLE ? VK_SUCCESS : VK_ERROR_OUT_OF_HOST_MEMORY;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL DestroyPipelineCache(VkDevice, VkPipelineCache pipelineCache, const VkAllocationCallbacks* pAllocator)
+	{
+		DeleteHandle<PipelineCache>(pAllocator, pipelineCache);
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL GetPipelineCacheData(VkDevice, VkPipelineCache, size_t* pDataSize, void* pData)
+	{
+		// VkPipelineCacheHeaderVersionOne, four words then the UUID
+		const uint32_t words[4] = { 4 * sizeof(uint32_t) + VK_UUID_SIZE, VK_PIPELINE_CACHE_HEADER_VERSION_ONE, VENDOR_ID, DEVICE_ID };
+		const size_t size = sizeof(words) + VK_UUID_SIZE;
+
+		if (pData == nullptr)
+		{
+			*pDataSize = size;
+			return VK_SUCCESS;
+		}
+
+		if (*pDataSize < size)
+		{
+			*pDataSize = 0;
+			return VK_INCOMPLETE;
+		}
+
+		memcpy(pData, words, sizeof(words));
+		memcpy(static_cast<uint8_t*>(pData) + sizeof(words), PIPELINE_CACHE_UUID, VK_UUID_SIZE);
+		*pDataSize = size;
+		return VK_SUCCESS;
+	}
+
+	// Queries, timestamps are taken when recorded
+
+	VKAPI_ATTR VkResult VKAPI_CALL CreateQueryPool(VkDevice, const VkQueryPoolCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkQueryPool* pQueryPool)
+	{
+		QueryPool* pool = New<QueryPool>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+		if (pool == nullptr)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		pool->Results.assign(pCreateInfo->queryCount, 0);
+		*pQueryPool = ToHandle<VkQueryPool>(pool);
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL DestroyQueryPool(VkDevice, VkQueryPool queryPool, const VkAllocationCallbacks* pAllocator)
+	{
+		DeleteHandle<QueryPool>(pAllocator, queryPool);
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL GetQueryPoolResults(VkDevice, VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount, size_t, void* pData,
+		VkDeviceSize stride, VkQueryResultFlags flags)
+	{
+		const QueryPool* pool = FromHandle<QueryPool>(queryPool);
+		const bool wide = (flags & VK_QUERY_RESULT_64_BIT) != 0;
+		const bool availability = (flags & VK_QUERY_RESULT_WITH_AVAILABILITY_BIT) != 0;
+		auto* out = static_cast<uint8_t*>(pData);
+
+		for (uint32_t i = 0; i < queryCount; ++i, out += stride)
+		{
+			const uint64_t value = pool->Results[firstQuery + i];
+
+			if (wide)
+			{
+				const uint64_t result[2] = { value, 1 };
+				memcpy(out, result, availability ? sizeof(result) : sizeof(result[0]));
+			}
+			else
+			{
+				const uint32_t result[2] = { static_cast<uint32_t>(value), 1 };
+				memcpy(out, result, availability ? sizeof(result) : sizeof(result[0]));
+			}
+		}
+
+		return VK_SUCCESS;
+	}
+
+	// Command pools and buffers
+
+	VKAPI_ATTR VkResult VKAPI_CALL CreateCommandPool(VkDevice, const VkCommandPoolCreateInfo*, const VkAllocationCallbacks* pAllocator, VkCommandPool* pCommandPool)
+	{
+		CommandPool* pool = New<CommandPool>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+		if (pool == nullptr)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		if (pAllocator != nullptr)
+		{
+			pool->Allocator = *pAllocator;
+			pool->HasAllocator = true;
+		}
+
+		*pCommandPool = ToHandle<VkCommandPool>(pool);
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL DestroyCommandPool(VkDevice, VkCommandPool commandPool, const VkAllocationCallbacks* pAllocator)
+	{
+		CommandPool* pool = FromHandle<CommandPool>(commandPool);
+
+		if (pool == nullptr)
+			return;
+
+		for (CommandBuffer* buffer : pool->Buffers)
+			Delete(pool->HasAllocator ? &pool->Allocator : nullptr, buffer);
+
+		Delete(pAllocator, pool);
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL ResetCommandPool(VkDevice, VkCommandPool, VkCommandPoolResetFlags)
+	{
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL AllocateCommandBuffers(VkDevice, const VkCommandBufferAllocateInfo* pAllocateInfo, VkCommandBuffer* pCommandBuffers)
+	{
+		CommandPool* pool = FromHandle<CommandPool>(pAllocateInfo->commandPool);
+		const VkAllocationCallbacks* allocator = pool->HasAllocator ? &pool->Allocator : nullptr;
+
+		for (uint32_t i = 0; i < pAllocateInfo->commandBufferCount; ++i)
+		{
+			CommandBuffer* buffer = New<CommandBuffer>(allocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+			if (buffer == nullptr)
+				return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+			pool->Buffers.push_back(buffer);
+			pCommandBuffers[i] = reinterpret_cast<VkCommandBuffer>(buffer);
+		}
+
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL FreeCommandBuffers(VkDevice, VkCommandPool commandPool, uint32_t commandBufferCount, const VkCommandBuffer* pCommandBuffers)
+	{
+		CommandPool* pool = FromHandle<CommandPool>(commandPool);
+
+		for (uint32_t i = 0; i < commandBufferCount; ++i)
+		{
+			auto* buffer = reinterpret_cast<CommandBuffer*>(pCommandBuffers[i]);
+			auto found = std::find(pool->Buffers.begin(), pool->Buffers.end(), buffer);
+
+			if (found == pool->Buffers.end())
+				continue;
+
+			pool->Buffers.erase(found);
+			Delete(pool->HasAllocator ? &pool->Allocator : nullptr, buffer);
+		}
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL BeginCommandBuffer(VkCommandBuffer, const VkCommandBufferBeginInfo*)
+	{
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL EndCommandBuffer(VkCommandBuffer)
+	{
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL ResetCommandBuffer(VkCommandBuffer, VkCommandBufferResetFlags)
+	{
+		return VK_SUCCESS;
+	}
+
+	// Commands, all dropped but the queries
+
+	VKAPI_ATTR void VKAPI_CALL CmdClearColorImage(VkCommandBuffer, VkImage, VkImageLayout, const VkClearColorValue*, uint32_t, const VkImageSubresourceRange*) {}
+	VKAPI_ATTR void VKAPI_CALL CmdCopyBuffer(VkCommandBuffer, VkBuffer, VkBuffer, uint32_t, const VkBufferCopy*) {}
+	VKAPI_ATTR void VKAPI_CALL CmdCopyBufferToImage(VkCommandBuffer, VkBuffer, VkImage, VkImageLayout, uint32_t, const VkBufferImageCopy*) {}
+	VKAPI_ATTR void VKAPI_CALL CmdDispatch(VkCommandBuffer, uint32_t, uint32_t, uint32_t) {}
+	VKAPI_ATTR void VKAPI_CALL CmdDraw(VkCommandBuffer, uint32_t, uint32_t, uint32_t, uint32_t) {}
+	VKAPI_ATTR void VKAPI_CALL CmdDrawIndexed(VkCommandBuffer, uint32_t, uint32_t, uint32_t, int32_t, uint32_t) {}
+	VKAPI_ATTR void VKAPI_CALL CmdExecuteCommands(VkCommandBuffer, uint32_t, const VkCommandBuffer*) {}
+	VKAPI_ATTR void VKAPI_CALL CmdSetScissor(VkCommandBuffer, uint32_t, uint32_t, const VkRect2D*) {}
+	VKAPI_ATTR void VKAPI_CALL CmdSetViewport(VkCommandBuffer, uint32_t, uint32_t, const VkViewport*) {}
+
+	VKAPI_ATTR void VKAPI_CALL CmdPipelineBarrier(VkCommandBuffer, VkPipelineStageFlags, VkPipelineStageFlags, VkDependencyFlags,
+		uint32_t, const VkMemoryBarrier*, uint32_t, const VkBufferMemoryBarrier*, uint32_t, const VkImageMemoryBarrier*)
+	{
+	}
+
+	VKAPI_ATTR void VKAPI_CALL CmdResetQueryPool(VkCommandBuffer, VkQueryPool queryPool, uint32_t firstQuery, uint32_t queryCount)
+	{
+		std::vector<uint64_t>& results = FromHandle<QueryPool>(queryPool)->Results;
+		std::fill(results.begin() + firstQuery, results.begin() + firstQuery + queryCount, 0);
+	}
+
+	// Each write a fixed step after the last, whichever thread records it
+	VKAPI_ATTR void VKAPI_CALL CmdWriteTimestamp(VkCommandBuffer, VkPipelineStageFlagBits, VkQueryPool queryPool, uint32_t query)
+	{
+		FromHandle<QueryPool>(queryPool)->Results[query] = s_Ticks.fetch_add(TIMESTAMP_STEP, std::memory_order_relaxed) + TIMESTAMP_STEP;
+	}
+
+	// Swapchains
+
+	VKAPI_ATTR VkResult VKAPI_CALL CreateSwapchainKHR(VkDevice, const VkSwapchainCreateInfoKHR* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkSwapchainKHR* pSwapchain)
+	{
+		Swapchain* swapchain = New<Swapchain>(pAllocator, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+
+		if (swapchain == nullptr)
+			return VK_ERROR_OUT_OF_HOST_MEMORY;
+
+		const VkExtent2D extent = pCreateInfo->imageExtent;
+		swapchain->ImageCount = std::min(std::max(pCreateInfo->minImageCount, 2u), MAX_SWAPCHAIN_IMAGES);
+
+		for (uint32_t i = 0; i < swapchain->ImageCount; ++i)
+			swapchain->Images[i].Size = VkDeviceSize(extent.width) * extent.height * 4;
+
+		*pSwapchain = ToHandle<VkSwapchainKHR>(swapchain);
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR void VKAPI_CALL DestroySwapchainKHR(VkDevice, VkSwapchainKHR swapchain, const VkAllocationCallbacks* pAllocator)
+	{
+		DeleteHandle<Swapchain>(pAllocator, swapchain);
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL GetSwapchainImagesKHR(VkDevice, VkSwapchainKHR swapchain, uint32_t* pSwapchainImageCount, VkImage* pSwapchainImages)
+	{
+		Swapchain* chain = FromHandle<Swapchain>(swapchain);
+		VkImage images[MAX_SWAPCHAIN_IMAGES];
+
+		for (uint32_t i = 0; i < chain->ImageCount; ++i)
+			images[i] = ToHandle<VkImage>(&chain->Images[i]);
+
+		return Enumerate(images, chain->ImageCount, pSwapchainImageCount, pSwapchainImages);
+	}
+
+	// Images come back in order, each available at once
+	VKAPI_ATTR VkResult VKAPI_CALL AcquireNextImageKHR(VkDevice, VkSwapchainKHR swapchain, uint64_t, VkSemaphore, VkFence fence, uint32_t* pImageIndex)
+	{
+		Swapchain* chain = FromHandle<Swapchain>(swapchain);
+		*pImageIndex = chain->Next;
+		chain->Next = (chain->Next + 1) % chain->ImageCount;
+
+		if (fence != VK_NULL_HANDLE)
+			FromHandle<Fence>(fence)->Signaled.store(true, std::memory_order_release);
+
+		return VK_SUCCESS;
+	}
+
+	VKAPI_ATTR VkResult VKAPI_CALL QueuePresentKHR(VkQueue, const VkPresentInfoKHR* pPresentInfo)
+	{
+		if (pPresentInfo->pResults != nullptr)
+		{
+			for (uint32_t i = 0; i < pPresentInfo->swapchainCount; ++i)
+				pPresentInfo->pResults[i] = VK_SUCCESS;
+		}
+
+		return VK_SUCCESS;
+	}
+
+	// Entry points
+
+	PFN_vkVoidFunction GetProcAddr(const char* pName);
+
+	VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetInstanceProcAddr(VkInstance, const char* pName)
+	{
+		return GetProcAddr(pName);
+	}
+
+	VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetDeviceProcAddr(VkDevice, const char* pName)
+	{
+		return GetProcAddr(pName);
+	}
+
+	struct EntryPoint
+	{
+		const char*        Name;
+		PFN_vkVoidFunction Function;
+	};
+
+#define GEARS_MOCK_ENTRY(name) { "vk" #name, reinterpret_cast<PFN_vkVoidFunction>(name) }
+
+	const EntryPoint ENTRY_POINTS[] = {
+		GEARS_MOCK_ENTRY(AcquireNextImageKHR),
+		GEARS_MOCK_ENTRY(AllocateCommandBuffers),
+		GEARS_MOCK_ENTRY(AllocateMemory),
+		GEARS_MOCK_ENTRY(BeginCommandBuffer),
+		GEARS_MOCK_ENTRY(BindBufferMemory),
+		GEARS_MOCK_ENTRY(BindImageMemory),
+		GEARS_MOCK_ENTRY(CmdClearColorImage),
+		GEARS_MOCK_ENTRY(CmdCopyBuffer),
+		GEARS_MOCK_ENTRY(CmdCopyBufferToImage),
+		GEARS_MOCK_ENTRY(CmdDispatch),
+		GEARS_MOCK_ENTRY(CmdDraw),
+		GEARS_MOCK_ENTRY(CmdDrawIndexed),
+		GEARS_MOCK_ENTRY(CmdExecuteCommands),
+		GEARS_MOCK_ENTRY(CmdPipelineBarrier),
+		GEARS_MOCK_ENTRY(CmdResetQueryPool),
+		GEARS_MOCK_ENTRY(CmdSetScissor),
+		GEARS_MOCK_ENTRY(CmdSetViewport),
+		GEARS_MOCK_ENTRY(CmdWriteTimestamp),
+		GEARS_MOCK_ENTRY(CreateBuffer),
+		GEARS_MOCK_ENTRY(CreateCommandPool),
+		GEARS_MOCK_ENTRY(CreateDevice),
+		GEARS_MOCK_ENTRY(CreateFence),
+		GEARS_MOCK_ENTRY(CreateHeadlessSurfaceEXT),
+		GEARS_MOCK_ENTRY(CreateInstance),
+		GEARS_MOCK_ENTRY(CreatePipelineCache),
+		GEARS_MOCK_ENTRY(CreateQueryPool),
+		GEARS_MOCK_ENTRY(CreateSemaphore),
+		GEARS_MOCK_ENTRY(CreateSwapchainKHR),
+		GEARS_MOCK_ENTRY(DestroyBuffer),
+		GEARS_MOCK_ENTRY(DestroyCommandPool),
+		GEARS_MOCK_ENTRY(DestroyDevice),
+		GEARS_MOCK_ENTRY(DestroyFence),
+		GEARS_MOCK_ENTRY(DestroyImage),
+		GEARS_MOCK_ENTRY(DestroyImageView),
+		GEARS_MOCK_ENTRY(DestroyInstance),
+		GEARS_MOCK_ENTRY(DestroyPipeline),
+		GEARS_MOCK_ENTRY(DestroyPipelineCache),
+		GEARS_MOCK_ENTRY(DestroyPipelineLayout),
+		GEARS_MOCK_ENTRY(DestroyQueryPool),
+		GEARS_MOCK_ENTRY(DestroySampler),
+		GEARS_MOCK_ENTRY(DestroySemaphore),
+		GEARS_MOCK_ENTRY(DestroyShaderModule),
+		GEARS_MOCK_ENTRY(DestroySurfaceKHR),
+		GEARS_MOCK_ENTRY(DestroySwapchainKHR),
+		GEARS_MOCK_ENTRY(DeviceWaitIdle),
+		GEARS_MOCK_ENTRY(EndCommandBuffer),
+		GEARS_MOCK_ENTRY(EnumerateDeviceExtensionProperties),
+		GEARS_MOCK_ENTRY(EnumerateInstanceExtensionProperties),
+		GEARS_MOCK_ENTRY(EnumerateInstanceLayerProperties),
+		GEARS_MOCK_ENTRY(EnumerateInstanceVersion),
+		GEARS_MOCK_ENTRY(EnumeratePhysicalDevices),
+		GEARS_MOCK_ENTRY(FlushMappedMemoryRanges),
+		GEARS_MOCK_ENTRY(FreeCommandBuffers),
+		GEARS_MOCK_ENTRY(FreeMemory),
+		GEARS_MOCK_ENTRY(GetBufferMemoryRequirements),
+		GEARS_MOCK_ENTRY(GetDeviceProcAddr),
+		GEARS_MOCK_ENTRY(GetDeviceQueue),
+		GEARS_MOCK_ENTRY(GetFenceStatus),
+		GEARS_MOCK_ENTRY(GetImageMemoryRequirements),
+		GEARS_MOCK_ENTRY(GetInstanceProcAddr),
+		GEARS_MOCK_ENTRY(GetPhysicalDeviceFeatures),
+		GEARS_MOCK_ENTRY(GetPhysicalDeviceMemoryProperties),
+		GEARS_MOCK_ENTRY(GetPhysicalDeviceProperties),
+		GEARS_MOCK_ENTRY(GetPhysicalDeviceQueueFamilyProperties),
+		GEARS_MOCK_ENTRY(GetPhysicalDeviceSurfaceCapabilitiesKHR),
+		GEARS_MOCK_ENTRY(GetPhysicalDeviceSurfaceFormatsKHR),
+		GEARS_MOCK_ENTRY(GetPhysicalDeviceSurfacePresentModesKHR),
+		GEARS_MOCK_ENTRY(GetPhysicalDeviceSurfaceSupportKHR),
+		GEARS_MOCK_ENTRY(GetPipelineCacheData),
+		GEARS_MOCK_ENTRY(GetQueryPoolResults),
+		GEARS_MOCK_ENTRY(GetSwapchainImagesKHR),
+		GEARS_MOCK_ENTRY(MapMemory),
+		GEARS_MOCK_ENTRY(QueuePresentKHR),
+		GEARS_MOCK_ENTRY(QueueSubmit),
+		GEARS_MOCK_ENTRY(QueueWaitIdle),
+		GEARS_MOCK_ENTRY(ResetCommandBuffer),
+		GEARS_MOCK_ENTRY(ResetCommandPool),
+		GEARS_MOCK_ENTRY(ResetFences),
+		GEARS_MOCK_ENTRY(UnmapMemory),
+		GEARS_MOCK_ENTRY(WaitForFences)
+	};
+
+#undef GEARS_MOCK_ENTRY
+
+	// Only looked up while loading, a scan is plenty
+	PFN_vkVoidFunction GetProcAddr(const char* pName)
+	{
+		for (const EntryPoint& entry : ENTRY_POINTS)
+		{
+			if (strcmp(entry.Name, pName) == 0)
+				return entry.Function;
+		}
+
+		return nullptr;
+	}
+}
+
+// The loader's interface, nothing else is exported
+
+extern "C" VKAPI_ATTR VkResult VKAPI_CALL vk_icdNegotiateLoaderICDInterfaceVersion(uint32_t* pSupportedVersion)
+{
+	if (*pSupportedVersion < MIN_ICD_INTERFACE_VERSION)
+		return VK_ERROR_INCOMPATIBLE_DRIVER;
+
+	*pSupportedVersion = std::min(*pSupportedVersion, ICD_INTERFACE_VERSION);
+	return VK_SUCCESS;
+}
+
+extern "C" VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vk_icdGetInstanceProcAddr(VkInstance instance, const char* pName)
+{
+	return GetInstanceProcAddr(instance, pName);
+}
+
+extern "C" VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vk_icdGetPhysicalDeviceProcAddr(VkInstance, const char* pName)
+{
+	return GetProcAddr(pName);
+}
@@ -0,0 +1,40 @@
+#include "android_platform.h"
+
+#include <vulkan/vulkan_android.h>
+
+Gears::AndroidPlatform::AndroidPlatform( android_app* app ) :
+	m_AndroidApp( app )
+{
+}
+
+std::vector<const char*> Gears::AndroidPlatform::GetInstanceExtensions() const
+{
+	return { "VK_KHR_surface", "VK_KHR_android_surface" };
+}
+
+VkResult Gears::AndroidPlatform::CreateSurface(VkInstance instance, const VkAllocationCallbacks* allocator, VkSurfaceKHR* surface) const
+{
+	auto vkCreateAndroidSurfaceKHR = reinterpret_cast<PFN_vkCreateAndroidSurfaceKHR>
+		(vkGetInstanceProcAddr(instance, "vkCreateAndroidSurfaceKHR"));
+
+	if (vkCreateAndroidSurfaceKHR == nullptr)
+		return VK_ERROR_EXTENSION_NOT_PRESENT;
+
+	VkAndroidSurfaceCreateInfoKHR surfaceCreateInfo = {};
+	surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR;
+	surfaceCreateInfo.window = m_AndroidApp->window;
+
+	return vkCreateAndroidSurfaceKHR(instance, &surfaceCreateInfo, allocator, surface);
+}
+
+VkExtent2D Gears::AndroidPlatform::GetWindowExtent() const
+{
+	return {
+		static_cast<uint32_t>(ANativeWindow_getWidth(m_AndroidApp->window)),
+		static_cast<uint32_t>(ANativeWindow_getHeight(m_AndroidApp->window)) };
+}
+
+std::string Gears::AndroidPlatform::GetStoragePath() const
+{
+	return m_AndroidApp->activity->internalDataPath;
+}
@@ -0,0 +1,42 @@
+#include "app_lifecycle.h"
+
+void Gears::AppLifecycle::OnEvent(LifecycleEvent event)
+{
+	switch (event)
+	{
+		case LifecycleEvent::Start:           m_Started = true; break;
+		case LifecycleEvent::Resume:          m_Resumed = true; break;
+		case LifecycleEvent::Pause:           m_Resumed = false; break;
+		case LifecycleEvent::Stop:            m_Started = false; m_Resumed = false; break;
+		case LifecycleEvent::WindowCreated:   m_Window = true; break;
+		case LifecycleEvent::WindowDestroyed: m_Window = false; break;
+		case LifecycleEvent::Destroy:         m_Destroyed = true; break;
+	}
+}
+
+int Gears::AppLifecycle::GetPollTimeout(StepResult last) const
+{
+	if (m_Destroyed || (last == StepResult::Rendered && ShouldRender()))
+		return 0;
+
+	return last == StepResult::Pending ? PENDING_POLL_MS : -1;
+}
+
+void Gears::RunEventLoop(Looper& looper, AppLifecycle& lifecycle, const std::function<StepResult()>& step)
+{
+	StepResult last = StepResult::Idle;
+
+	while (!lifecycle.IsDestroyRequested())
+	{
+		// Only the first poll may wait, the rest drain whatever queued up meanwhile
+		int timeout = lifecycle.GetPollTimeout(last);
+
+		while (looper.PollOnce(timeout) && !lifecycle.IsDestroyRequested())
+			timeout = 0;
+
+		if (lifecycle.IsDestroyRequested())
+			break;
+
+		last = step();
+	}
+}
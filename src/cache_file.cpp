@@ -0,0 +1,63 @@
+#include "cache_file.h"
+#include "Logger.h"
+
+#include <cstdio>
+
+uint64_t Gears::HashCacheData(const void* data, size_t size)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	auto* bytes = static_cast<const uint8_t*>(data);
+
+	for (size_t i = 0; i < size; ++i)
+		hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+
+	return hash;
+}
+
+std::vector<uint8_t> Gears::ReadCacheFile(const std::string& path)
+{
+	std::vector<uint8_t> data;
+	FILE* file = fopen(path.c_str(), "rb");
+
+	if (file == nullptr)
+		return data;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (size > 0)
+	{
+		data.resize(static_cast<size_t>(size));
+
+		if (fread(data.data(), 1, data.size(), file) != data.size())
+			data.clear();
+	}
+
+	fclose(file);
+	return data;
+}
+
+bool Gears::WriteCacheFile(const std::string& path, const std::vector<uint8_t>& data)
+{
+	std::string tempPath = path + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+
+	if (file == nullptr)
+	{
+		LOGE("GearsError::Could not open %s for writing", tempPath.c_str());
+		return false;
+	}
+
+	bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+	written = (fclose(file) == 0) && written;
+
+	if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0)
+	{
+		LOGE("GearsError::Failed to write %s", path.c_str());
+		std::remove(tempPath.c_str());
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,241 @@
+#include "capability_snapshot.h"
+#include "cache_file.h"
+#include "device_selection.h"
+#include "Logger.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	struct SnapshotHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t ScoringVersion; // Scores and suitability go stale with the rules that produced them
+		uint32_t Reserved;
+		uint64_t DataSize;
+		uint64_t DataHash;
+	};
+
+	class Writer
+	{
+		public:
+
+		std::vector<uint8_t> Data = std::vector<uint8_t>(sizeof(SnapshotHeader));
+
+		void Bytes(const void* data, size_t size)
+		{
+			auto* bytes = static_cast<const uint8_t*>(data);
+			Data.insert(Data.end(), bytes, bytes + size);
+		}
+
+		template<typename T>
+		void Value(T value) { Bytes(&value, sizeof(value)); }
+
+		void String(const std::string& string)
+		{
+			Value(static_cast<uint32_t>(string.size()));
+			Bytes(string.data(), string.size());
+		}
+
+		void Strings(const std::vector<std::string>& strings)
+		{
+			Value(static_cast<uint32_t>(strings.size()));
+
+			for (const auto& i : strings)
+				String(i);
+		}
+	};
+
+	// Every read is bounds checked, a short or garbled file just fails
+	class Reader
+	{
+		public:
+
+		Reader(const uint8_t* data, size_t size) : m_Data(data), m_Size(size) {}
+
+		bool Bytes(void* out, size_t size)
+		{
+			if (size > m_Size - m_Offset)
+				return false;
+
+			std::memcpy(out, m_Data + m_Offset, size);
+			m_Offset += size;
+			return true;
+		}
+
+		template<typename T>
+		bool Value(T& value) { return Bytes(&value, sizeof(value)); }
+
+		bool String(std::string& string)
+		{
+			uint32_t length;
+
+			if (!Value(length) || length > m_Size - m_Offset)
+				return false;
+
+			string.assign(reinterpret_cast<const char*>(m_Data + m_Offset), length);
+			m_Offset += length;
+			return true;
+		}
+
+		bool Strings(std::vector<std::string>& strings)
+		{
+			uint32_t count;
+
+			if (!Value(count) || count > m_Size - m_Offset)
+				return false;
+
+			strings.resize(count);
+
+			for (auto& i : strings)
+				if (!String(i))
+					return false;
+
+			return true;
+		}
+
+		bool AtEnd() const { return m_Offset == m_Size; }
+
+		private:
+
+		const uint8_t* m_Data;
+		size_t         m_Size;
+		size_t         m_Offset = 0;
+	};
+}
+
+std::vector<uint8_t> Gears::SerializeCapabilities(const CapabilitySnapshot& snapshot)
+{
+	Writer writer;
+	writer.Value(snapshot.InstanceVersion);
+	writer.Value(snapshot.Build);
+	writer.Strings(snapshot.Layers);
+	writer.Strings(snapshot.InstanceExtensions);
+	writer.Value(static_cast<uint32_t>(snapshot.Devices.size()));
+
+	for (const auto& device : snapshot.Devices)
+	{
+		writer.Value(device.VendorID);
+		writer.Value(device.DeviceID);
+		writer.Value(device.DriverVersion);
+		writer.Bytes(device.PipelineCacheUUID, VK_UUID_SIZE);
+		writer.Value(device.Score);
+		writer.Value(static_cast<uint8_t>(device.Suitable));
+		writer.String(device.Reason);
+		writer.Strings(device.Extensions);
+		writer.Value(static_cast<uint32_t>(device.Queues.size()));
+		writer.Bytes(device.Queues.data(), device.Queues.size() * sizeof(VkQueueFamilyProperties));
+	}
+
+	SnapshotHeader header{};
+	header.Magic = CAPABILITY_SNAPSHOT_MAGIC;
+	header.Version = CAPABILITY_SNAPSHOT_VERSION;
+	header.ScoringVersion = DEVICE_SCORING_VERSION;
+	header.DataSize = writer.Data.size() - sizeof(header);
+	header.DataHash = HashCacheData(writer.Data.data() + sizeof(header), header.DataSize);
+	std::memcpy(writer.Data.data(), &header, sizeof(header));
+
+	return std::move(writer.Data);
+}
+
+bool Gears::DeserializeCapabilities(const uint8_t* data, size_t size, CapabilitySnapshot& snapshot)
+{
+	SnapshotHeader header;
+
+	if (size < sizeof(header))
+		return false;
+
+	std::memcpy(&header, data, sizeof(header));
+	data += sizeof(header);
+	size -= sizeof(header);
+
+	if (header.Magic != CAPABILITY_SNAPSHOT_MAGIC || header.Version != CAPABILITY_SNAPSHOT_VERSION ||
+		header.ScoringVersion != DEVICE_SCORING_VERSION)
+		return false;
+
+	if (header.DataSize != size || header.DataHash != HashCacheData(data, size))
+		return false;
+
+	Reader reader{ data, size };
+	CapabilitySnapshot result;
+	uint32_t deviceCount;
+
+	if (!reader.Value(result.InstanceVersion) || !reader.Value(result.Build) ||
+		!reader.Strings(result.Layers) || !reader.Strings(result.InstanceExtensions) ||
+		!reader.Value(deviceCount) || deviceCount > size)
+		return false;
+
+	result.Devices.resize(deviceCount);
+
+	for (auto& device : result.Devices)
+	{
+		uint8_t suitable;
+		uint32_t queueCount;
+
+		if (!reader.Value(device.VendorID) || !reader.Value(device.DeviceID) || !reader.Value(device.DriverVersion) ||
+			!reader.Bytes(device.PipelineCacheUUID, VK_UUID_SIZE) || !reader.Value(device.Score) ||
+			!reader.Value(suitable) || !reader.String(device.Reason) ||
+			!reader.Strings(device.Extensions) || !reader.Value(queueCount) || queueCount > size)
+			return false;
+
+		device.Suitable = suitable != 0;
+		device.Queues.resize(queueCount);
+
+		if (!reader.Bytes(device.Queues.data(), queueCount * sizeof(VkQueueFamilyProperties)))
+			return false;
+	}
+
+	if (!reader.AtEnd())
+		return false;
+
+	snapshot = std::move(result);
+	return true;
+}
+
+bool Gears::MatchesDevices(const CapabilitySnapshot& snapshot, const std::vector<VkPhysicalDeviceProperties>& devices)
+{
+	if (snapshot.Devices.size() != devices.size())
+		return false;
+
+	for (size_t i = 0; i < devices.size(); ++i)
+	{
+		const CachedDevice& cached = snapshot.Devices[i];
+
+		if (cached.VendorID != devices[i].vendorID ||
+			cached.DeviceID != devices[i].deviceID ||
+			cached.DriverVersion != devices[i].driverVersion ||
+			std::memcmp(cached.PipelineCacheUUID, devices[i].pipelineCacheUUID, VK_UUID_SIZE) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+bool Gears::LoadCapabilities(const std::string& path, CapabilitySnapshot& snapshot)
+{
+	auto data = ReadCacheFile(path);
+
+	if (data.empty())
+		return false;
+
+	if (!DeserializeCapabilities(data.data(), data.size(), snapshot))
+	{
+		LOGI("Capability snapshot at %s is stale or corrupt, probing", path.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool Gears::SaveCapabilities(const std::string& path, const CapabilitySnapshot& snapshot)
+{
+	auto data = SerializeCapabilities(snapshot);
+
+	if (!WriteCacheFile(path, data))
+		return false;
+
+	LOGI("Capability snapshot saved: %zu bytes", data.size());
+	return true;
+}
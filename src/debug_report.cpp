@@ -0,0 +1,140 @@
+#include "debug_report.h"
+#include "Logger.h"
+
+#include <cstring>
+
+VKAPI_ATTR VkBool32 VKAPI_CALL Gears::DebugReportAggregator::Callback(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objectType,
+	uint64_t object, size_t location, int32_t messageCode, const char* pLayerPrefix, const char* pMessage, void* pUserData)
+{
+	static_cast<DebugReportAggregator*>(pUserData)->Report(flags, objectType, messageCode, pMessage);
+	return VK_FALSE;
+}
+
+uint64_t Gears::DebugReportAggregator::MakeKey(int32_t messageCode, VkDebugReportObjectTypeEXT objectType)
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(messageCode)) << 32) | static_cast<uint32_t>(objectType);
+}
+
+uint32_t Gears::DebugReportAggregator::HomeSlot(uint64_t key)
+{
+	return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> 32) % DEBUG_REPORT_TABLE_SIZE;
+}
+
+void Gears::DebugReportAggregator::Report(VkDebugReportFlagsEXT flags, VkDebugReportObjectTypeEXT objectType, int32_t messageCode, const char* message)
+{
+	if (flags & VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT)
+	{
+		m_FramePerformanceWarnings.fetch_add(1, std::memory_order_relaxed);
+		m_TotalPerformanceWarnings.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	const uint64_t key = MakeKey(messageCode, objectType);
+	uint32_t slot = HomeSlot(key);
+
+	// Open addressing, slots are claimed with a CAS and never released
+	for (uint32_t probe = 0; probe < DEBUG_REPORT_TABLE_SIZE; ++probe, slot = (slot + 1) % DEBUG_REPORT_TABLE_SIZE)
+	{
+		DebugReportEntry& entry = m_Entries[slot];
+		uint64_t current = entry.Key.load(std::memory_order_acquire);
+
+		if (current == key)
+		{
+			entry.Count.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		if (current != UINT64_MAX)
+			continue;
+
+		if (!entry.Key.compare_exchange_strong(current, key, std::memory_order_acq_rel))
+		{
+			if (current != key)
+				continue;
+
+			entry.Count.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		entry.Flags = flags;
+		strncpy(entry.FirstMessage, message ? message : "", DEBUG_REPORT_MESSAGE_SIZE - 1);
+		entry.FirstMessage[DEBUG_REPORT_MESSAGE_SIZE - 1] = '\0';
+		entry.Count.fetch_add(1, std::memory_order_relaxed);
+		entry.Ready.store(true, std::memory_order_release);
+		m_Distinct.fetch_add(1, std::memory_order_relaxed);
+
+		// Only the first occurrence is logged in full
+		if (flags & VK_DEBUG_REPORT_ERROR_BIT_EXT)
+			LOGE("GearsError::VULKAN: %s", message);
+		else
+			LOGW("GearsWarning::VULKAN: %s", message);
+
+		return;
+	}
+
+	if (m_Overflow.fetch_add(1, std::memory_order_relaxed) == 0)
+		LOGW("GearsWarning::Debug report table full, further distinct messages are only counted");
+}
+
+void Gears::DebugReportAggregator::EndFrame()
+{
+	m_LastFramePerformanceWarnings = m_FramePerformanceWarnings.exchange(0, std::memory_order_relaxed);
+}
+
+void Gears::DebugReportAggregator::Tick()
+{
+	auto now = std::chrono::steady_clock::now();
+
+	if (now - m_LastSummary < m_SummaryInterval)
+		return;
+
+	m_LastSummary = now;
+	LogSummary();
+}
+
+// Lists only messages that fired again since the previous summary
+void Gears::DebugReportAggregator::LogSummary()
+{
+	uint32_t repeated = 0;
+
+	for (auto& entry : m_Entries)
+	{
+		if (!entry.Ready.load(std::memory_order_acquire))
+			continue;
+
+		uint32_t count = entry.Count.load(std::memory_order_relaxed);
+
+		if (count == entry.SummarizedCount)
+			continue;
+
+		uint64_t key = entry.Key.load(std::memory_order_relaxed);
+
+		LOGI("Validation x%u (+%u) code %d object type %u: %.96s", count, count - entry.SummarizedCount,
+			static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key), entry.FirstMessage);
+
+		entry.SummarizedCount = count;
+		++repeated;
+	}
+
+	if (repeated > 0)
+		LOGI("Validation summary: %u active of %u distinct messages, %llu performance warnings, %u last frame",
+			repeated, GetDistinctCount(), static_cast<unsigned long long>(GetTotalPerformanceWarnings()), m_LastFramePerformanceWarnings);
+}
+
+uint32_t Gears::DebugReportAggregator::GetCount(int32_t messageCode, VkDebugReportObjectTypeEXT objectType) const
+{
+	const uint64_t key = MakeKey(messageCode, objectType);
+	uint32_t slot = HomeSlot(key);
+
+	for (uint32_t probe = 0; probe < DEBUG_REPORT_TABLE_SIZE; ++probe, slot = (slot + 1) % DEBUG_REPORT_TABLE_SIZE)
+	{
+		uint64_t current = m_Entries[slot].Key.load(std::memory_order_acquire);
+
+		if (current == key)
+			return m_Entries[slot].Count.load(std::memory_order_relaxed);
+
+		if (current == UINT64_MAX)
+			return 0;
+	}
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+#include "deletion_queue.h"
+#include "Logger.h"
+
+Gears::DeletionQueue::~DeletionQueue()
+{
+	if (!m_Pending.empty())
+		LOGE("GearsError::Deletion queue destroyed with %zu resources pending", m_Pending.size());
+}
+
+void Gears::DeletionQueue::Init(VkDevice device, MemoryAllocator* allocator, const VkAllocationCallbacks* callbacks)
+{
+	m_Device = device;
+	m_Allocator = allocator;
+	m_AllocationCallbacks = callbacks;
+}
+
+void Gears::DeletionQueue::RetireBuffer(VkBuffer buffer, const Allocation& memory, uint64_t value)
+{
+	RetiredResource resource{ RetiredKind::Buffer, value, memory };
+	resource.Buffer = buffer;
+	Push(resource);
+}
+
+void Gears::DeletionQueue::RetireImage(VkImage image, const Allocation& memory, uint64_t value)
+{
+	RetiredResource resource{ RetiredKind::Image, value, memory };
+	resource.Image = image;
+	Push(resource);
+}
+
+void Gears::DeletionQueue::RetireImageView(VkImageView view, uint64_t value)
+{
+	RetiredResource resource{ RetiredKind::ImageView, value, {} };
+	resource.ImageView = view;
+	Push(resource);
+}
+
+void Gears::DeletionQueue::RetireSampler(VkSampler sampler, uint64_t value)
+{
+	RetiredResource resource{ RetiredKind::Sampler, value, {} };
+	resource.Sampler = sampler;
+	Push(resource);
+}
+
+void Gears::DeletionQueue::RetirePipeline(VkPipeline pipeline, uint64_t value)
+{
+	RetiredResource resource{ RetiredKind::Pipeline, value, {} };
+	resource.Pipeline = pipeline;
+	Push(resource);
+}
+
+void Gears::DeletionQueue::RetirePipelineLayout(VkPipelineLayout layout, uint64_t value)
+{
+	RetiredResource resource{ RetiredKind::PipelineLayout, value, {} };
+	resource.PipelineLayout = layout;
+	Push(resource);
+}
+
+void Gears::DeletionQueue::RetireShaderModule(VkShaderModule module, uint64_t value)
+{
+	RetiredResource resource{ RetiredKind::ShaderModule, value, {} };
+	resource.ShaderModule = module;
+	Push(resource);
+}
+
+void Gears::DeletionQueue::RetireMemory(const Allocation& memory, uint64_t value)
+{
+	RetiredResource resource{ RetiredKind::Memory, value, memory };
+	resource.Buffer = VK_NULL_HANDLE;
+	Push(resource);
+}
+
+size_t Gears::DeletionQueue::Collect(uint64_t completed)
+{
+	std::vector<RetiredResource> ready;
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+
+		// Ascending values make this a scan of the front only, cheap enough for every frame
+		while (!m_Pending.empty() && m_Pending.front().Value <= completed)
+		{
+			ready.push_back(m_Pending.front());
+			m_Pending.pop_front();
+		}
+	}
+
+	// Destroyed outside the lock so retiring threads never wait on the driver
+	for (const auto& i : ready)
+		Release(i);
+
+	return ready.size();
+}
+
+size_t Gears::DeletionQueue::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Pending.size();
+}
+
+void Gears::DeletionQueue::Push(RetiredResource resource)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (!m_Pending.empty() && resource.Value < m_Pending.back().Value)
+		resource.Value = m_Pending.back().Value;
+
+	m_Pending.push_back(resource);
+}
+
+void Gears::DeletionQueue::Release(const RetiredResource& resource)
+{
+	switch (resource.Kind)
+	{
+		case RetiredKind::Buffer:         vkDestroyBuffer(m_Device, resource.Buffer, m_AllocationCallbacks); break;
+		case RetiredKind::Image:          vkDestroyImage(m_Device, resource.Image, m_AllocationCallbacks); break;
+		case RetiredKind::ImageView:      vkDestroyImageView(m_Device, resource.ImageView, m_AllocationCallbacks); break;
+		case RetiredKind::Sampler:        vkDestroySampler(m_Device, resource.Sampler, m_AllocationCallbacks); break;
+		case RetiredKind::Pipeline:       vkDestroyPipeline(m_Device, resource.Pipeline, m_AllocationCallbacks); break;
+		case RetiredKind::PipelineLayout: vkDestroyPipelineLayout(m_Device, resource.PipelineLayout, m_AllocationCallbacks); break;
+		case RetiredKind::ShaderModule:   vkDestroyShaderModule(m_Device, resource.ShaderModule, m_AllocationCallbacks); break;
+		case RetiredKind::Memory:         break;
+	}
+
+	// The resource goes first, memory must not be freed while still bound
+	if (resource.Memory.Memory != VK_NULL_HANDLE && m_Allocator)
+		m_Allocator->Free(resource.Memory);
+}
@@ -0,0 +1,93 @@
+#include "device_selection.h"
+
+#include <cstring>
+
+Gears::DeviceScore Gears::ScoreDevice(const DeviceCandidate& candidate, const std::vector<const char*>& requiredExtensions)
+{
+	DeviceScore score{};
+
+	for (const char* required : requiredExtensions)
+	{
+		bool found = false;
+
+		for (const auto& extension : candidate.Extensions)
+			found = found || extension == required;
+
+		if (!found)
+		{
+			score.Reason = "missing required extension";
+			return score;
+		}
+	}
+
+	bool graphics = false;
+	bool asyncCompute = false;
+	bool dedicatedTransfer = false;
+
+	for (const auto& queue : candidate.Queues)
+	{
+		if (queue.queueCount == 0)
+			continue;
+
+		graphics = graphics || (queue.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+		asyncCompute = asyncCompute || ((queue.queueFlags & VK_QUEUE_COMPUTE_BIT) && !(queue.queueFlags & VK_QUEUE_GRAPHICS_BIT));
+		dedicatedTransfer = dedicatedTransfer || ((queue.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queue.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)));
+	}
+
+	if (!graphics)
+	{
+		score.Reason = "no graphics queue";
+		return score;
+	}
+
+	score.Suitable = true;
+
+	// Type dominates: a software rasterizer must never outscore real hardware on memory or limits alone
+	switch (candidate.Properties.deviceType)
+	{
+		case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   score.Score += 10000; break;
+		case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: score.Score += 5000; break;
+		case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    score.Score += 2000; break;
+		case VK_PHYSICAL_DEVICE_TYPE_CPU:            score.Score += 0; break;
+		default:                                     score.Score += 1000; break;
+	}
+
+	if (asyncCompute) score.Score += 200;
+	if (dedicatedTransfer) score.Score += 200;
+
+	// One point per 64MB of device-local memory, capped so heap size only breaks ties within a type
+	uint64_t deviceLocal = 0;
+
+	for (uint32_t i = 0; i < candidate.Memory.memoryHeapCount; ++i)
+		if (candidate.Memory.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+			deviceLocal += candidate.Memory.memoryHeaps[i].size;
+
+	uint64_t memoryScore = deviceLocal >> 26;
+	score.Score += static_cast<int64_t>(memoryScore < 2000 ? memoryScore : 2000);
+
+	score.Score += candidate.Properties.limits.maxImageDimension2D / 1024;
+	score.Score += candidate.Properties.limits.maxColorAttachments;
+
+	return score;
+}
+
+uint32_t Gears::SelectDevice(const std::vector<DeviceScore>& scores, int32_t overrideIndex)
+{
+	for (const auto& score : scores)
+		if (overrideIndex >= 0 && score.Index == static_cast<uint32_t>(overrideIndex) && score.Suitable)
+			return score.Index;
+
+	uint32_t best = UINT32_MAX;
+	int64_t bestScore = 0;
+
+	for (const auto& score : scores)
+	{
+		if (score.Suitable && (best == UINT32_MAX || score.Score > bestScore))
+		{
+			best = score.Index;
+			bestScore = score.Score;
+		}
+	}
+
+	return best;
+}
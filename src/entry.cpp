@@ -1,30 +1,153 @@
+#include <memory>
 #include <android_native_app_glue.h>
 
 #include "Logger.h"
+#include "app_lifecycle.h"
+#include "async_init.h"
 #include "graphics.h"
+#include "android_platform.h"
+#include "job_system.h"
+#include "profiler.h"
+
+struct AndroidAppState {
+    Gears::AppLifecycle                     Lifecycle;
+    Gears::JobSystem                        Jobs;
+    std::unique_ptr<Gears::AndroidPlatform> Platform;
+    std::unique_ptr<Gears::Graphics>        Graphics;
+    Gears::StartupProgress                  Progress;
+    Gears::AsyncInit<Gears::Graphics>       GraphicsInit; // Joined before Graphics and Platform go away
+    const char*                             LoggedStep = nullptr;
+};
+
+// Dispatches through the glue, which ends up in handle_cmd_callback
+class AndroidLooper final : public Gears::Looper
+{
+    public:
+
+    explicit AndroidLooper(android_app* app) : m_App( app ) {}
+
+    bool PollOnce(int timeoutMs) override
+    {
+        android_poll_source* pollSource = nullptr;
+        int events;
+
+        if (ALooper_pollAll(timeoutMs, nullptr, &events, reinterpret_cast<void**>(&pollSource)) < 0)
+            return false;
+
+        if (pollSource != nullptr)
+            pollSource->process(m_App, pollSource);
+
+        return true;
+    }
+
+    private:
+
+    android_app* m_App;
+};
+
+// Hands the device over once the worker is done, binding it to the window if one is up
+static void PollGraphicsInit(AndroidAppState& appState)
+{
+    if (appState.GraphicsInit.IsRunning())
+    {
+        // Stand-in for a loading screen until something can be drawn
+        const char* step = appState.Progress.Step.load(std::memory_order_relaxed);
+
+        if (step != appState.LoggedStep)
+        {
+            LOGI("Loading Vulkan: %s (%u steps done)", step, appState.Progress.Completed.load(std::memory_order_relaxed));
+            appState.LoggedStep = step;
+        }
+
+        return;
+    }
+
+    if (appState.GraphicsInit.GetState() == Gears::InitState::Idle)
+        return;
+
+    appState.Graphics = appState.GraphicsInit.Take();
+
+    // Retried on the next window
+    if (!appState.Graphics)
+    {
+        LOGE("GearsError::Vulkan initialization failed");
+        return;
+    }
+
+    if (appState.Lifecycle.HasWindow())
+        appState.Graphics->AttachWindow();
+
+    appState.Graphics->GetStartupTimeline().LogSummary();
+}
 
 // -------- Refactor ----------
 
 static void handle_cmd_callback(struct android_app* app, int32_t cmd)
 {
+    auto* appState = static_cast<AndroidAppState*>(app->userData);
+
     switch (cmd)
     {
-        case APP_CMD_INIT_WINDOW: { LOGI("Creating Vulkan"); Gears::Graphics g{ app }; break; }
-        case APP_CMD_START:   break;
-        case APP_CMD_RESUME:  break;
-        case APP_CMD_PAUSE:   break;
-        case APP_CMD_STOP:    break;
-        case APP_CMD_DESTROY: break;
+        case APP_CMD_INIT_WINDOW:
+        {
+            appState->Lifecycle.OnEvent(Gears::LifecycleEvent::WindowCreated);
+
+            // Instance, device and caches survive the window, only the first one pays for them
+            if (appState->Graphics)
+            {
+                appState->Graphics->AttachWindow();
+                break;
+            }
+
+            // Driver init can take long enough to trip an ANR, so it leaves this thread.
+            // The window is bound once the device is ready, see PollGraphicsInit.
+            if (appState->GraphicsInit.GetState() == Gears::InitState::Idle)
+            {
+                LOGI("Creating Vulkan");
+                appState->Platform = std::make_unique<Gears::AndroidPlatform>(app);
+
+                Gears::GraphicsConfig config{};
+                config.Jobs = &appState->Jobs;
+                config.Progress = &appState->Progress;
+
+                Gears::Platform* platform = appState->Platform.get();
+
+                appState->GraphicsInit.Start([platform, config]() {
+                    auto graphics = std::make_unique<Gears::Graphics>(*platform, config);
+                    return graphics->IsValid() ? std::move(graphics) : nullptr;
+                });
+            }
+            break;
+        }
+        case APP_CMD_TERM_WINDOW:
+        {
+            // The surface must be gone before this callback returns and the window is released
+            if (appState->Graphics) appState->Graphics->DetachWindow();
+            appState->Lifecycle.OnEvent(Gears::LifecycleEvent::WindowDestroyed);
+            break;
+        }
+        case APP_CMD_WINDOW_RESIZED:
+        case APP_CMD_CONFIG_CHANGED:
+        {
+            // Rotation changes the surface transform before any present reports it
+            if (appState->Graphics) appState->Graphics->OnWindowResized();
+            break;
+        }
+        case APP_CMD_START:   appState->Lifecycle.OnEvent(Gears::LifecycleEvent::Start); break;
+        case APP_CMD_RESUME:  appState->Lifecycle.OnEvent(Gears::LifecycleEvent::Resume); break;
+        case APP_CMD_PAUSE:
+        {
+            appState->Lifecycle.OnEvent(Gears::LifecycleEvent::Pause);
+            if (appState->Graphics) appState->Graphics->SavePipelineCache();
+            break;
+        }
+        case APP_CMD_STOP:    appState->Lifecycle.OnEvent(Gears::LifecycleEvent::Stop); break;
+        case APP_CMD_DESTROY: appState->Lifecycle.OnEvent(Gears::LifecycleEvent::Destroy); break;
     }
 }
 
 // ----------------------------
 
-struct AndroidAppState {
-    ANativeWindow* NativeWindow = nullptr;
-    bool Resumed = false;
-};
-
 // This is the entry point of the app
 void android_main(struct android_app* app) 
 {
@@ -33,24 +156,23 @@ void android_main(struct android_app* app)
     app->userData = &appState;
     app->onAppCmd = handle_cmd_callback;
 
-    while (app->destroyRequested == 0)
-    {
-        while (1)
-        {
-            struct    android_poll_source* pollSource;
-            int       events;
-            const int timeoutMilliseconds =
-                (!appState.Resumed && app->destroyRequested == 0) ? -1 : 0;
+    AndroidLooper looper{ app };
 
-            if (ALooper_pollAll(timeoutMilliseconds, nullptr, &events, (void**)&pollSource) < 0)
-            {
-                break;
-            }
+    // Sleeps in the looper whenever no frame comes out, so a paused app, a
+    // failed init or a window that could not be attached costs no wakeups
+    Gears::RunEventLoop(looper, appState.Lifecycle, [&appState]() {
+        if (!appState.Graphics)
+            PollGraphicsInit(appState);
 
-            if(pollSource != nullptr)
-                pollSource->process(app, pollSource);
+        if (appState.Lifecycle.ShouldRender() && appState.Graphics)
+        {
+            // Profile builds also show up in Perfetto and systrace through ATrace
+            GEARS_PROFILE_FRAME();
 
-            
+            if (appState.Graphics->RenderFrame())
+                return Gears::StepResult::Rendered;
         }
-    }
-}
\ No newline at end of file
+
+        return appState.GraphicsInit.IsRunning() ? Gears::StepResult::Pending : Gears::StepResult::Idle;
+    });
+}
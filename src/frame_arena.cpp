@@ -0,0 +1,19 @@
+#include "frame_arena.h"
+
+void Gears::FrameArena::Reserve(size_t size)
+{
+	m_Storage.resize(size);
+	m_Offset = 0;
+}
+
+// Returns nullptr when the slot's budget is exhausted, callers fall back or skip the work
+void* Gears::FrameArena::Allocate(size_t size, size_t alignment)
+{
+	size_t offset = (m_Offset + alignment - 1) & ~(alignment - 1);
+
+	if (offset + size > m_Storage.size())
+		return nullptr;
+
+	m_Offset = offset + size;
+	return m_Storage.data() + offset;
+}
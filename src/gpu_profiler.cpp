@@ -0,0 +1,170 @@
+#include "gpu_profiler.h"
+#include "profiler.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+uint64_t Gears::TimestampDeltaNs(uint64_t begin, uint64_t end, uint32_t validBits, float timestampPeriod)
+{
+	const uint64_t mask = validBits >= 64 ? UINT64_MAX : (uint64_t(1) << validBits) - 1;
+	return static_cast<uint64_t>(static_cast<double>((end - begin) & mask) * timestampPeriod);
+}
+
+Gears::GpuProfiler::~GpuProfiler()
+{
+	if (!m_Slots.empty())
+		LOGE("GearsError::GPU profiler destroyed with %zu query pools alive", m_Slots.size());
+}
+
+bool Gears::GpuProfiler::Init(VkDevice device, uint32_t frameSlots, uint32_t maxZones, float timestampPeriod, uint32_t validBits,
+	const VkAllocationCallbacks* callbacks)
+{
+	if (validBits == 0 || timestampPeriod <= 0.0f || maxZones == 0)
+	{
+		LOGW("GPU timestamps are not supported on the graphics queue, GPU zones are disabled");
+		return false;
+	}
+
+	m_Device = device;
+	m_AllocationCallbacks = callbacks;
+	m_MaxZones = maxZones;
+	m_ValidBits = validBits;
+	m_TimestampPeriod = timestampPeriod;
+	m_Slots = std::vector<Slot>(frameSlots);
+	m_Results.resize(maxZones * 2);
+
+	// Every zone takes a begin and an end query
+	VkQueryPoolCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	createInfo.queryCount = maxZones * 2;
+
+	for (auto& slot : m_Slots)
+	{
+		slot.Names.resize(maxZones);
+
+		if (vkCreateQueryPool(m_Device, &createInfo, m_AllocationCallbacks, &slot.Pool) != VK_SUCCESS)
+		{
+			LOGE("GearsError::Failed to create timestamp query pool");
+			Destroy();
+			return false;
+		}
+	}
+
+	LOGI("GPU zones: %u per frame, %.3f ns per tick", maxZones, timestampPeriod);
+	return true;
+}
+
+void Gears::GpuProfiler::Destroy()
+{
+	for (auto& slot : m_Slots)
+		if (slot.Pool != VK_NULL_HANDLE)
+			vkDestroyQueryPool(m_Device, slot.Pool, m_AllocationCallbacks);
+
+	m_Slots.clear();
+	m_InFrame = false;
+}
+
+void Gears::GpuProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint64_t frameIndex)
+{
+	if (m_Slots.empty())
+		return;
+
+	m_Current = static_cast<uint32_t>(frameIndex % m_Slots.size());
+	Slot& slot = m_Slots[m_Current];
+
+	if (slot.Submitted)
+		Resolve(slot);
+
+	slot.Used.store(0, std::memory_order_relaxed);
+	slot.FrameIndex = frameIndex;
+	slot.Submitted = false;
+
+	vkCmdResetQueryPool(commandBuffer, slot.Pool, 0, m_MaxZones * 2);
+
+	m_InFrame = true;
+	m_FrameZone = BeginZone(commandBuffer, "GpuFrame");
+}
+
+void Gears::GpuProfiler::EndFrame(VkCommandBuffer commandBuffer)
+{
+	if (!m_InFrame)
+		return;
+
+	EndZone(commandBuffer, m_FrameZone);
+	m_InFrame = false;
+}
+
+void Gears::GpuProfiler::MarkSubmitted()
+{
+	if (m_Slots.empty())
+		return;
+
+	// The GPU cannot start before the submission, so its zones are placed
+	// from here: a lower bound, queueing on the GPU shifts them later still
+	Slot& slot = m_Slots[m_Current];
+	slot.SubmitNs = ProfileNow();
+	slot.Submitted = true;
+}
+
+uint32_t Gears::GpuProfiler::BeginZone(VkCommandBuffer commandBuffer, const char* name)
+{
+	if (!m_InFrame)
+		return GPU_ZONE_NONE;
+
+	Slot& slot = m_Slots[m_Current];
+	uint32_t zone = slot.Used.fetch_add(1, std::memory_order_relaxed);
+
+	// Out of queries, the zone goes untimed rather than growing the pool mid-frame
+	if (zone >= m_MaxZones)
+		return GPU_ZONE_NONE;
+
+	slot.Names[zone] = name;
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, slot.Pool, zone * 2);
+	return zone;
+}
+
+void Gears::GpuProfiler::EndZone(VkCommandBuffer commandBuffer, uint32_t zone)
+{
+	if (zone == GPU_ZONE_NONE)
+		return;
+
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_Slots[m_Current].Pool, zone * 2 + 1);
+}
+
+void Gears::GpuProfiler::Resolve(Slot& slot)
+{
+	const uint32_t used = std::min(slot.Used.load(std::memory_order_relaxed), m_MaxZones);
+
+	if (used == 0)
+		return;
+
+	// No wait flag, the slot's fence already guarantees the results are written
+	VkResult result = vkGetQueryPoolResults(m_Device, slot.Pool, 0, used * 2,
+		used * 2 * sizeof(uint64_t), m_Results.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+	if (result != VK_SUCCESS)
+	{
+		LOGW("GPU timestamps for frame %" PRIu64 " not available: %d", slot.FrameIndex, result);
+		return;
+	}
+
+	const uint64_t frameBegin = m_Results[0];
+	m_Timings.clear();
+
+	for (uint32_t i = 0; i < used; ++i)
+	{
+		GpuZoneTiming timing;
+		timing.Name = slot.Names[i];
+		timing.StartNs = TimestampDeltaNs(frameBegin, m_Results[i * 2], m_ValidBits, m_TimestampPeriod);
+		timing.DurationNs = TimestampDeltaNs(m_Results[i * 2], m_Results[i * 2 + 1], m_ValidBits, m_TimestampPeriod);
+		m_Timings.push_back(timing);
+
+#if GEARS_PROFILER_ENABLED
+		ProfileGpuZone(timing.Name, slot.SubmitNs + timing.StartNs, static_cast<int64_t>(timing.DurationNs));
+#endif
+	}
+
+	m_LastFrameIndex = slot.FrameIndex;
+}
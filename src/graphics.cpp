@@ -1,229 +1,1083 @@
 // Refactor to header
 
 #include "graphics.h"
+#include "capability_snapshot.h"
+#include "debug_report.h"
+#include "device_selection.h"
+#include "job_system.h"
+#include "profiler.h"
+#include "startup_timeline.h"
+#include "vk_loader.h"
 #include "Logger.h"
 
-#include <vulkan/vulkan.h>
-#include <vulkan/vulkan_android.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <type_traits>
 
-#define VK_CALL(x) if(x != VK_SUCCESS) { LOGI("GearsError::Vulkan error occured at line: %d", __LINE__); return; }
+// Devices lacking any of these are never selected
+static const std::vector<const char*> s_RequiredDeviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 
-Gears::Graphics::Graphics( android_app* app ) :
-	m_androidApp( *app )
+static const char* VALIDATION_LAYER_NAME = "VK_LAYER_KHRONOS_validation";
+
+static bool Contains(const std::vector<std::string>& names, const char* name)
+{
+	for (const auto& i : names)
+		if (i == name)
+			return true;
+
+	return false;
+}
+
+// Names the commands up to the matching end for capture tools such as
+// RenderDoc or AGI. Loaded only with VK_EXT_debug_utils, see CreateInstance.
+static void BeginDebugLabel(bool enabled, VkCommandBuffer commandBuffer, const char* name)
+{
+	if (!enabled || vkCmdBeginDebugUtilsLabelEXT == nullptr || vkCmdEndDebugUtilsLabelEXT == nullptr)
+		return;
+
+	VkDebugUtilsLabelEXT label{};
+	label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+	label.pLabelName = name;
+
+	vkCmdBeginDebugUtilsLabelEXT(commandBuffer, &label);
+}
+
+static void EndDebugLabel(bool enabled, VkCommandBuffer commandBuffer)
+{
+	if (!enabled || vkCmdBeginDebugUtilsLabelEXT == nullptr || vkCmdEndDebugUtilsLabelEXT == nullptr)
+		return;
+
+	vkCmdEndDebugUtilsLabelEXT(commandBuffer);
+}
+
+#define VK_CALL_OR(x, result) if(x != VK_SUCCESS) { LOGE("GearsError::Vulkan error occured at line: %d", __LINE__); return result; }
+#define VK_CALL(x) VK_CALL_OR(x, )
+
+// Runs one init step under its own name in the startup timeline and, in profile builds, the profiler.
+// Returns false from the caller when the step fails.
+#define STARTUP_STEP(step) { StartupTimeline::Scope scope{ m_StartupTimeline, #step }; GEARS_PROFILE_ZONE(#step); if (!step()) return false; }
+
+Gears::Graphics::Graphics( Platform& platform, const GraphicsConfig& config ) :
+	m_Platform( &platform ),
+	m_Config( config )
+{
+	// Every frame records into a slot of its own, RenderFrame indexes them modulo this
+	if (m_Config.FramesInFlight == 0)
+	{
+		LOGW("GearsWarning::FramesInFlight of 0 raised to 1");
+		m_Config.FramesInFlight = 1;
+	}
+
+	m_StartupTimeline.SetProgress(m_Config.Progress);
+
+	// Set before the instance exists, everything is created and destroyed with the same callbacks
+	if (m_Config.TrackHostMemory)
+	{
+		m_HostAllocator.Init(m_Config.HostPoolSize);
+		m_AllocationCallbacks = m_HostAllocator.GetCallbacks();
+	}
+
+	{
+		StartupTimeline::Scope total{ m_StartupTimeline, "Graphics" };
+		GEARS_PROFILE_ZONE("Graphics");
+		m_Valid = CreateCore();
+	}
+
+	m_StartupTimeline.SetProgress(nullptr);
+}
+
+bool Gears::Graphics::CreateCore()
+{
+	bool cached;
+
+	{
+		StartupTimeline::Scope step{ m_StartupTimeline, "LoadVulkan" };
+		GEARS_PROFILE_ZONE("LoadVulkan");
+
+		if (!LoadVulkan())
+			return false;
+	}
+
+	{
+		StartupTimeline::Scope step{ m_StartupTimeline, "LoadCapabilitySnapshot" };
+		GEARS_PROFILE_ZONE("LoadCapabilitySnapshot");
+		cached = LoadCapabilitySnapshot();
+	}
+
+	if (!cached)
+	{
+		STARTUP_STEP(EnumerateLayerProperties);
+		STARTUP_STEP(EnumerateLayerExtensions);
+	}
+
+	bool created;
+
+	{
+		StartupTimeline::Scope step{ m_StartupTimeline, "CreateInstance" };
+		GEARS_PROFILE_ZONE("CreateInstance");
+		created = CreateInstance();
+	}
+
+	// A layer or extension removed since the snapshot was taken fails instance creation
+	if (!created)
+	{
+		if (!m_CapabilitiesCached)
+			return false;
+
+		LOGW("GearsWarning::Instance creation failed with cached capabilities, probing again");
+
+		m_CapabilitiesCached = false;
+		m_LayerPropertyNames.clear();
+		m_LayerExtensionNames.clear();
+
+		STARTUP_STEP(EnumerateLayerProperties);
+		STARTUP_STEP(EnumerateLayerExtensions);
+		STARTUP_STEP(CreateInstance);
+	}
+
+	// Each step below needs the ones before it. Stopping early leaves
+	// IsValid false and the destructor frees whatever was created.
+	STARTUP_STEP(EnumeratePhysicalDevices);
+	STARTUP_STEP(SetupDebugCallbacks);
+
+	{
+		StartupTimeline::Scope step{ m_StartupTimeline, "CreateLogicalDevice" };
+		GEARS_PROFILE_ZONE("CreateLogicalDevice");
+		auto queueInfos = SetupDeviceQueues();
+
+		if (queueInfos.empty() || !CreateLogicalDevice(queueInfos))
+			return false;
+	}
+
+	STARTUP_STEP(SaveCapabilitySnapshot);
+	STARTUP_STEP(CreatePipelineCache);
+	STARTUP_STEP(CreateMemoryAllocator);
+	STARTUP_STEP(CreateStaging);
+	STARTUP_STEP(CreateCommandBufferPool);
+	STARTUP_STEP(CreateSyncObjects);
+	STARTUP_STEP(CreateGpuProfiler);
+
+	return true;
+}
+
+Gears::Graphics::~Graphics()
+{
+	if (m_Device != VK_NULL_HANDLE)
+	{
+		// Teardown is rare, a full idle beats tracking every object's last use
+		vkDeviceWaitIdle(m_Device);
+
+		m_Window.Destroy();
+		m_DeletionQueue.Flush();
+		m_Staging.Destroy();
+		m_GpuProfiler.Destroy();
+
+		for (auto& frame : m_Frames)
+		{
+			for (auto& thread : frame.Threads)
+				vkDestroyCommandPool(m_Device, thread.CommandPool, m_AllocationCallbacks);
+
+			vkDestroyCommandPool(m_Device, frame.CommandPool, m_AllocationCallbacks);
+			vkDestroyFence(m_Device, frame.InFlightFence, m_AllocationCallbacks);
+			vkDestroySemaphore(m_Device, frame.ImageAvailable, m_AllocationCallbacks);
+			vkDestroySemaphore(m_Device, frame.RenderFinished, m_AllocationCallbacks);
+		}
+
+		m_PipelineCache.Destroy();
+		m_MemoryAllocator.Destroy();
+
+		vkDestroyDevice(m_Device, m_AllocationCallbacks);
+	}
+
+	if (m_VkInstance != VK_NULL_HANDLE)
+	{
+		if (m_DebugCallback != VK_NULL_HANDLE)
+		{
+			PFN_vkDestroyDebugReportCallbackEXT vkDestroyDebugReportCallbackEXT =
+				reinterpret_cast<PFN_vkDestroyDebugReportCallbackEXT>
+				(vkGetInstanceProcAddr(m_VkInstance, "vkDestroyDebugReportCallbackEXT"));
+
+			vkDestroyDebugReportCallbackEXT(m_VkInstance, m_DebugCallback, m_AllocationCallbacks);
+		}
+
+		vkDestroyInstance(m_VkInstance, m_AllocationCallbacks);
+	}
+}
+
+bool Gears::Graphics::AttachWindow()
+{
+	if (!m_Valid)
+		return false;
+
+	StartupTimeline::Scope step{ m_StartupTimeline, "AttachWindow" };
+	GEARS_PROFILE_ZONE("AttachWindow");
+	auto start = StartupTimeline::Clock::now();
+
+	if (!m_Window.Create(m_VkInstance, m_PhysicalDevice, m_Device, m_GraphicsSelection.Family, *m_Platform, m_Config.Present, m_AllocationCallbacks))
+	{
+		m_Window.Destroy();
+		return false;
+	}
+
+	// On resume this is all the work between getting a window and the first frame
+	m_AttachMs = std::chrono::duration<double, std::milli>(StartupTimeline::Clock::now() - start).count();
+	LOGI("Window attached in %.3f ms", m_AttachMs);
+
+	return true;
+}
+
+void Gears::Graphics::DetachWindow()
+{
+	if (m_Device == VK_NULL_HANDLE)
+		return;
+
+	// Frames still presenting to the window have to finish before it goes away
+	vkDeviceWaitIdle(m_Device);
+	m_Window.Destroy();
+}
+
+bool Gears::Graphics::RenderFrame()
+{
+	GEARS_PROFILE_ZONE("RenderFrame");
+
+	if (m_Lost)
+		return false;
+
+	// Stays dirty while the window is minimized, nothing is rendered until it has an area again
+	if (m_Window.IsDirty() && !m_Window.Recreate(m_FrameIndex))
+		return false;
+
+	if (!m_Window.IsValid())
+		return false;
+
+	auto& frame = m_Frames[m_FrameIndex % m_Frames.size()];
+
+	// Only blocks if the GPU is still N frames behind on this slot
+	{
+		GEARS_PROFILE_ZONE("WaitForFrame");
+		VK_CALL_OR(vkWaitForFences(m_Device, 1, &frame.InFlightFence, VK_TRUE, UINT64_MAX), false);
+	}
+
+	// Fences are waited in submission order, so with this slot free every
+	// frame before m_FrameIndex - FramesInFlight + 1 has completed
+	const uint64_t framesInFlight = m_Frames.size();
+	const uint64_t completedFrames = m_FrameIndex + 1 >= framesInFlight ? m_FrameIndex + 1 - framesInFlight : 0;
+
+	m_Window.DestroyRetired(completedFrames);
+	m_DeletionQueue.Collect(completedFrames);
+
+	VkSwapchainKHR swapchain = m_Window.GetSwapchain();
+
+	uint32_t imageIndex;
+	VkResult acquired = vkAcquireNextImageKHR(m_Device, swapchain, UINT64_MAX, frame.ImageAvailable, VK_NULL_HANDLE, &imageIndex);
+
+	// Nothing was signaled or reset yet, so the frame can simply be skipped,
+	// the next call rebuilds the swapchain without waiting for an event
+	if (acquired == VK_ERROR_OUT_OF_DATE_KHR)
+	{
+		m_Window.MarkDirty();
+		return true;
+	}
+
+	if (acquired != VK_SUCCESS && acquired != VK_SUBOPTIMAL_KHR)
+	{
+		LOGE("GearsError::Failed to acquire a swapchain image: %d", acquired);
+		return false;
+	}
+
+	// Still presentable, finish this frame and rebuild before the next one
+	if (acquired == VK_SUBOPTIMAL_KHR)
+		m_Window.MarkDirty();
+
+	// ImageAvailable is now signaled and the fence still is, every way out
+	// from here has to submit so the next wait on this slot can return
+	bool recorded = vkResetCommandPool(m_Device, frame.CommandPool, 0) == VK_SUCCESS;
+
+	for (auto& thread : frame.Threads)
+	{
+		recorded = recorded && vkResetCommandPool(m_Device, thread.CommandPool, 0) == VK_SUCCESS;
+		thread.UsedBuffers = 0;
+	}
+
+	frame.Arena.Reset();
+
+	// Uploads retired here get their ownership acquired at the top of this frame
+	m_Staging.Reclaim();
+	m_Staging.Flush();
+
+	recorded = recorded && RecordFrame(frame, imageIndex);
+
+	if (!recorded)
+	{
+		LOGE("GearsError::Failed to record frame %llu, skipping it", static_cast<unsigned long long>(m_FrameIndex));
+		SkipFrame(frame);
+		return !m_Lost;
+	}
+
+	GEARS_PROFILE_COUNTER("StagingBytes", m_Staging.GetUsedBytes());
+	GEARS_PROFILE_COUNTER("DeletionQueue", m_DeletionQueue.GetPendingCount());
+	GEARS_PROFILE_COUNTER("DriverHostBytes", m_HostAllocator.GetTotal().LiveBytes);
+
+	const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.pWaitSemaphores = &frame.ImageAvailable;
+	submitInfo.pWaitDstStageMask = &waitStage;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &frame.CommandBuffer;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &frame.RenderFinished;
+
+	VkResult submitted;
+
+	{
+		GEARS_PROFILE_ZONE("Submit");
+		std::lock_guard<std::mutex> lock(m_GraphicsQueueMutex);
+
+		// Reset only now, so a failure above leaves the fence signaled
+		submitted = vkResetFences(m_Device, 1, &frame.InFlightFence);
+
+		if (submitted == VK_SUCCESS)
+			submitted = vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, frame.InFlightFence);
+	}
+
+	if (submitted != VK_SUCCESS)
+	{
+		LOGE("GearsError::Failed to submit frame %llu: %d", static_cast<unsigned long long>(m_FrameIndex), submitted);
+		SkipFrame(frame);
+		return !m_Lost;
+	}
+
+	m_GpuProfiler.MarkSubmitted();
+
+	VkPresentInfoKHR presentInfo{};
+	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+	presentInfo.waitSemaphoreCount = 1;
+	presentInfo.pWaitSemaphores = &frame.RenderFinished;
+	presentInfo.swapchainCount = 1;
+	presentInfo.pSwapchains = &swapchain;
+	presentInfo.pImageIndices = &imageIndex;
+
+	++m_FrameIndex;
+
+	if (m_DebugReportEnabled)
+	{
+		m_DebugReport.EndFrame();
+		m_DebugReport.Tick();
+	}
+
+	VkResult presented;
+
+	{
+		GEARS_PROFILE_ZONE("Present");
+		std::lock_guard<std::mutex> lock(m_GraphicsQueueMutex);
+		presented = vkQueuePresentKHR(m_GraphicsQueue, &presentInfo);
+	}
+
+	// Rotation and resize surface here first on most drivers
+	if (presented == VK_ERROR_OUT_OF_DATE_KHR || presented == VK_SUBOPTIMAL_KHR)
+		m_Window.MarkDirty();
+	else if (presented != VK_SUCCESS)
+		LOGE("GearsError::Failed to present: %d", presented);
+
+	return true;
+}
+
+// A failed submission leaves fence and semaphores as they were, so an empty
+// batch can still consume ImageAvailable and signal the fence. The acquired
+// image is never presented, rebuilding the swapchain hands it back.
+void Gears::Graphics::SkipFrame(FrameData& frame)
+{
+	const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.waitSemaphoreCount = 1;
+	submitInfo.pWaitSemaphores = &frame.ImageAvailable;
+	submitInfo.pWaitDstStageMask = &waitStage;
+
+	VkResult submitted;
+
+	{
+		std::lock_guard<std::mutex> lock(m_GraphicsQueueMutex);
+		submitted = vkResetFences(m_Device, 1, &frame.InFlightFence);
+
+		if (submitted == VK_SUCCESS)
+			submitted = vkQueueSubmit(m_GraphicsQueue, 1, &submitInfo, frame.InFlightFence);
+	}
+
+	m_Window.MarkDirty();
+
+	// Waiting on this slot again would never return
+	if (submitted != VK_SUCCESS)
+	{
+		LOGE("GearsError::Could not release frame slot: %d, rendering stops", submitted);
+		m_Lost = true;
+	}
+}
+
+bool Gears::Graphics::RecordFrame(FrameData& frame, uint32_t imageIndex)
+{
+	GEARS_PROFILE_ZONE("RecordFrame");
+
+	VkImage image = m_Window.GetImage(imageIndex);
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	VK_CALL_OR(vkBeginCommandBuffer(frame.CommandBuffer, &beginInfo), false);
+	BeginDebugLabel(m_DebugUtilsEnabled, frame.CommandBuffer, "Frame");
+
+	// Resolves this slot's previous frame too, its fence was just waited on
+	m_GpuProfiler.BeginFrame(frame.CommandBuffer, m_FrameIndex);
+
+	m_Staging.RecordAcquireBarriers(frame.CommandBuffer);
+
+	VkImageSubresourceRange range{};
+	range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	range.levelCount = 1;
+	range.layerCount = 1;
+
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange = range;
+
+	vkCmdPipelineBarrier(frame.CommandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	VkClearColorValue clearColor{};
+	clearColor.float32[0] = 0.1f;
+	clearColor.float32[1] = 0.1f;
+	clearColor.float32[2] = 0.1f;
+	clearColor.float32[3] = 1.0f;
+
+	{
+		GEARS_GPU_ZONE(m_GpuProfiler, frame.CommandBuffer, "Clear");
+		vkCmdClearColorImage(frame.CommandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &clearColor, 1, &range);
+	}
+
+	RecordPasses(frame, image);
+
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = 0;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+	vkCmdPipelineBarrier(frame.CommandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+		0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	m_GpuProfiler.EndFrame(frame.CommandBuffer);
+	EndDebugLabel(m_DebugUtilsEnabled, frame.CommandBuffer);
+
+	VK_CALL_OR(vkEndCommandBuffer(frame.CommandBuffer), false);
+	return true;
+}
+
+void Gears::Graphics::AddRecordPass(RecordPass pass, const char* name)
+{
+	m_RecordPasses.push_back(std::move(pass));
+	m_RecordPassNames.push_back(name);
+}
+
+void Gears::Graphics::RecordPasses(FrameData& frame, VkImage image)
 {
-	EnumerateLayerProperties();
-	EnumerateLayerExtensions();
-	CreateInstance();
-	EnumeratePhysicalDevices();	
-	EnumerateDeviceExtensions();
-	SetupDebugCallbacks();
+	const uint32_t passCount = static_cast<uint32_t>(m_RecordPasses.size());
+
+	if (passCount == 0)
+		return;
+
+	auto* secondaries = frame.Arena.AllocateArray<VkCommandBuffer>(passCount);
+
+	if (secondaries == nullptr)
+	{
+		LOGE("GearsError::Frame arena too small for %u record passes", passCount);
+		return;
+	}
+
+	auto recordRange = [&](uint32_t begin, uint32_t end)
+	{
+		// Everything in this range runs on one thread, so its pool needs no lock
+		auto& commands = frame.Threads[m_Config.Jobs ? JobSystem::GetThreadIndex() : 0];
+
+		VkCommandBufferInheritanceInfo inheritanceInfo{};
+		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			secondaries[i] = AcquireSecondaryBuffer(commands);
+
+			if (secondaries[i] == VK_NULL_HANDLE || vkBeginCommandBuffer(secondaries[i], &beginInfo) != VK_SUCCESS)
+			{
+				secondaries[i] = VK_NULL_HANDLE;
+				continue;
+			}
+
+			{
+				GEARS_PROFILE_ZONE("RecordPass");
+				GEARS_GPU_ZONE(m_GpuProfiler, secondaries[i], m_RecordPassNames[i]);
+				BeginDebugLabel(m_DebugUtilsEnabled, secondaries[i], m_RecordPassNames[i]);
+				m_RecordPasses[i]({ secondaries[i], image, m_FrameIndex, &m_GpuProfiler });
+				EndDebugLabel(m_DebugUtilsEnabled, secondaries[i]);
+			}
 
-	auto queueInfo = SetupDeviceQueues();
-	CreateLogicalDevice(queueInfo);
-	CreateCommandBufferPool();
-	CreateSurface(app->window);
-	CachePhysicalDeviceCapabilities();
-	CreateSwapChain();
+			if (vkEndCommandBuffer(secondaries[i]) != VK_SUCCESS)
+				secondaries[i] = VK_NULL_HANDLE;
+		}
+	};
+
+	if (m_Config.Jobs != nullptr)
+		m_Config.Jobs->ParallelFor(passCount, recordRange);
+	else
+		recordRange(0, passCount);
+
+	// Drop passes that failed to record, then stitch the rest in pass order
+	uint32_t recorded = 0;
+	for (uint32_t i = 0; i < passCount; ++i)
+		if (secondaries[i] != VK_NULL_HANDLE)
+			secondaries[recorded++] = secondaries[i];
+
+	if (recorded > 0)
+		vkCmdExecuteCommands(frame.CommandBuffer, recorded, secondaries);
+}
+
+VkCommandBuffer Gears::Graphics::AcquireSecondaryBuffer(ThreadCommands& commands)
+{
+	if (commands.UsedBuffers == commands.SecondaryBuffers.size())
+	{
+		VkCommandBufferAllocateInfo allocateInfo{};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocateInfo.commandBufferCount = 1;
+		allocateInfo.commandPool = commands.CommandPool;
+		allocateInfo.level = VkCommandBufferLevel::VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+
+		VkCommandBuffer buffer;
+
+		if (vkAllocateCommandBuffers(m_Device, &allocateInfo, &buffer) != VK_SUCCESS)
+		{
+			LOGE("GearsError::Failed to allocate secondary command buffer");
+			return VK_NULL_HANDLE;
+		}
+
+		commands.SecondaryBuffers.push_back(buffer);
+	}
+
+	return commands.SecondaryBuffers[commands.UsedBuffers++];
 }
 
-void Gears::Graphics::EnumerateLayerProperties()
+bool Gears::Graphics::EnumerateLayerProperties()
 {
+	// Release never loads a layer, so it skips asking the loader for them too
+	if (m_Config.Build != BuildConfig::Debug)
+		return true;
+
 	uint32_t count;
 
-	VK_CALL(vkEnumerateInstanceLayerProperties( &count, nullptr ));
+	VK_CALL_OR(vkEnumerateInstanceLayerProperties( &count, nullptr ), false);
 	auto layers = std::vector<VkLayerProperties> ( count );
-	VK_CALL(vkEnumerateInstanceLayerProperties( &count, layers.data() ));
+	VK_CALL_OR(vkEnumerateInstanceLayerProperties( &count, layers.data() ), false);
 
 	for (auto& i : layers)
 	{
 		m_LayerPropertyNames.push_back(i.layerName);
-		LOGI("Layer Name: %s", i.layerName);
+		LOGD("Layer Name: %s", i.layerName);
 	}
 
 	LOGI("Layers found: %d", count);
+
+	return true;
 }
 
-void Gears::Graphics::EnumerateLayerExtensions()
+bool Gears::Graphics::EnumerateLayerExtensions()
 {
 	uint32_t count;
 
-	VK_CALL(vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr));
+	VK_CALL_OR(vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr), false);
 	auto layers = std::vector<VkExtensionProperties> ( count );
-	VK_CALL(vkEnumerateInstanceExtensionProperties(nullptr, &count, layers.data()));
+	VK_CALL_OR(vkEnumerateInstanceExtensionProperties(nullptr, &count, layers.data()), false);
 
 	for (auto& i : layers)
 	{
 		m_LayerExtensionNames.push_back(i.extensionName);
-		LOGI("Extension Name: %s", i.extensionName);
+		LOGD("Extension Name: %s", i.extensionName);
 	}
 
-	LOGI("Instance extensions found: %d", count);
-}
-
-void Gears::Graphics::EnumerateDeviceExtensions()
-{
-	uint32_t count;
-	VK_CALL(vkEnumerateDeviceExtensionProperties(m_PhysicalDevices[0], nullptr, &count, nullptr));
-	auto extensions = std::vector<VkExtensionProperties>( count );
-	VK_CALL(vkEnumerateDeviceExtensionProperties(m_PhysicalDevices[0], nullptr, &count, extensions.data()));
-
-	for (auto& i : extensions)
+	// Debug extensions are often provided by the validation layer rather than the loader
+	if (Contains(m_LayerPropertyNames, VALIDATION_LAYER_NAME))
 	{
-		m_DeviceExtensionNames.push_back(i.extensionName);
-		LOGI("Extension Name: %s", i.extensionName);
+		VK_CALL_OR(vkEnumerateInstanceExtensionProperties(VALIDATION_LAYER_NAME, &count, nullptr), false);
+		layers = std::vector<VkExtensionProperties>(count);
+		VK_CALL_OR(vkEnumerateInstanceExtensionProperties(VALIDATION_LAYER_NAME, &count, layers.data()), false);
+
+		for (auto& i : layers)
+			if (!Contains(m_LayerExtensionNames, i.extensionName))
+				m_LayerExtensionNames.push_back(i.extensionName);
 	}
 
-	LOGI("Device extensions found: %d", count);
+	LOGI("Instance extensions found: %zu", m_LayerExtensionNames.size());
+
+	return true;
 }
 
-void Gears::Graphics::EnumeratePhysicalDevices()
+bool Gears::Graphics::EnumeratePhysicalDevices()
 {
 	uint32_t count;
 
-	VK_CALL(vkEnumeratePhysicalDevices(m_VkInstance, &count, nullptr));
+	VK_CALL_OR(vkEnumeratePhysicalDevices(m_VkInstance, &count, nullptr), false);
 	m_PhysicalDevices = std::vector<VkPhysicalDevice>(count);
-	VK_CALL(vkEnumeratePhysicalDevices(m_VkInstance, &count, m_PhysicalDevices.data()));
+	VK_CALL_OR(vkEnumeratePhysicalDevices(m_VkInstance, &count, m_PhysicalDevices.data()), false);
 
 	if (count == 0)
 	{
-		LOGI("No physical devices found on this system.");
-		return;
+		LOGE("No physical devices found on this system.");
+		return false;
+	}
+
+	// Properties are cheap and carry the driver identity the snapshot is keyed on
+	std::vector<VkPhysicalDeviceProperties> properties(count);
+
+	for (uint32_t i = 0; i < count; ++i)
+		vkGetPhysicalDeviceProperties(m_PhysicalDevices[i], &properties[i]);
+
+	if (m_CapabilitiesCached && !MatchesDevices(m_Capabilities, properties))
+	{
+		LOGI("Devices or drivers changed since the capability snapshot, probing");
+		m_CapabilitiesCached = false;
+	}
+
+	if (!m_CapabilitiesCached)
+		ProbePhysicalDevices(properties);
+
+	if (m_Capabilities.Devices.size() != count)
+	{
+		LOGE("GearsError::Failed to probe physical devices");
+		return false;
+	}
+
+	m_DeviceScores.clear();
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const CachedDevice& device = m_Capabilities.Devices[i];
+
+		DeviceScore score;
+		score.Index = i;
+		score.Score = device.Score;
+		score.Suitable = device.Suitable;
+		score.Reason = device.Reason.c_str();
+		m_DeviceScores.push_back(score);
+
+		LOGI("Device %u: %s, type %u, score %lld%s%s", i, properties[i].deviceName, properties[i].deviceType,
+			static_cast<long long>(score.Score), score.Suitable ? "" : ", unsuitable: ", score.Reason);
+	}
+
+	int32_t overrideIndex = m_Config.DeviceIndex;
+
+	if (const char* env = getenv("GEARS_DEVICE_INDEX"))
+		overrideIndex = atoi(env);
+
+	uint32_t selected = SelectDevice(m_DeviceScores, overrideIndex);
+
+	if (selected == UINT32_MAX)
+	{
+		LOGE("GearsError::No suitable physical device found");
+		return false;
 	}
 
-	// Cache device properties of main device
-	vkGetPhysicalDeviceProperties(m_PhysicalDevices[0], &m_MainDeviceProperties);	
+	if (overrideIndex >= 0 && selected != static_cast<uint32_t>(overrideIndex))
+		LOGE("GearsError::Device override %d is not usable, falling back to scoring", overrideIndex);
+
+	m_PhysicalDevice = m_PhysicalDevices[selected];
+	m_MainDeviceProperties = properties[selected];
+	m_DeviceExtensionNames = m_Capabilities.Devices[selected].Extensions;
+	m_PhysicalQueueProperties = m_Capabilities.Devices[selected].Queues;
+
+	LOGI("Device extensions found: %zu", m_DeviceExtensionNames.size());
 
 	LOGI("Physical devices statistics:");
 	LOGI("Device Name: %s", m_MainDeviceProperties.deviceName);
 	LOGI("Device Type: %u", m_MainDeviceProperties.deviceType);
 	LOGI("Driver Version: %d", m_MainDeviceProperties.driverVersion);
+
+	return true;
 }
 
-VkDeviceQueueCreateInfo Gears::Graphics::SetupDeviceQueues()
+void Gears::Graphics::ProbePhysicalDevices(const std::vector<VkPhysicalDeviceProperties>& properties)
 {
-	uint32_t count;
-	const VkQueueFamilyProperties* selectedQueue = nullptr;
-	m_SelectedGraphicQueueIndex = 0;
+	m_Capabilities.Devices.clear();
+
+	for (uint32_t i = 0; i < m_PhysicalDevices.size(); ++i)
+	{
+		DeviceCandidate candidate;
+		candidate.Device = m_PhysicalDevices[i];
+		candidate.Properties = properties[i];
+
+		vkGetPhysicalDeviceMemoryProperties(candidate.Device, &candidate.Memory);
+
+		uint32_t queueCount;
+		vkGetPhysicalDeviceQueueFamilyProperties(candidate.Device, &queueCount, nullptr);
+		candidate.Queues = std::vector<VkQueueFamilyProperties>(queueCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(candidate.Device, &queueCount, candidate.Queues.data());
+
+		uint32_t extensionCount;
+		VK_CALL(vkEnumerateDeviceExtensionProperties(candidate.Device, nullptr, &extensionCount, nullptr));
+		auto extensions = std::vector<VkExtensionProperties>(extensionCount);
+		VK_CALL(vkEnumerateDeviceExtensionProperties(candidate.Device, nullptr, &extensionCount, extensions.data()));
+
+		for (const auto& extension : extensions)
+		{
+			candidate.Extensions.push_back(extension.extensionName);
+			LOGD("Device %u Extension Name: %s", i, extension.extensionName);
+		}
+
+		DeviceScore score = ScoreDevice(candidate, s_RequiredDeviceExtensions);
+
+		CachedDevice device;
+		device.VendorID = properties[i].vendorID;
+		device.DeviceID = properties[i].deviceID;
+		device.DriverVersion = properties[i].driverVersion;
+		memcpy(device.PipelineCacheUUID, properties[i].pipelineCacheUUID, VK_UUID_SIZE);
+		device.Score = score.Score;
+		device.Suitable = score.Suitable;
+		device.Reason = score.Reason;
+		device.Extensions = std::move(candidate.Extensions);
+		device.Queues = std::move(candidate.Queues);
+
+		m_Capabilities.Devices.push_back(std::move(device));
+	}
+}
+
+bool Gears::Graphics::LoadCapabilitySnapshot()
+{
+	// 1.0 loaders lack vkEnumerateInstanceVersion, any loader update changes what is on offer
+	m_Capabilities.InstanceVersion = VK_API_VERSION_1_0;
+	m_Capabilities.Build = static_cast<uint32_t>(m_Config.Build);
+
+	if (vkEnumerateInstanceVersion != nullptr)
+		vkEnumerateInstanceVersion(&m_Capabilities.InstanceVersion);
+
+	if (!m_Config.CacheCapabilities)
+		return false;
+
+	CapabilitySnapshot snapshot;
+
+	if (!LoadCapabilities(m_Platform->GetStoragePath() + "/capabilities.bin", snapshot))
+		return false;
+
+	if (snapshot.InstanceVersion != m_Capabilities.InstanceVersion || snapshot.Build != m_Capabilities.Build)
+	{
+		LOGI("Capability snapshot is from another loader or build configuration, probing");
+		return false;
+	}
+
+	m_Capabilities = std::move(snapshot);
+	m_LayerPropertyNames = m_Capabilities.Layers;
+	m_LayerExtensionNames = m_Capabilities.InstanceExtensions;
+	m_CapabilitiesCached = true;
+
+	LOGI("Capability snapshot loaded: %zu layers, %zu instance extensions, %zu devices",
+		m_LayerPropertyNames.size(), m_LayerExtensionNames.size(), m_Capabilities.Devices.size());
+
+	return true;
+}
+
+bool Gears::Graphics::SaveCapabilitySnapshot()
+{
+	// Only lists that got as far as a working device are worth keeping
+	if (!m_Config.CacheCapabilities || m_CapabilitiesCached || m_Device == VK_NULL_HANDLE)
+		return true;
+
+	m_Capabilities.Layers = m_LayerPropertyNames;
+	m_Capabilities.InstanceExtensions = m_LayerExtensionNames;
+
+	// Not saving only costs the next start its probe
+	SaveCapabilities(m_Platform->GetStoragePath() + "/capabilities.bin", m_Capabilities);
+
+	return true;
+}
+
+std::vector<VkDeviceQueueCreateInfo> Gears::Graphics::SetupDeviceQueues()
+{
+	// Filled in with the rest of the device's capabilities, probed or cached
+	uint32_t count = static_cast<uint32_t>(m_PhysicalQueueProperties.size());
 
-	vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevices[0], &count, nullptr);
-	m_PhysicalQueueProperties = std::vector<VkQueueFamilyProperties>(count);
-	vkGetPhysicalDeviceQueueFamilyProperties(m_PhysicalDevices[0], &count, m_PhysicalQueueProperties.data());
-	
 	LOGI("Device Queues found: %d", count);
 
-	for (const auto& queue : m_PhysicalQueueProperties)
+	// A family exposing nothing beyond the asked-for capability usually maps
+	// to separate hardware (DMA engines, async compute) that runs alongside graphics
+	auto findFamily = [&](VkQueueFlags required, VkQueueFlags excluded)
 	{
-		if ((queue.queueFlags >> VkQueueFlagBits::VK_QUEUE_GRAPHICS_BIT) & 0x1)
+		for (uint32_t i = 0; i < count; ++i)
 		{
-			LOGI("Queue found with graphics bit.");
-			selectedQueue = &queue;
-			break;
+			VkQueueFlags flags = m_PhysicalQueueProperties[i].queueFlags;
+
+			if ((flags & required) == required && (flags & excluded) == 0 && m_PhysicalQueueProperties[i].queueCount > 0)
+				return i;
 		}
 
-		++m_SelectedGraphicQueueIndex;
-	}
+		return UINT32_MAX;
+	};
 
-	if (selectedQueue == nullptr)
+	uint32_t graphicsFamily = findFamily(VK_QUEUE_GRAPHICS_BIT, 0);
+	uint32_t computeFamily = findFamily(VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
+	uint32_t transferFamily = findFamily(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+
+	if (graphicsFamily == UINT32_MAX)
 	{
-		LOGI("No queue found with graphics bit");
+		LOGE("No queue found with graphics bit");
 		return {};
 	}
 
-	static const float qPriorities[] = {1.0f};
+	// Graphics and compute queues implicitly support transfers
+	if (computeFamily == UINT32_MAX) computeFamily = graphicsFamily;
+	if (transferFamily == UINT32_MAX) transferFamily = computeFamily;
+
+	m_QueuePriorities = std::vector<std::vector<float>>(count);
 
-	VkDeviceQueueCreateInfo queueInfo{};
-	queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-	queueInfo.queueCount = selectedQueue->queueCount;
-	queueInfo.queueFamilyIndex = m_SelectedGraphicQueueIndex;
-	queueInfo.pQueuePriorities = qPriorities;
+	// Takes the next unused queue of the family, or shares its last one when
+	// the family has run out. Frame work gets the highest priority.
+	auto assign = [&](QueueSelection& selection, uint32_t family, float priority)
+	{
+		auto& priorities = m_QueuePriorities[family];
+
+		selection.Family = family;
+
+		if (priorities.size() < m_PhysicalQueueProperties[family].queueCount)
+		{
+			selection.Index = static_cast<uint32_t>(priorities.size());
+			priorities.push_back(priority);
+		}
+		else
+		{
+			selection.Index = static_cast<uint32_t>(priorities.size()) - 1;
+		}
+	};
+
+	assign(m_GraphicsSelection, graphicsFamily, 1.0f);
+	assign(m_ComputeSelection, computeFamily, 0.5f);
+	assign(m_TransferSelection, transferFamily, 0.5f);
+
+	LOGI("Queues: graphics %u.%u, compute %u.%u, transfer %u.%u",
+		m_GraphicsSelection.Family, m_GraphicsSelection.Index,
+		m_ComputeSelection.Family, m_ComputeSelection.Index,
+		m_TransferSelection.Family, m_TransferSelection.Index);
+
+	std::vector<VkDeviceQueueCreateInfo> queueInfos;
+
+	for (uint32_t family = 0; family < count; ++family)
+	{
+		if (m_QueuePriorities[family].empty())
+			continue;
+
+		VkDeviceQueueCreateInfo queueInfo{};
+		queueInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+		queueInfo.queueCount = static_cast<uint32_t>(m_QueuePriorities[family].size());
+		queueInfo.queueFamilyIndex = family;
+		queueInfo.pQueuePriorities = m_QueuePriorities[family].data();
+
+		queueInfos.push_back(queueInfo);
+	}
 
-	return queueInfo;
+	return queueInfos;
 }
 
-void Gears::Graphics::CreateLogicalDevice(VkDeviceQueueCreateInfo queueCreateInfo)
+bool Gears::Graphics::CreateLogicalDevice(const std::vector<VkDeviceQueueCreateInfo>& queueInfos)
 {
 	VkDeviceCreateInfo deviceInfo{};
-	VkDeviceQueueCreateInfo queueInfo[] = {queueCreateInfo};
-
-	static const char* extensions[] = { "VK_KHR_swapchain" };
 
 	deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-	deviceInfo.enabledExtensionCount = 1;
-	deviceInfo.ppEnabledExtensionNames = extensions;
+	deviceInfo.enabledExtensionCount = static_cast<uint32_t>(s_RequiredDeviceExtensions.size());
+	deviceInfo.ppEnabledExtensionNames = s_RequiredDeviceExtensions.data();
 	deviceInfo.enabledLayerCount = 0;
 	deviceInfo.ppEnabledLayerNames = nullptr;
-	deviceInfo.pQueueCreateInfos = queueInfo;
-	deviceInfo.queueCreateInfoCount = 1;
+	deviceInfo.pQueueCreateInfos = queueInfos.data();
+	deviceInfo.queueCreateInfoCount = static_cast<uint32_t>(queueInfos.size());
+
+	VK_CALL_OR(vkCreateDevice(m_PhysicalDevice, &deviceInfo, m_AllocationCallbacks, &m_Device), false);
+
+	// From here on device calls skip the loader's dispatch
+	LoadDeviceFunctions(m_Device);
+
+	vkGetDeviceQueue(m_Device, m_GraphicsSelection.Family, m_GraphicsSelection.Index, &m_GraphicsQueue);
+	vkGetDeviceQueue(m_Device, m_ComputeSelection.Family, m_ComputeSelection.Index, &m_ComputeQueue);
+	vkGetDeviceQueue(m_Device, m_TransferSelection.Family, m_TransferSelection.Index, &m_TransferQueue);
+
+	return true;
+}
+
+bool Gears::Graphics::CreatePipelineCache()
+{
+	// Without a cache pipelines still build, VK_NULL_HANDLE is a valid one to pass
+	m_PipelineCache.Create(m_Device, m_MainDeviceProperties, m_Platform->GetStoragePath() + "/pipeline_cache.bin", m_AllocationCallbacks);
+
+	return true;
+}
 
-	VK_CALL(vkCreateDevice(m_PhysicalDevices[0], &deviceInfo, nullptr, &m_Device));
+bool Gears::Graphics::CreateMemoryAllocator()
+{
+	m_MemoryAllocator.Init(m_PhysicalDevice, m_Device, MEMORY_BLOCK_SIZE, m_AllocationCallbacks);
+	m_DeletionQueue.Init(m_Device, &m_MemoryAllocator, m_AllocationCallbacks);
+
+	return true;
 }
 
-void Gears::Graphics::CreateCommandBufferPool()
+bool Gears::Graphics::CreateStaging()
 {
-	constexpr int COMMAND_BUFFER_SIZE = 1;
+	// Sharing the graphics queue means sharing its lock, staging may submit from a loader thread
+	std::mutex* queueMutex = m_TransferQueue == m_GraphicsQueue ? &m_GraphicsQueueMutex : nullptr;
+
+	return m_Staging.Init(m_Device, m_MemoryAllocator, m_TransferSelection.Family, m_TransferQueue,
+		m_GraphicsSelection.Family, queueMutex, m_Config.StagingSize, m_AllocationCallbacks);
+}
+
+bool Gears::Graphics::CreateCommandBufferPool()
+{
+	const uint32_t threadCount = m_Config.Jobs ? m_Config.Jobs->GetThreadCount() : 1;
+
+	m_Frames = std::vector<FrameData>(m_Config.FramesInFlight);
+
+	for (auto& frame : m_Frames)
+	{
+		// Transient pool per slot, reset wholesale once the slot's fence signals
+		VkCommandPoolCreateInfo createInfo{};
+		createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		createInfo.queueFamilyIndex = m_GraphicsSelection.Family;
+
+		VK_CALL_OR(vkCreateCommandPool(m_Device, &createInfo, m_AllocationCallbacks, &frame.CommandPool), false);
+
+		VkCommandBufferAllocateInfo allocateInfo{};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocateInfo.commandBufferCount = 1;
+		allocateInfo.commandPool = frame.CommandPool;
+		allocateInfo.level = VkCommandBufferLevel::VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 
-	VkCommandPoolCreateInfo createInfo{};
-	createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-	createInfo.queueFamilyIndex = m_SelectedGraphicQueueIndex;
-	
-	VK_CALL(vkCreateCommandPool(m_Device, &createInfo, nullptr, &m_CommandPool));
+		VK_CALL_OR(vkAllocateCommandBuffers(m_Device, &allocateInfo, &frame.CommandBuffer), false);
 
-	VkCommandBufferAllocateInfo allocateInfo{};
-	allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	allocateInfo.commandBufferCount = COMMAND_BUFFER_SIZE;
-	allocateInfo.commandPool = m_CommandPool;
-	allocateInfo.level = VkCommandBufferLevel::VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		frame.Arena.Reserve(m_Config.FrameArenaSize);
+
+		// One more pool per recording thread for its secondary buffers
+		frame.Threads = std::vector<ThreadCommands>(threadCount);
+
+		for (auto& thread : frame.Threads)
+			VK_CALL_OR(vkCreateCommandPool(m_Device, &createInfo, m_AllocationCallbacks, &thread.CommandPool), false);
+	}
 
-	std::vector<VkCommandBuffer> uCommandBufferList(COMMAND_BUFFER_SIZE);
-	
-	VK_CALL(vkAllocateCommandBuffers(m_Device, &allocateInfo, uCommandBufferList.data()));
-	/* TODO: Test here... */
+	LOGI("Frames in flight: %u, recording threads: %u", m_Config.FramesInFlight, threadCount);
+
+	return true;
 }
 
-void Gears::Graphics::CreateSwapChain()
+bool Gears::Graphics::CreateSyncObjects()
 {
-	VkSwapchainCreateInfoKHR info{};
-	info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-	info.surface = m_Surface;
-	info.minImageCount = m_SurfaceCapabilities.minImageCount;
-	info.imageFormat = VkFormat::VK_FORMAT_R8G8B8A8_UINT;
-	info.imageColorSpace = VkColorSpaceKHR::VK_COLORSPACE_SRGB_NONLINEAR_KHR;
-	info.imageExtent = m_SurfaceCapabilities.currentExtent;
-	info.imageArrayLayers = 1; // 2 for Stereo Applications
-	info.imageUsage = 
-		VkImageUsageFlagBits::VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | 
-		VkImageUsageFlagBits::VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-	info.imageSharingMode = VkSharingMode::VK_SHARING_MODE_EXCLUSIVE;
-	info.clipped = VK_FALSE;
+	VkFenceCreateInfo fenceInfo{};
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // First wait on each slot must not block
+
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+	for (auto& frame : m_Frames)
+	{
+		VK_CALL_OR(vkCreateFence(m_Device, &fenceInfo, m_AllocationCallbacks, &frame.InFlightFence), false);
+		VK_CALL_OR(vkCreateSemaphore(m_Device, &semaphoreInfo, m_AllocationCallbacks, &frame.ImageAvailable), false);
+		VK_CALL_OR(vkCreateSemaphore(m_Device, &semaphoreInfo, m_AllocationCallbacks, &frame.RenderFinished), false);
+	}
 
-	VK_CALL(vkCreateSwapchainKHR(m_Device, &info, nullptr, &m_Swapchain));
+	return true;
 }
 
-void Gears::Graphics::CachePhysicalDeviceCapabilities()
+bool Gears::Graphics::CreateGpuProfiler()
 {
-	VK_CALL(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_PhysicalDevices[0], m_Surface, &m_SurfaceCapabilities));
+	if (m_Config.GpuZones == 0)
+		return true;
+
+	// Zones only ever go into the graphics queue's command buffers
+	const uint32_t validBits = m_PhysicalQueueProperties[m_GraphicsSelection.Family].timestampValidBits;
+
+	// Stays disabled without timestamp support, zones are a diagnostic and never stop startup
+	m_GpuProfiler.Init(m_Device, m_Config.FramesInFlight, m_Config.GpuZones,
+		m_MainDeviceProperties.limits.timestampPeriod, validBits, m_AllocationCallbacks);
+
+	return true;
 }
 
-void Gears::Graphics::CreateInstance()
+bool Gears::Graphics::CreateInstance()
 {
-	static const char* extensions[] = { "VK_KHR_surface", "VK_KHR_android_surface", "VK_EXT_debug_report" };
-	static const char* layers[]		= { "VK_LAYER_KHRONOS_validation" };
+	std::vector<const char*> layers;
+	std::vector<const char*> extensions;
+
+	for (const char* extension : m_Platform->GetInstanceExtensions())
+	{
+		if (Contains(m_LayerExtensionNames, extension))
+			extensions.push_back(extension);
+		else
+			LOGE("GearsError::Required instance extension %s is not available", extension);
+	}
+
+	// Validation multiplies the CPU cost of every call, only Debug pays for it
+	if (m_Config.Build == BuildConfig::Debug)
+	{
+		if (Contains(m_LayerPropertyNames, VALIDATION_LAYER_NAME))
+			layers.push_back(VALIDATION_LAYER_NAME);
+		else
+			LOGW("GearsWarning::%s not installed, running without validation", VALIDATION_LAYER_NAME);
+
+		m_DebugReportEnabled = Contains(m_LayerExtensionNames, VK_EXT_DEBUG_REPORT_EXTENSION_NAME);
+
+		if (m_DebugReportEnabled)
+			extensions.push_back(VK_EXT_DEBUG_REPORT_EXTENSION_NAME);
+	}
+
+	// Frame and pass labels for external GPU profilers, no validation cost
+	if (m_Config.Build != BuildConfig::Release && Contains(m_LayerExtensionNames, VK_EXT_DEBUG_UTILS_EXTENSION_NAME))
+	{
+		extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+		m_DebugUtilsEnabled = true;
+	}
+
+	LOGI("Instance config %u: %zu layers, %zu extensions", static_cast<uint32_t>(m_Config.Build), layers.size(), extensions.size());
 
 	VkInstanceCreateInfo info{};
 	info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
 	info.pNext = nullptr;
-	info.enabledLayerCount = 1;
-	info.ppEnabledLayerNames = layers;
-	info.enabledExtensionCount = 3;
-	info.ppEnabledExtensionNames = extensions;
+	info.enabledLayerCount = static_cast<uint32_t>(layers.size());
+	info.ppEnabledLayerNames = layers.data();
+	info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+	info.ppEnabledExtensionNames = extensions.data();
+
+	VK_CALL_OR(vkCreateInstance(&info, m_AllocationCallbacks, &m_VkInstance), false);
+
+	LoadInstanceFunctions(m_VkInstance);
 
-	VK_CALL(vkCreateInstance(&info, nullptr, &m_VkInstance));
+	return true;
 }
 
-void Gears::Graphics::SetupDebugCallbacks()
+bool Gears::Graphics::SetupDebugCallbacks()
 {
+	if (!m_DebugReportEnabled)
+		return true;
+
 	/* Load VK_EXT_debug_report entry points in debug builds */
 	PFN_vkCreateDebugReportCallbackEXT vkCreateDebugReportCallbackEXT =
 		reinterpret_cast<PFN_vkCreateDebugReportCallbackEXT>
@@ -235,19 +1089,11 @@ void Gears::Graphics::SetupDebugCallbacks()
 	callbackCreateInfo.flags = VK_DEBUG_REPORT_ERROR_BIT_EXT |
 		VK_DEBUG_REPORT_WARNING_BIT_EXT |
 		VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT;
-	callbackCreateInfo.pfnCallback = &DebugReportCallback;
-	callbackCreateInfo.pUserData = nullptr;
+	callbackCreateInfo.pfnCallback = &DebugReportAggregator::Callback;
+	callbackCreateInfo.pUserData = &m_DebugReport;
 
 	/* Register the callback */
-	VkDebugReportCallbackEXT callback;
-	VK_CALL(vkCreateDebugReportCallbackEXT(m_VkInstance, &callbackCreateInfo, nullptr, &callback));
-}
+	VK_CALL_OR(vkCreateDebugReportCallbackEXT(m_VkInstance, &callbackCreateInfo, m_AllocationCallbacks, &m_DebugCallback), false);
 
-void Gears::Graphics::CreateSurface(ANativeWindow* nativeWindow)
-{
-    VkAndroidSurfaceCreateInfoKHR surfaceCreateInfo = {};
-    surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR;
-	surfaceCreateInfo.window = nativeWindow;
-
-	VK_CALL(vkCreateAndroidSurfaceKHR(m_VkInstance, &surfaceCreateInfo, NULL, &m_Surface));
-}
\ No newline at end of file
+	return true;
+}
@@ -0,0 +1,127 @@
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include "Logger.h"
+#include "async_init.h"
+#include "graphics.h"
+#include "headless_platform.h"
+#include "job_system.h"
+#include "profiler.h"
+
+// Linux entry point, drives the same Graphics path as android_main against a headless surface,
+// e.g. on lavapipe: GEARS_HEADLESS [width] [height] [frames] [framesInFlight] [recordPasses]
+int main(int argc, char** argv)
+{
+    uint32_t width  = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1280;
+    uint32_t height = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 720;
+    uint32_t frames = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : 300;
+
+    uint32_t passes = argc > 5 ? static_cast<uint32_t>(std::atoi(argv[5])) : 0;
+
+    Gears::JobSystem jobs;
+
+    Gears::StartupProgress progress;
+
+    Gears::GraphicsConfig config{};
+    config.Jobs = &jobs;
+    config.Progress = &progress;
+    if (argc > 4)
+    {
+        int framesInFlight = std::atoi(argv[4]);
+
+        if (framesInFlight < 1)
+        {
+            LOGE("GearsError::framesInFlight must be at least 1, got %s", argv[4]);
+            return 1;
+        }
+
+        config.FramesInFlight = static_cast<uint32_t>(framesInFlight);
+    }
+
+    LOGI("Creating Vulkan");
+
+    Gears::HeadlessPlatform platform{ width, height };
+
+    // Same split as android_main: the core is built on a worker while this thread keeps polling
+    Gears::AsyncInit<Gears::Graphics> init;
+
+    init.Start([&platform, config]() {
+        auto graphics = std::make_unique<Gears::Graphics>(platform, config);
+        return graphics->IsValid() ? std::move(graphics) : nullptr;
+    });
+
+    const char* loggedStep = nullptr;
+
+    while (init.IsRunning())
+    {
+        const char* step = progress.Step.load(std::memory_order_relaxed);
+
+        if (step != loggedStep)
+        {
+            LOGI("Loading Vulkan: %s (%u steps done)", step, progress.Completed.load(std::memory_order_relaxed));
+            loggedStep = step;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto graphics = init.Take();
+
+    if (!graphics)
+    {
+        LOGE("GearsError::Vulkan initialization failed");
+        return 1;
+    }
+
+    Gears::Graphics& g = *graphics;
+    g.AttachWindow();
+
+    g.GetStartupTimeline().LogSummary();
+
+    // For automated startup regression runs, open in chrome://tracing or Perfetto
+    if (const char* tracePath = std::getenv("GEARS_STARTUP_TRACE"))
+        g.GetStartupTimeline().WriteChromeTrace(tracePath);
+
+    // Stand-in workload to exercise parallel secondary recording
+    for (uint32_t i = 0; i < passes; ++i)
+    {
+        g.AddRecordPass([i](const Gears::RecordContext& context) {
+            VkClearColorValue color{};
+            color.float32[0] = static_cast<float>(i % 8) / 8.0f;
+            color.float32[3] = 1.0f;
+
+            VkImageSubresourceRange range{};
+            range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            range.levelCount = 1;
+            range.layerCount = 1;
+
+            vkCmdClearColorImage(context.CommandBuffer, context.TargetImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1, &range);
+        }, "ClearPass");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < frames; ++i)
+    {
+        GEARS_PROFILE_FRAME();
+        g.RenderFrame();
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    LOGI("Rendered %u frames, %.3f ms/frame", frames, frames ? elapsed.count() / frames : 0.0);
+
+    // The last frame resolved on the GPU, a few frames behind the CPU
+    for (const auto& i : g.GetGpuProfiler().GetLastTimings())
+        LOGI("GPU %s: %.3f ms", i.Name, i.DurationNs / 1e6);
+
+    g.GetHostAllocator().LogSummary();
+
+    g.SavePipelineCache();
+
+    // Zones only exist in profile builds, elsewhere this writes an empty trace
+    if (const char* tracePath = std::getenv("GEARS_PROFILE_TRACE"))
+        Gears::WriteProfileTrace(tracePath);
+
+    return 0;
+}
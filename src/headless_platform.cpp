@@ -0,0 +1,36 @@
+#include "headless_platform.h"
+
+Gears::HeadlessPlatform::HeadlessPlatform( uint32_t width, uint32_t height, std::string storagePath ) :
+	m_Extent{ width, height },
+	m_StoragePath( std::move(storagePath) )
+{
+}
+
+std::vector<const char*> Gears::HeadlessPlatform::GetInstanceExtensions() const
+{
+	return { "VK_KHR_surface", "VK_EXT_headless_surface" };
+}
+
+VkResult Gears::HeadlessPlatform::CreateSurface(VkInstance instance, const VkAllocationCallbacks* allocator, VkSurfaceKHR* surface) const
+{
+	auto vkCreateHeadlessSurfaceEXT = reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>
+		(vkGetInstanceProcAddr(instance, "vkCreateHeadlessSurfaceEXT"));
+
+	if (vkCreateHeadlessSurfaceEXT == nullptr)
+		return VK_ERROR_EXTENSION_NOT_PRESENT;
+
+	VkHeadlessSurfaceCreateInfoEXT surfaceCreateInfo = {};
+	surfaceCreateInfo.sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT;
+
+	return vkCreateHeadlessSurfaceEXT(instance, &surfaceCreateInfo, allocator, surface);
+}
+
+VkExtent2D Gears::HeadlessPlatform::GetWindowExtent() const
+{
+	return m_Extent;
+}
+
+std::string Gears::HeadlessPlatform::GetStoragePath() const
+{
+	return m_StoragePath;
+}
@@ -0,0 +1,241 @@
+#include "host_allocator.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+	// Sits right before every pointer handed to the driver, which only gives the pointer back on free
+	struct AllocationHeader
+	{
+		void*                 Base;   // From malloc, nullptr when carved from the pool
+		Gears::TlsfAllocation Range;
+		size_t                Size;   // As requested by the driver
+		uint32_t              Scope;
+	};
+
+	constexpr size_t MIN_ALIGNMENT = alignof(std::max_align_t);
+
+	const char* s_ScopeNames[Gears::HOST_SCOPE_COUNT] = { "Command", "Object", "Cache", "Device", "Instance" };
+
+	uint32_t ScopeIndex(VkSystemAllocationScope scope)
+	{
+		return static_cast<uint32_t>(scope) < Gears::HOST_SCOPE_COUNT ? static_cast<uint32_t>(scope) : VK_SYSTEM_ALLOCATION_SCOPE_OBJECT;
+	}
+
+	AllocationHeader* GetHeader(void* memory)
+	{
+		return reinterpret_cast<AllocationHeader*>(static_cast<uint8_t*>(memory) - sizeof(AllocationHeader));
+	}
+}
+
+Gears::HostAllocator::HostAllocator()
+{
+	m_Callbacks.pUserData = this;
+	m_Callbacks.pfnAllocation = AllocationCallback;
+	m_Callbacks.pfnReallocation = ReallocationCallback;
+	m_Callbacks.pfnFree = FreeCallback;
+	m_Callbacks.pfnInternalAllocation = InternalAllocationCallback;
+	m_Callbacks.pfnInternalFree = InternalFreeCallback;
+}
+
+Gears::HostAllocator::~HostAllocator()
+{
+	uint64_t live = m_Total.LiveAllocations.load(std::memory_order_relaxed);
+
+	if (live != 0)
+		LOGE("GearsError::Host allocator destroyed with %" PRIu64 " driver allocations alive", live);
+}
+
+void Gears::HostAllocator::Init(size_t poolSize)
+{
+	if (poolSize == 0)
+		return;
+
+	const size_t count = (poolSize + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+	m_Pool.reset(new std::max_align_t[count]);
+	m_PoolRanges.Init(count * sizeof(std::max_align_t));
+
+	LOGI("Driver host allocations pooled in %zu bytes", count * sizeof(std::max_align_t));
+}
+
+Gears::HostAllocationStats Gears::HostAllocator::GetStats(VkSystemAllocationScope scope) const
+{
+	const Counters& counters = m_Scopes[ScopeIndex(scope)];
+
+	HostAllocationStats stats;
+	stats.LiveBytes = counters.LiveBytes.load(std::memory_order_relaxed);
+	stats.PeakBytes = counters.PeakBytes.load(std::memory_order_relaxed);
+	stats.Allocations = counters.Allocations.load(std::memory_order_relaxed);
+	stats.LiveAllocations = counters.LiveAllocations.load(std::memory_order_relaxed);
+	stats.InternalBytes = counters.InternalBytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+Gears::HostAllocationStats Gears::HostAllocator::GetTotal() const
+{
+	HostAllocationStats stats;
+	stats.LiveBytes = m_Total.LiveBytes.load(std::memory_order_relaxed);
+	stats.PeakBytes = m_Total.PeakBytes.load(std::memory_order_relaxed);
+	stats.Allocations = m_Total.Allocations.load(std::memory_order_relaxed);
+	stats.LiveAllocations = m_Total.LiveAllocations.load(std::memory_order_relaxed);
+	stats.InternalBytes = m_Total.InternalBytes.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void Gears::HostAllocator::LogSummary() const
+{
+	for (uint32_t i = 0; i < HOST_SCOPE_COUNT; ++i)
+	{
+		HostAllocationStats stats = GetStats(static_cast<VkSystemAllocationScope>(i));
+
+		if (stats.Allocations == 0 && stats.InternalBytes == 0)
+			continue;
+
+		LOGI("Driver host memory, %s scope: %" PRIu64 " bytes live, %" PRIu64 " peak, %" PRIu64 " allocations, %" PRIu64 " internal",
+			s_ScopeNames[i], stats.LiveBytes, stats.PeakBytes, stats.Allocations, stats.InternalBytes);
+	}
+
+	HostAllocationStats total = GetTotal();
+	LOGI("Driver host memory: %" PRIu64 " bytes live in %" PRIu64 " allocations, %" PRIu64 " peak",
+		total.LiveBytes, total.LiveAllocations, total.PeakBytes);
+}
+
+void* Gears::HostAllocator::Allocate(size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+	if (size == 0)
+		return nullptr;
+
+	alignment = std::max(alignment, MIN_ALIGNMENT);
+	const size_t total = size + sizeof(AllocationHeader) + alignment - 1;
+
+	AllocationHeader header{};
+	uint8_t* base = nullptr;
+
+	if (m_Pool)
+	{
+		std::lock_guard<std::mutex> lock(m_PoolMutex);
+
+		if (m_PoolRanges.Allocate(total, MIN_ALIGNMENT, header.Range))
+			base = reinterpret_cast<uint8_t*>(m_Pool.get()) + header.Range.Offset;
+	}
+
+	// Not pooled, or the pool is full
+	if (base == nullptr)
+	{
+		base = static_cast<uint8_t*>(malloc(total));
+
+		if (base == nullptr)
+			return nullptr;
+
+		header.Base = base;
+	}
+
+	uintptr_t address = reinterpret_cast<uintptr_t>(base) + sizeof(AllocationHeader);
+	address = (address + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+
+	void* memory = reinterpret_cast<void*>(address);
+	header.Size = size;
+	header.Scope = ScopeIndex(scope);
+	*GetHeader(memory) = header;
+
+	Track(m_Scopes[header.Scope], size, true);
+	Track(m_Total, size, true);
+
+	return memory;
+}
+
+void* Gears::HostAllocator::Reallocate(void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+	if (original == nullptr)
+		return Allocate(size, alignment, scope);
+
+	if (size == 0)
+	{
+		Free(original);
+		return nullptr;
+	}
+
+	// The original stays untouched when this fails, as the spec requires
+	void* memory = Allocate(size, alignment, scope);
+
+	if (memory == nullptr)
+		return nullptr;
+
+	memcpy(memory, original, std::min(GetHeader(original)->Size, size));
+	Free(original);
+
+	return memory;
+}
+
+void Gears::HostAllocator::Free(void* memory)
+{
+	if (memory == nullptr)
+		return;
+
+	const AllocationHeader header = *GetHeader(memory);
+
+	Track(m_Scopes[header.Scope], header.Size, false);
+	Track(m_Total, header.Size, false);
+
+	if (header.Base != nullptr)
+	{
+		free(header.Base);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_PoolMutex);
+	m_PoolRanges.Free(header.Range);
+}
+
+void Gears::HostAllocator::Track(Counters& counters, size_t size, bool allocated)
+{
+	if (!allocated)
+	{
+		counters.LiveBytes.fetch_sub(size, std::memory_order_relaxed);
+		counters.LiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+		return;
+	}
+
+	uint64_t live = counters.LiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	uint64_t peak = counters.PeakBytes.load(std::memory_order_relaxed);
+
+	while (live > peak && !counters.PeakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+	{
+	}
+
+	counters.LiveAllocations.fetch_add(1, std::memory_order_relaxed);
+	counters.Allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+VKAPI_ATTR void* VKAPI_CALL Gears::HostAllocator::AllocationCallback(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+	return static_cast<HostAllocator*>(userData)->Allocate(size, alignment, scope);
+}
+
+VKAPI_ATTR void* VKAPI_CALL Gears::HostAllocator::ReallocationCallback(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+	return static_cast<HostAllocator*>(userData)->Reallocate(original, size, alignment, scope);
+}
+
+VKAPI_ATTR void VKAPI_CALL Gears::HostAllocator::FreeCallback(void* userData, void* memory)
+{
+	static_cast<HostAllocator*>(userData)->Free(memory);
+}
+
+VKAPI_ATTR void VKAPI_CALL Gears::HostAllocator::InternalAllocationCallback(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope scope)
+{
+	auto* allocator = static_cast<HostAllocator*>(userData);
+	allocator->m_Scopes[ScopeIndex(scope)].InternalBytes.fetch_add(size, std::memory_order_relaxed);
+	allocator->m_Total.InternalBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+VKAPI_ATTR void VKAPI_CALL Gears::HostAllocator::InternalFreeCallback(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope scope)
+{
+	auto* allocator = static_cast<HostAllocator*>(userData);
+	allocator->m_Scopes[ScopeIndex(scope)].InternalBytes.fetch_sub(size, std::memory_order_relaxed);
+	allocator->m_Total.InternalBytes.fetch_sub(size, std::memory_order_relaxed);
+}
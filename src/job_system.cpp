@@ -0,0 +1,329 @@
+#include "job_system.h"
+#include "profiler.h"
+
+namespace
+{
+	thread_local Gears::JobSystem* t_JobSystem   = nullptr;
+	thread_local uint32_t          t_ThreadIndex = 0;
+
+	constexpr uint32_t IDLE_SPINS_BEFORE_SLEEP = 64;
+}
+
+bool Gears::JobQueue::Push(Job* job)
+{
+	int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+	int64_t top = m_Top.load(std::memory_order_acquire);
+
+	if (bottom - top >= static_cast<int64_t>(JOB_QUEUE_SIZE))
+		return false;
+
+	m_Jobs[bottom & (JOB_QUEUE_SIZE - 1)].store(job, std::memory_order_relaxed);
+	m_Bottom.store(bottom + 1, std::memory_order_release); // Publishes the job to thieves
+
+	return true;
+}
+
+Gears::Job* Gears::JobQueue::Pop()
+{
+	int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+	m_Bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_Top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = m_Jobs[bottom & (JOB_QUEUE_SIZE - 1)].load(std::memory_order_relaxed);
+
+	// Last job left, race any thief for it
+	if (top == bottom)
+	{
+		if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			job = nullptr;
+
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+Gears::Job* Gears::JobQueue::Steal()
+{
+	int64_t top = m_Top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+	if (top >= bottom)
+		return nullptr;
+
+	Job* job = m_Jobs[top & (JOB_QUEUE_SIZE - 1)].load(std::memory_order_relaxed);
+
+	if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr;
+
+	return job;
+}
+
+Gears::JobSystem::JobSystem( uint32_t workerCount )
+{
+	if (workerCount == JOB_AUTO_WORKERS)
+	{
+		uint32_t cores = std::thread::hardware_concurrency();
+		workerCount = cores > 1 ? cores - 1 : 0;
+	}
+
+	for (uint32_t i = 0; i <= workerCount; ++i)
+	{
+		m_Queues.push_back(std::make_unique<JobQueue>());
+		m_Pools.push_back(std::make_unique<JobPool>());
+	}
+
+	m_Pools.push_back(std::make_unique<JobPool>());
+
+	t_JobSystem = this;
+	t_ThreadIndex = 0;
+
+	for (uint32_t i = 1; i <= workerCount; ++i)
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+Gears::JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_Quit = true;
+	}
+
+	m_SleepCondition.notify_all();
+
+	for (auto& worker : m_Workers)
+		worker.join();
+
+	if (t_JobSystem == this)
+		t_JobSystem = nullptr;
+}
+
+uint32_t Gears::JobSystem::GetThreadIndex()
+{
+	return t_ThreadIndex;
+}
+
+bool Gears::JobSystem::IsForeignThread() const
+{
+	return t_JobSystem != this;
+}
+
+// Stands in for a continuation slot once a job runs out of them, see AddDependency
+static void FanOut(Gears::Job*)
+{
+}
+
+Gears::Job* Gears::JobSystem::CreateEmpty(Job* parent)
+{
+	Job* job = Allocate(parent);
+	job->Execute = [](Job*) {};
+	return job;
+}
+
+Gears::Job* Gears::JobSystem::Allocate(Job* parent)
+{
+	Job* job;
+
+	if (IsForeignThread())
+	{
+		std::lock_guard<std::mutex> lock(m_ForeignMutex);
+		auto& pool = *m_Pools.back();
+		job = &pool.Jobs[pool.Next++ & (JOB_POOL_SIZE - 1)];
+	}
+	else
+	{
+		auto& pool = *m_Pools[t_ThreadIndex];
+		job = &pool.Jobs[pool.Next++ & (JOB_POOL_SIZE - 1)];
+	}
+
+	job->Execute = nullptr;
+	job->Destroy = nullptr;
+	job->Parent = parent;
+	job->Unfinished.store(1, std::memory_order_relaxed);
+	job->PendingDependencies.store(1, std::memory_order_relaxed); // Dropped by Run()
+	job->ContinuationCount.store(0, std::memory_order_relaxed);
+
+	if (parent != nullptr)
+		parent->Unfinished.fetch_add(1, std::memory_order_relaxed);
+
+	return job;
+}
+
+void Gears::JobSystem::AddDependency(Job* job, Job* dependsOn)
+{
+	uint32_t index = dependsOn->ContinuationCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (index >= JOB_MAX_CONTINUATIONS)
+	{
+		dependsOn->ContinuationCount.fetch_sub(1, std::memory_order_relaxed);
+
+		// Out of slots: the last one moves to an empty job that waits on
+		// dependsOn alone and fans out to everything hung off it, so no
+		// continuation picks up a dependency it did not ask for
+		Job*& last = dependsOn->Continuations[JOB_MAX_CONTINUATIONS - 1];
+
+		if (last->Execute != FanOut)
+		{
+			Job* fanOut = Allocate(nullptr);
+			fanOut->Execute = FanOut;
+			fanOut->Continuations[0] = last;
+			fanOut->ContinuationCount.store(1, std::memory_order_relaxed);
+			fanOut->PendingDependencies.fetch_add(1, std::memory_order_relaxed);
+			last = fanOut;
+
+			// Drops the creation hold, dependsOn has not run so it stays pending
+			Release(fanOut);
+		}
+
+		AddDependency(job, last);
+		return;
+	}
+
+	job->PendingDependencies.fetch_add(1, std::memory_order_relaxed);
+	dependsOn->Continuations[index] = job;
+}
+
+void Gears::JobSystem::Run(Job* job)
+{
+	Release(job);
+}
+
+void Gears::JobSystem::Release(Job* job)
+{
+	if (job->PendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		Submit(job);
+}
+
+void Gears::JobSystem::Submit(Job* job)
+{
+	if (IsForeignThread())
+	{
+		std::lock_guard<std::mutex> lock(m_ForeignMutex);
+		m_ForeignJobs.push_back(job);
+		m_ForeignPending.fetch_add(1, std::memory_order_release);
+	}
+	else if (!m_Queues[t_ThreadIndex]->Push(job))
+	{
+		// Deque full, run inline rather than grow
+		Execute(job);
+		return;
+	}
+
+	m_QueuedJobs.fetch_add(1, std::memory_order_seq_cst);
+
+	if (m_SleepingWorkers.load(std::memory_order_seq_cst) > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_SleepCondition.notify_one();
+	}
+}
+
+Gears::Job* Gears::JobSystem::GetJob(uint32_t threadIndex)
+{
+	Job* job = m_Queues[threadIndex]->Pop();
+
+	if (job == nullptr && m_ForeignPending.load(std::memory_order_acquire) > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_ForeignMutex);
+
+		if (!m_ForeignJobs.empty())
+		{
+			job = m_ForeignJobs.back();
+			m_ForeignJobs.pop_back();
+			m_ForeignPending.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	const uint32_t queueCount = GetThreadCount();
+
+	for (uint32_t i = 1; job == nullptr && i < queueCount; ++i)
+		job = m_Queues[(threadIndex + i) % queueCount]->Steal();
+
+	if (job != nullptr)
+		m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+	return job;
+}
+
+void Gears::JobSystem::Execute(Job* job)
+{
+	{
+		GEARS_PROFILE_ZONE("Job");
+		job->Execute(job);
+	}
+
+	if (job->Destroy != nullptr)
+		job->Destroy(job);
+
+	Finish(job);
+}
+
+void Gears::JobSystem::Finish(Job* job)
+{
+	if (job->Unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+
+	if (job->Parent != nullptr)
+		Finish(job->Parent);
+
+	uint32_t continuations = job->ContinuationCount.load(std::memory_order_acquire);
+
+	for (uint32_t i = 0; i < continuations; ++i)
+		Release(job->Continuations[i]);
+}
+
+void Gears::JobSystem::Wait(const Job* job)
+{
+	const bool foreign = IsForeignThread();
+
+	while (job->Unfinished.load(std::memory_order_acquire) > 0)
+	{
+		Job* next = foreign ? nullptr : GetJob(t_ThreadIndex);
+
+		if (next != nullptr)
+			Execute(next);
+		else
+			std::this_thread::yield();
+	}
+}
+
+void Gears::JobSystem::WorkerLoop(uint32_t threadIndex)
+{
+	t_JobSystem = this;
+	t_ThreadIndex = threadIndex;
+
+	uint32_t idleSpins = 0;
+
+	while (!m_Quit.load(std::memory_order_relaxed))
+	{
+		if (Job* job = GetJob(threadIndex))
+		{
+			Execute(job);
+			idleSpins = 0;
+			continue;
+		}
+
+		if (++idleSpins < IDLE_SPINS_BEFORE_SLEEP)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// Park until a submit makes work visible, keeps idle cores out of the scheduler
+		std::unique_lock<std::mutex> lock(m_SleepMutex);
+		m_SleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+		m_SleepCondition.wait(lock, [this]() {
+			return m_QueuedJobs.load(std::memory_order_seq_cst) > 0 || m_Quit.load(std::memory_order_relaxed); });
+		m_SleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+
+		idleSpins = 0;
+	}
+}
@@ -0,0 +1,547 @@
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+
+namespace
+{
+	struct alignas(64) LogRing
+	{
+		Gears::LogRecord              Records[Gears::LOG_RING_SIZE];
+		alignas(64) std::atomic<uint32_t> Head{ 0 }; // Written by the owning thread
+		alignas(64) std::atomic<uint32_t> Tail{ 0 }; // Written by the writer thread
+		std::atomic<bool>             Closed{ false };
+		uint32_t                      ThreadId = 0;
+	};
+
+	class StreamSink : public Gears::LogSink
+	{
+		public:
+
+		StreamSink(FILE* stream, bool owned) : m_Stream(stream), m_Owned(owned) {}
+		~StreamSink() override { if (m_Owned) fclose(m_Stream); }
+
+		void Write(Gears::LogLevel level, const char* message, size_t length) override
+		{
+			static const char* prefixes[] = { "D ", "I ", "W ", "E " };
+
+			fputs(prefixes[static_cast<int>(level)], m_Stream);
+			fwrite(message, 1, length, m_Stream);
+			fputc('\n', m_Stream);
+		}
+
+		void Flush() override { fflush(m_Stream); }
+
+		private:
+
+		FILE* m_Stream;
+		bool  m_Owned;
+	};
+
+#ifdef __ANDROID__
+	class LogcatSink : public Gears::LogSink
+	{
+		public:
+
+		void Write(Gears::LogLevel level, const char* message, size_t) override
+		{
+			static const int priorities[] = { ANDROID_LOG_DEBUG, ANDROID_LOG_INFO, ANDROID_LOG_WARN, ANDROID_LOG_ERROR };
+			__android_log_write(priorities[static_cast<int>(level)], "native-activity", message);
+		}
+	};
+#endif
+
+	// Owns every thread's ring and the thread that drains them. Formatting,
+	// the logcat call and file IO all happen here, never on the caller.
+	class Logger
+	{
+		public:
+
+		static Logger& Get()
+		{
+			static Logger logger;
+			return logger;
+		}
+
+		Logger()
+		{
+#ifdef __ANDROID__
+			m_Sinks.push_back(std::make_unique<LogcatSink>());
+#else
+			m_Sinks.push_back(std::make_unique<StreamSink>(stderr, false));
+#endif
+
+			if (const char* path = getenv("GEARS_LOG_FILE"))
+			{
+				if (FILE* file = fopen(path, "w"))
+					m_Sinks.push_back(std::make_unique<StreamSink>(file, true));
+			}
+
+			m_Thread = std::thread([this]() { WriterLoop(); });
+		}
+
+		~Logger()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Quit = true;
+			}
+
+			m_Wake.notify_one();
+			m_Thread.join();
+		}
+
+		std::shared_ptr<LogRing> Register()
+		{
+			auto ring = std::make_shared<LogRing>();
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			ring->ThreadId = m_NextThreadId++;
+			m_Rings.push_back(ring);
+			return ring;
+		}
+
+		void AddSink(std::unique_ptr<Gears::LogSink> sink)
+		{
+			std::lock_guard<std::mutex> lock(m_SinkMutex);
+			m_Sinks.push_back(std::move(sink));
+		}
+
+		std::vector<std::unique_ptr<Gears::LogSink>> SwapSinks(std::vector<std::unique_ptr<Gears::LogSink>> sinks)
+		{
+			std::lock_guard<std::mutex> lock(m_SinkMutex);
+			m_Sinks.swap(sinks);
+			return sinks;
+		}
+
+		// Flagged under the mutex, a bare notify is lost while the writer is busy draining
+		void Wake()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_WakePending = true;
+			}
+
+			m_Wake.notify_one();
+		}
+
+		void Flush()
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			uint64_t target = ++m_FlushRequested;
+
+			m_Wake.notify_one();
+			m_Flushed.wait(lock, [&]() { return m_FlushCompleted >= target; });
+		}
+
+		private:
+
+		std::vector<std::shared_ptr<LogRing>>       m_Rings;
+		std::vector<std::unique_ptr<Gears::LogSink>> m_Sinks;
+		std::thread                                 m_Thread;
+		std::mutex                                  m_Mutex;
+		std::mutex                                  m_SinkMutex;
+		std::condition_variable                     m_Wake;
+		std::condition_variable                     m_Flushed;
+		uint64_t                                    m_FlushRequested = 0;
+		uint64_t                                    m_FlushCompleted = 0;
+		uint32_t                                    m_NextThreadId = 0;
+		bool                                        m_WakePending = false;
+		bool                                        m_Quit = false;
+
+		void WriterLoop()
+		{
+			std::vector<std::shared_ptr<LogRing>> rings;
+
+			for (;;)
+			{
+				uint64_t flushTarget;
+				bool quit;
+
+				{
+					std::unique_lock<std::mutex> lock(m_Mutex);
+
+					// Producers only wake us for errors and rings half full or more, the timeout bounds latency otherwise
+					m_Wake.wait_for(lock, std::chrono::milliseconds(5), [&]() { return m_Quit || m_WakePending || m_FlushRequested > m_FlushCompleted; });
+					m_WakePending = false;
+
+					// Rings of exited threads go once drained
+					m_Rings.erase(std::remove_if(m_Rings.begin(), m_Rings.end(), [](const std::shared_ptr<LogRing>& ring) {
+						return ring->Closed.load(std::memory_order_acquire) &&
+							ring->Tail.load(std::memory_order_relaxed) == ring->Head.load(std::memory_order_acquire);
+					}), m_Rings.end());
+
+					rings = m_Rings;
+					flushTarget = m_FlushRequested;
+					quit = m_Quit;
+				}
+
+				Drain(rings);
+
+				{
+					std::lock_guard<std::mutex> lock(m_Mutex);
+					m_FlushCompleted = flushTarget;
+				}
+
+				m_Flushed.notify_all();
+
+				if (quit)
+					return;
+			}
+		}
+
+		// Merges the rings by sequence so interleaved threads read in order
+		void Drain(const std::vector<std::shared_ptr<LogRing>>& rings)
+		{
+			std::vector<uint32_t> heads(rings.size());
+
+			for (size_t i = 0; i < rings.size(); ++i)
+				heads[i] = rings[i]->Head.load(std::memory_order_acquire);
+
+			char message[Gears::LOG_MESSAGE_SIZE];
+			std::lock_guard<std::mutex> lock(m_SinkMutex);
+
+			for (;;)
+			{
+				LogRing* next = nullptr;
+
+				for (size_t i = 0; i < rings.size(); ++i)
+				{
+					LogRing* ring = rings[i].get();
+					uint32_t tail = ring->Tail.load(std::memory_order_relaxed);
+
+					if (tail == heads[i])
+						continue;
+
+					if (next == nullptr || ring->Records[tail % Gears::LOG_RING_SIZE].Sequence <
+						next->Records[next->Tail.load(std::memory_order_relaxed) % Gears::LOG_RING_SIZE].Sequence)
+						next = ring;
+				}
+
+				if (next == nullptr)
+					break;
+
+				uint32_t tail = next->Tail.load(std::memory_order_relaxed);
+				const Gears::LogRecord& record = next->Records[tail % Gears::LOG_RING_SIZE];
+				size_t length = Gears::FormatLogRecord(record, message, sizeof(message));
+
+				for (auto& sink : m_Sinks)
+					sink->Write(record.Level, message, length);
+
+				next->Tail.store(tail + 1, std::memory_order_release);
+			}
+
+			for (auto& sink : m_Sinks)
+				sink->Flush();
+		}
+	};
+
+	// Marks the ring closed when its thread exits, the writer frees it once drained
+	struct RingHandle
+	{
+		std::shared_ptr<LogRing> Ring;
+
+		~RingHandle()
+		{
+			if (Ring)
+				Ring->Closed.store(true, std::memory_order_release);
+		}
+	};
+
+	thread_local RingHandle t_Ring;
+
+	std::atomic<uint64_t> g_Sequence{ 0 };
+
+	struct LogArg
+	{
+		Gears::LogArgType Type = Gears::LogArgType::Signed;
+		uint8_t           Size = 0;
+		uint64_t          Bits = 0;
+		const char*       Text = nullptr; // Strings only, not NUL-terminated
+		size_t            TextLength = 0;
+	};
+
+	// Rewrites one conversion spec for the stored argument and prints it
+	int FormatArg(char* out, size_t size, const char* flags, size_t flagsLength, char conversion,
+		Gears::LogArgType type, uint8_t argSize, uint64_t bits, const char* text, size_t textLength)
+	{
+		char spec[32];
+		size_t length = flagsLength < 24 ? flagsLength : 24;
+
+		spec[0] = '%';
+		memcpy(spec + 1, flags, length);
+		char* end = spec + 1 + length;
+
+		auto asSigned = [&]() -> long long
+		{
+			if (type == Gears::LogArgType::Double) { double d; memcpy(&d, &bits, sizeof(d)); return static_cast<long long>(d); }
+			return static_cast<long long>(bits);
+		};
+
+		// printf of a narrower unsigned conversion only sees the argument's own width
+		auto asUnsigned = [&]() -> unsigned long long
+		{
+			if (type == Gears::LogArgType::Double) { double d; memcpy(&d, &bits, sizeof(d)); return static_cast<unsigned long long>(d); }
+			if (argSize < 8) return bits & ((1ull << (argSize * 8)) - 1);
+			return bits;
+		};
+
+		switch (conversion)
+		{
+			case 'd': case 'i':
+				end[0] = 'l'; end[1] = 'l'; end[2] = conversion; end[3] = '\0';
+				return snprintf(out, size, spec, asSigned());
+
+			case 'u': case 'o': case 'x': case 'X':
+				end[0] = 'l'; end[1] = 'l'; end[2] = conversion; end[3] = '\0';
+				return snprintf(out, size, spec, asUnsigned());
+
+			case 'c':
+				end[0] = 'c'; end[1] = '\0';
+				return snprintf(out, size, spec, static_cast<int>(asSigned()));
+
+			case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+			{
+				double value;
+				if (type == Gears::LogArgType::Double) memcpy(&value, &bits, sizeof(value));
+				else if (type == Gears::LogArgType::Signed) value = static_cast<double>(static_cast<int64_t>(bits));
+				else value = static_cast<double>(bits);
+
+				end[0] = conversion; end[1] = '\0';
+				return snprintf(out, size, spec, value);
+			}
+
+			case 's':
+			{
+				if (type != Gears::LogArgType::String)
+					return snprintf(out, size, "<?>");
+
+				// Text is not NUL-terminated in the record, so any precision from the format is folded into .*
+				const char* dot = static_cast<const char*>(memchr(flags, '.', length));
+
+				if (dot != nullptr)
+				{
+					size_t precision = static_cast<size_t>(atoi(dot + 1));
+					textLength = precision < textLength ? precision : textLength;
+					end = spec + 1 + (dot - flags);
+				}
+
+				end[0] = '.'; end[1] = '*'; end[2] = 's'; end[3] = '\0';
+				return snprintf(out, size, spec, static_cast<int>(textLength), text);
+			}
+
+			case 'p':
+				end[0] = 'p'; end[1] = '\0';
+				return snprintf(out, size, spec, reinterpret_cast<void*>(static_cast<uintptr_t>(bits)));
+
+			default:
+				return 0;
+		}
+	}
+}
+
+size_t Gears::FormatLogRecord(const LogRecord& record, char* buffer, size_t size)
+{
+	if (size == 0)
+		return 0;
+
+	size_t written = 0;
+	size_t payload = 0;
+	uint32_t argIndex = 0;
+
+	auto append = [&](const char* text, size_t length)
+	{
+		size_t room = size - 1 - written;
+		length = length < room ? length : room;
+		memcpy(buffer + written, text, length);
+		written += length;
+	};
+
+	// Arguments are consumed in order, by conversions and * alike
+	auto readArg = [&](LogArg& arg)
+	{
+		if (argIndex >= record.ArgCount)
+			return false;
+
+		arg.Type = static_cast<LogArgType>(record.Payload[payload]);
+
+		if (arg.Type == LogArgType::String)
+		{
+			uint16_t length;
+			memcpy(&length, record.Payload + payload + 1, sizeof(length));
+			arg.Text = reinterpret_cast<const char*>(record.Payload + payload + 3);
+			arg.TextLength = length;
+			payload += 3 + length;
+		}
+		else
+		{
+			arg.Size = record.Payload[payload + 1];
+			memcpy(&arg.Bits, record.Payload + payload + 2, sizeof(arg.Bits));
+			payload += 2 + sizeof(arg.Bits);
+		}
+
+		++argIndex;
+		return true;
+	};
+
+	for (const char* p = record.Format; *p != '\0' && written < size - 1; )
+	{
+		if (*p != '%')
+		{
+			const char* next = strchr(p, '%');
+			size_t length = next ? static_cast<size_t>(next - p) : strlen(p);
+			append(p, length);
+			p += length;
+			continue;
+		}
+
+		if (p[1] == '%')
+		{
+			append("%", 1);
+			p += 2;
+			continue;
+		}
+
+		// Flags, width and precision are kept, length modifiers are replaced.
+		// A * width or precision is spelled out from the argument it consumes.
+		char flags[24];
+		size_t flagsLength = 0;
+		const char* q = p + 1;
+
+		for (; *q != '\0' && strchr("-+ #0123456789.*", *q); ++q)
+		{
+			if (*q != '*')
+			{
+				if (flagsLength < sizeof(flags) - 1)
+					flags[flagsLength++] = *q;
+
+				continue;
+			}
+
+			LogArg star;
+
+			if (!readArg(star))
+				continue;
+
+			// The compile-time check makes it an int
+			int value = static_cast<int>(star.Bits);
+			bool precision = flagsLength > 0 && flags[flagsLength - 1] == '.';
+
+			// As in printf, a negative width left-justifies and a negative precision is as if omitted
+			if (precision && value < 0)
+			{
+				--flagsLength;
+				continue;
+			}
+
+			int digits = snprintf(flags + flagsLength, sizeof(flags) - flagsLength, "%d", value);
+
+			if (digits > 0)
+				flagsLength = std::min(flagsLength + static_cast<size_t>(digits), sizeof(flags) - 1);
+		}
+
+		// Terminated for the precision parse in FormatArg
+		flags[flagsLength] = '\0';
+
+		while (*q != '\0' && strchr("hlLqjzt", *q)) ++q;
+
+		char conversion = *q;
+		p = *q != '\0' ? q + 1 : q;
+
+		LogArg arg;
+
+		if (!readArg(arg))
+		{
+			append("<?>", 3);
+			continue;
+		}
+
+		int length = FormatArg(buffer + written, size - written, flags, flagsLength, conversion, arg.Type, arg.Size, arg.Bits, arg.Text, arg.TextLength);
+
+		if (length > 0)
+			written += static_cast<size_t>(length) < size - 1 - written ? static_cast<size_t>(length) : size - 1 - written;
+	}
+
+	buffer[written] = '\0';
+	return written;
+}
+
+void Gears::LogEncoder::AddString(const char* value)
+{
+	if (m_Record.PayloadSize + 3u > sizeof(m_Record.Payload))
+		return;
+
+	size_t room = sizeof(m_Record.Payload) - m_Record.PayloadSize - 3;
+	size_t length = strnlen(value, room);
+	uint16_t stored = static_cast<uint16_t>(length);
+
+	uint8_t* out = m_Record.Payload + m_Record.PayloadSize;
+	out[0] = static_cast<uint8_t>(LogArgType::String);
+	memcpy(out + 1, &stored, sizeof(stored));
+	memcpy(out + 3, value, length);
+
+	m_Record.PayloadSize += static_cast<uint16_t>(3 + length);
+	++m_Record.ArgCount;
+}
+
+Gears::LogRecord& Gears::LogBegin(LogLevel level, const char* format)
+{
+	if (!t_Ring.Ring)
+		t_Ring.Ring = Logger::Get().Register();
+
+	LogRing& ring = *t_Ring.Ring;
+	uint32_t head = ring.Head.load(std::memory_order_relaxed);
+
+	// Full means the writer is LOG_RING_SIZE records behind, wait rather than drop
+	while (head - ring.Tail.load(std::memory_order_acquire) >= LOG_RING_SIZE)
+	{
+		Logger::Get().Wake();
+		std::this_thread::yield();
+	}
+
+	LogRecord& record = ring.Records[head % LOG_RING_SIZE];
+	record.Sequence = g_Sequence.fetch_add(1, std::memory_order_relaxed);
+	record.Format = format;
+	record.ThreadId = ring.ThreadId;
+	record.Level = level;
+	record.ArgCount = 0;
+	record.PayloadSize = 0;
+
+	return record;
+}
+
+void Gears::LogCommit(LogRecord& record)
+{
+	LogRing& ring = *t_Ring.Ring;
+	uint32_t head = ring.Head.load(std::memory_order_relaxed) + 1;
+
+	ring.Head.store(head, std::memory_order_release);
+
+	// Errors go out promptly, everything else waits for the writer's next pass unless the ring is filling up
+	if (record.Level == LogLevel::Error || head - ring.Tail.load(std::memory_order_relaxed) == LOG_RING_SIZE / 2)
+		Logger::Get().Wake();
+}
+
+void Gears::AddLogSink(std::unique_ptr<LogSink> sink)
+{
+	Logger::Get().AddSink(std::move(sink));
+}
+
+std::vector<std::unique_ptr<Gears::LogSink>> Gears::SwapLogSinks(std::vector<std::unique_ptr<LogSink>> sinks)
+{
+	return Logger::Get().SwapSinks(std::move(sinks));
+}
+
+void Gears::FlushLog()
+{
+	Logger::Get().Flush();
+}
@@ -0,0 +1,351 @@
+#include "memory_allocator.h"
+#include "Logger.h"
+
+namespace
+{
+	VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+Gears::MemoryAllocator::~MemoryAllocator()
+{
+	Destroy();
+}
+
+void Gears::MemoryAllocator::Init(VkPhysicalDevice physicalDevice, VkDevice device, VkDeviceSize blockSize,
+	const VkAllocationCallbacks* callbacks)
+{
+	m_Device = device;
+	m_AllocationCallbacks = callbacks;
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_MemoryProperties);
+
+	m_BufferImageGranularity = properties.limits.bufferImageGranularity > 0 ? properties.limits.bufferImageGranularity : 1;
+	m_MaxAllocationCount = properties.limits.maxMemoryAllocationCount;
+	m_Pools = std::vector<MemoryPool>(m_MemoryProperties.memoryTypeCount);
+
+	for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i)
+	{
+		// Small heaps (e.g. 256MB host-visible device-local) get smaller blocks
+		VkDeviceSize heapSize = m_MemoryProperties.memoryHeaps[m_MemoryProperties.memoryTypes[i].heapIndex].size;
+		m_Pools[i].BlockSize = heapSize / 8 < blockSize ? heapSize / 8 : blockSize;
+	}
+
+	LOGI("Memory allocator: %u types, %u heaps, granularity %llu",
+		m_MemoryProperties.memoryTypeCount, m_MemoryProperties.memoryHeapCount,
+		static_cast<unsigned long long>(m_BufferImageGranularity));
+}
+
+void Gears::MemoryAllocator::Destroy()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	for (auto& pool : m_Pools)
+	{
+		for (auto& block : pool.Blocks)
+		{
+			if (!block)
+				continue;
+
+			if (!block->Ranges.IsEmpty())
+				LOGE("GearsError::Destroying memory block with %u live allocations", block->Ranges.GetStats().AllocationCount);
+
+			FreeDeviceMemory(block->Memory, block->Mapped);
+		}
+
+		pool.Blocks.clear();
+	}
+
+	m_Pools.clear();
+}
+
+bool Gears::MemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, ResourceKind kind, Allocation& allocation)
+{
+	uint32_t memoryType = FindMemoryType(requirements.memoryTypeBits, properties);
+
+	if (memoryType == UINT32_MAX)
+	{
+		LOGE("GearsError::No memory type for bits 0x%x with properties 0x%x", requirements.memoryTypeBits, properties);
+		return false;
+	}
+
+	VkDeviceSize size = requirements.size;
+	VkDeviceSize alignment = requirements.alignment > 0 ? requirements.alignment : 1;
+
+	// Padding optimal resources out to whole granularity pages keeps linear
+	// neighbours off their pages without tracking what sits next to what
+	if (kind == ResourceKind::Optimal && m_BufferImageGranularity > alignment)
+	{
+		alignment = AlignUp(m_BufferImageGranularity, alignment);
+		size = AlignUp(size, m_BufferImageGranularity);
+	}
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto& pool = m_Pools[memoryType];
+
+	allocation = {};
+	allocation.MemoryType = memoryType;
+	allocation.Size = requirements.size;
+
+	// Anything bigger than half a block would mostly waste it
+	if (size > pool.BlockSize / 2)
+	{
+		if (!AllocateDeviceMemory(memoryType, size, allocation.Memory, allocation.Mapped))
+			return false;
+
+		++pool.DedicatedCount;
+		return true;
+	}
+
+	uint32_t emptySlot = static_cast<uint32_t>(pool.Blocks.size());
+
+	for (uint32_t i = 0; i < pool.Blocks.size(); ++i)
+	{
+		if (!pool.Blocks[i])
+		{
+			emptySlot = i < emptySlot ? i : emptySlot;
+			continue;
+		}
+
+		auto& block = *pool.Blocks[i];
+
+		if (block.Ranges.Allocate(size, alignment, allocation.Range))
+		{
+			allocation.Memory = block.Memory;
+			allocation.Offset = allocation.Range.Offset;
+			allocation.Mapped = block.Mapped ? static_cast<uint8_t*>(block.Mapped) + allocation.Offset : nullptr;
+			allocation.Block = i;
+			return true;
+		}
+	}
+
+	auto block = std::make_unique<Block>();
+
+	if (!AllocateDeviceMemory(memoryType, pool.BlockSize, block->Memory, block->Mapped))
+		return false;
+
+	block->Ranges.Init(pool.BlockSize);
+
+	// Alignment can push even a half-block request past the end, a block
+	// of its own is then still the cheapest fit
+	if (!block->Ranges.Allocate(size, alignment, allocation.Range))
+	{
+		FreeDeviceMemory(block->Memory, block->Mapped);
+
+		if (!AllocateDeviceMemory(memoryType, size, allocation.Memory, allocation.Mapped))
+			return false;
+
+		++pool.DedicatedCount;
+		return true;
+	}
+
+	allocation.Memory = block->Memory;
+	allocation.Offset = allocation.Range.Offset;
+	allocation.Mapped = block->Mapped ? static_cast<uint8_t*>(block->Mapped) + allocation.Offset : nullptr;
+	allocation.Block = emptySlot;
+
+	// Released blocks leave a hole so live allocations keep their block index
+	if (emptySlot == pool.Blocks.size())
+		pool.Blocks.push_back(std::move(block));
+	else
+		pool.Blocks[emptySlot] = std::move(block);
+
+	return true;
+}
+
+void Gears::MemoryAllocator::Free(const Allocation& allocation)
+{
+	if (allocation.Memory == VK_NULL_HANDLE)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto& pool = m_Pools[allocation.MemoryType];
+
+	if (allocation.Block == UINT32_MAX)
+	{
+		FreeDeviceMemory(allocation.Memory, allocation.Mapped);
+		--pool.DedicatedCount;
+		return;
+	}
+
+	auto& block = pool.Blocks[allocation.Block];
+	block->Ranges.Free(allocation.Range);
+
+	// The first block is kept even when empty so a pool oscillating around
+	// a block boundary does not thrash vkAllocateMemory
+	if (allocation.Block != 0 && block->Ranges.IsEmpty())
+	{
+		FreeDeviceMemory(block->Memory, block->Mapped);
+		block.reset();
+	}
+}
+
+bool Gears::MemoryAllocator::AllocateForBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties, Allocation& allocation)
+{
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(m_Device, buffer, &requirements);
+
+	if (!Allocate(requirements, properties, ResourceKind::Linear, allocation))
+		return false;
+
+	if (vkBindBufferMemory(m_Device, buffer, allocation.Memory, allocation.Offset) != VK_SUCCESS)
+	{
+		Free(allocation);
+		return false;
+	}
+
+	return true;
+}
+
+bool Gears::MemoryAllocator::AllocateForImage(VkImage image, VkImageTiling tiling, VkMemoryPropertyFlags properties, Allocation& allocation)
+{
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(m_Device, image, &requirements);
+
+	ResourceKind kind = tiling == VK_IMAGE_TILING_LINEAR ? ResourceKind::Linear : ResourceKind::Optimal;
+
+	if (!Allocate(requirements, properties, kind, allocation))
+		return false;
+
+	if (vkBindImageMemory(m_Device, image, allocation.Memory, allocation.Offset) != VK_SUCCESS)
+	{
+		Free(allocation);
+		return false;
+	}
+
+	return true;
+}
+
+uint32_t Gears::MemoryAllocator::FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const
+{
+	for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i)
+	{
+		if ((typeBits & (1u << i)) && (m_MemoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+			return i;
+	}
+
+	return UINT32_MAX;
+}
+
+Gears::MemoryStats Gears::MemoryAllocator::GetStats(uint32_t memoryType) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	MemoryStats stats{};
+	stats.DeviceAllocationCount = m_DeviceAllocationCount;
+
+	if (memoryType >= m_Pools.size())
+		return stats;
+
+	const auto& pool = m_Pools[memoryType];
+	stats.DedicatedCount = pool.DedicatedCount;
+
+	for (const auto& block : pool.Blocks)
+	{
+		if (!block)
+			continue;
+
+		++stats.BlockCount;
+		TlsfStats blockStats = block->Ranges.GetStats();
+
+		stats.Blocks.TotalSize += blockStats.TotalSize;
+		stats.Blocks.UsedSize += blockStats.UsedSize;
+		stats.Blocks.FreeSize += blockStats.FreeSize;
+		stats.Blocks.AllocationCount += blockStats.AllocationCount;
+		stats.Blocks.FreeBlockCount += blockStats.FreeBlockCount;
+
+		if (blockStats.LargestFreeBlock > stats.Blocks.LargestFreeBlock)
+			stats.Blocks.LargestFreeBlock = blockStats.LargestFreeBlock;
+	}
+
+	return stats;
+}
+
+Gears::MemoryStats Gears::MemoryAllocator::GetStats() const
+{
+	MemoryStats total{};
+
+	for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i)
+	{
+		MemoryStats stats = GetStats(i);
+
+		total.BlockCount += stats.BlockCount;
+		total.DedicatedCount += stats.DedicatedCount;
+		total.DeviceAllocationCount = stats.DeviceAllocationCount;
+		total.Blocks.TotalSize += stats.Blocks.TotalSize;
+		total.Blocks.UsedSize += stats.Blocks.UsedSize;
+		total.Blocks.FreeSize += stats.Blocks.FreeSize;
+		total.Blocks.AllocationCount += stats.Blocks.AllocationCount;
+		total.Blocks.FreeBlockCount += stats.Blocks.FreeBlockCount;
+
+		if (stats.Blocks.LargestFreeBlock > total.Blocks.LargestFreeBlock)
+			total.Blocks.LargestFreeBlock = stats.Blocks.LargestFreeBlock;
+	}
+
+	return total;
+}
+
+void Gears::MemoryAllocator::LogStats() const
+{
+	for (uint32_t i = 0; i < m_MemoryProperties.memoryTypeCount; ++i)
+	{
+		MemoryStats stats = GetStats(i);
+
+		if (stats.BlockCount == 0 && stats.DedicatedCount == 0)
+			continue;
+
+		LOGI("Memory type %u: %u blocks, %u dedicated, %u allocations, %llu/%llu bytes used, %u free ranges, fragmentation %.2f",
+			i, stats.BlockCount, stats.DedicatedCount, stats.Blocks.AllocationCount,
+			static_cast<unsigned long long>(stats.Blocks.UsedSize), static_cast<unsigned long long>(stats.Blocks.TotalSize),
+			stats.Blocks.FreeBlockCount, stats.Blocks.Fragmentation());
+	}
+}
+
+bool Gears::MemoryAllocator::AllocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, VkDeviceMemory& memory, void*& mapped)
+{
+	if (m_MaxAllocationCount != 0 && m_DeviceAllocationCount >= m_MaxAllocationCount)
+	{
+		LOGE("GearsError::maxMemoryAllocationCount (%u) reached", m_MaxAllocationCount);
+		return false;
+	}
+
+	VkMemoryAllocateInfo allocateInfo{};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize = size;
+	allocateInfo.memoryTypeIndex = memoryType;
+
+	if (vkAllocateMemory(m_Device, &allocateInfo, m_AllocationCallbacks, &memory) != VK_SUCCESS)
+	{
+		LOGE("GearsError::vkAllocateMemory failed for %llu bytes of type %u", static_cast<unsigned long long>(size), memoryType);
+		return false;
+	}
+
+	mapped = nullptr;
+
+	// Host-visible memory stays mapped for its whole life, mapping is not free on every driver
+	if (m_MemoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+	{
+		if (vkMapMemory(m_Device, memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS)
+			mapped = nullptr;
+	}
+
+	++m_DeviceAllocationCount;
+
+	if (m_MaxAllocationCount != 0 && m_DeviceAllocationCount == m_MaxAllocationCount - m_MaxAllocationCount / 8)
+		LOGW("GearsWarning::%u of %u device memory allocations in use", m_DeviceAllocationCount, m_MaxAllocationCount);
+
+	return true;
+}
+
+void Gears::MemoryAllocator::FreeDeviceMemory(VkDeviceMemory memory, void* mapped)
+{
+	if (mapped != nullptr)
+		vkUnmapMemory(m_Device, memory);
+
+	vkFreeMemory(m_Device, memory, m_AllocationCallbacks);
+	--m_DeviceAllocationCount;
+}
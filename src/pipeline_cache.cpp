@@ -0,0 +1,154 @@
+#include "pipeline_cache.h"
+#include "cache_file.h"
+#include "Logger.h"
+
+#include <cstdio>
+#include <cstring>
+
+Gears::PipelineCache::~PipelineCache()
+{
+	Destroy();
+}
+
+bool Gears::PipelineCache::Create(VkDevice device, const VkPhysicalDeviceProperties& properties, std::string path,
+	const VkAllocationCallbacks* callbacks)
+{
+	m_Device = device;
+	m_AllocationCallbacks = callbacks;
+	m_Properties = properties;
+	m_Path = std::move(path);
+
+	auto file = ReadCacheFile(m_Path);
+	const uint8_t* initialData = nullptr;
+	size_t initialSize = 0;
+
+	if (file.size() >= sizeof(PipelineCacheHeader))
+	{
+		PipelineCacheHeader header;
+		std::memcpy(&header, file.data(), sizeof(header));
+
+		const uint8_t* blob = file.data() + sizeof(header);
+		const size_t blobSize = file.size() - sizeof(header);
+
+		if (Validate(header, properties, blob, blobSize))
+		{
+			initialData = blob;
+			initialSize = blobSize;
+		}
+		else
+		{
+			LOGI("Pipeline cache at %s is stale or corrupt, starting empty", m_Path.c_str());
+		}
+	}
+
+	VkPipelineCacheCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	createInfo.initialDataSize = initialSize;
+	createInfo.pInitialData = initialData;
+
+	if (vkCreatePipelineCache(m_Device, &createInfo, m_AllocationCallbacks, &m_Cache) != VK_SUCCESS)
+	{
+		LOGE("GearsError::Failed to create pipeline cache");
+		m_Cache = VK_NULL_HANDLE;
+		return false;
+	}
+
+	LOGI("Pipeline cache loaded: %zu bytes", initialSize);
+	return initialSize > 0;
+}
+
+void Gears::PipelineCache::Destroy()
+{
+	WaitForSave();
+
+	if (m_Cache != VK_NULL_HANDLE)
+	{
+		vkDestroyPipelineCache(m_Device, m_Cache, m_AllocationCallbacks);
+		m_Cache = VK_NULL_HANDLE;
+	}
+}
+
+void Gears::PipelineCache::SaveAsync()
+{
+	if (m_Cache == VK_NULL_HANDLE)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_SaveMutex);
+
+	if (m_SaveThread.joinable())
+		m_SaveThread.join();
+
+	// The cache is internally synchronized, so the blob can be pulled off-thread too
+	m_SaveThread = std::thread([this]()
+	{
+		size_t size = 0;
+
+		if (vkGetPipelineCacheData(m_Device, m_Cache, &size, nullptr) != VK_SUCCESS || size == 0)
+			return;
+
+		std::vector<uint8_t> data(sizeof(PipelineCacheHeader) + size);
+
+		if (vkGetPipelineCacheData(m_Device, m_Cache, &size, data.data() + sizeof(PipelineCacheHeader)) != VK_SUCCESS)
+			return;
+
+		data.resize(sizeof(PipelineCacheHeader) + size);
+
+		PipelineCacheHeader header = MakeHeader(m_Properties, data.data() + sizeof(PipelineCacheHeader), size);
+		std::memcpy(data.data(), &header, sizeof(header));
+
+		if (WriteCacheFile(m_Path, data))
+			LOGI("Pipeline cache saved: %zu bytes", data.size());
+	});
+}
+
+void Gears::PipelineCache::WaitForSave()
+{
+	std::lock_guard<std::mutex> lock(m_SaveMutex);
+
+	if (m_SaveThread.joinable())
+		m_SaveThread.join();
+}
+
+Gears::PipelineCacheHeader Gears::PipelineCache::MakeHeader(const VkPhysicalDeviceProperties& properties, const void* data, size_t size)
+{
+	PipelineCacheHeader header{};
+	header.Magic = PIPELINE_CACHE_MAGIC;
+	header.Version = PIPELINE_CACHE_VERSION;
+	header.VendorID = properties.vendorID;
+	header.DeviceID = properties.deviceID;
+	header.DriverVersion = properties.driverVersion;
+	std::memcpy(header.PipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+	header.DataSize = size;
+	header.DataHash = HashCacheData(data, size);
+
+	return header;
+}
+
+bool Gears::PipelineCache::Validate(const PipelineCacheHeader& header, const VkPhysicalDeviceProperties& properties, const void* data, size_t size)
+{
+	if (header.Magic != PIPELINE_CACHE_MAGIC || header.Version != PIPELINE_CACHE_VERSION)
+		return false;
+
+	if (header.VendorID != properties.vendorID ||
+		header.DeviceID != properties.deviceID ||
+		header.DriverVersion != properties.driverVersion ||
+		std::memcmp(header.PipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+		return false;
+
+	if (header.DataSize != size || header.DataHash != HashCacheData(data, size))
+		return false;
+
+	// The driver's own VkPipelineCacheHeaderVersionOne must agree as well
+	struct { uint32_t Size, Version, VendorID, DeviceID; uint8_t UUID[VK_UUID_SIZE]; } vkHeader;
+
+	if (size < sizeof(vkHeader))
+		return false;
+
+	std::memcpy(&vkHeader, data, sizeof(vkHeader));
+
+	return vkHeader.Size >= sizeof(vkHeader) &&
+		vkHeader.Version == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+		vkHeader.VendorID == properties.vendorID &&
+		vkHeader.DeviceID == properties.deviceID &&
+		std::memcmp(vkHeader.UUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
@@ -0,0 +1,282 @@
+#include "profiler.h"
+#include "Logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+#ifdef __ANDROID__
+#include <dlfcn.h>
+#endif
+
+namespace
+{
+	struct alignas(64) ProfileRing
+	{
+		Gears::ProfileEvent               Events[Gears::PROFILE_RING_SIZE];
+		alignas(64) std::atomic<uint32_t> Head{ 0 }; // Written by the owning thread
+		alignas(64) std::atomic<uint32_t> Tail{ 0 }; // Written by the collector
+		uint32_t                          ThreadId = 0;
+	};
+
+	// Keeps rings alive past their thread so late events still get collected
+	class Profiler
+	{
+		public:
+
+		static Profiler& Get()
+		{
+			static Profiler profiler;
+			return profiler;
+		}
+
+		std::shared_ptr<ProfileRing> Register()
+		{
+			auto ring = std::make_shared<ProfileRing>();
+
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			ring->ThreadId = m_NextThreadId++;
+			m_Rings.push_back(ring);
+			return ring;
+		}
+
+		std::vector<Gears::ProfileEvent> Collect()
+		{
+			std::vector<Gears::ProfileEvent> events;
+			std::lock_guard<std::mutex> lock(m_Mutex);
+
+			for (auto& ring : m_Rings)
+			{
+				uint32_t tail = ring->Tail.load(std::memory_order_relaxed);
+				uint32_t head = ring->Head.load(std::memory_order_acquire);
+
+				for (; tail != head; ++tail)
+					events.push_back(ring->Events[tail % Gears::PROFILE_RING_SIZE]);
+
+				ring->Tail.store(tail, std::memory_order_release);
+			}
+
+			return events;
+		}
+
+		std::chrono::steady_clock::time_point Origin = std::chrono::steady_clock::now();
+		std::atomic<uint64_t>                 Dropped{ 0 };
+		std::atomic<int64_t>                  FrameNumber{ 0 };
+
+		private:
+
+		std::vector<std::shared_ptr<ProfileRing>> m_Rings;
+		std::mutex                                m_Mutex;
+		uint32_t                                  m_NextThreadId = 0;
+	};
+
+	ProfileRing& GetThreadRing()
+	{
+		thread_local std::shared_ptr<ProfileRing> ring = Profiler::Get().Register();
+		return *ring;
+	}
+
+	void Record(Gears::ProfileEventType type, const char* name, uint64_t startNs, int64_t value, bool gpu)
+	{
+		ProfileRing& ring = GetThreadRing();
+		uint32_t head = ring.Head.load(std::memory_order_relaxed);
+
+		if (head - ring.Tail.load(std::memory_order_acquire) >= Gears::PROFILE_RING_SIZE)
+		{
+			Profiler::Get().Dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		Gears::ProfileEvent& event = ring.Events[head % Gears::PROFILE_RING_SIZE];
+		event.Name = name;
+		event.StartNs = startNs;
+		event.Value = value;
+		event.ThreadId = gpu ? Gears::PROFILE_GPU_THREAD_ID : ring.ThreadId;
+		event.Type = type;
+
+		ring.Head.store(head + 1, std::memory_order_release);
+	}
+
+#ifdef __ANDROID__
+	// Loaded at runtime, the NDK only declares these from API 23 and 29 on
+	struct ATrace
+	{
+		bool (*IsEnabled)() = nullptr;
+		void (*BeginSection)(const char*) = nullptr;
+		void (*EndSection)() = nullptr;
+		void (*SetCounter)(const char*, int64_t) = nullptr;
+
+		static const ATrace& Get()
+		{
+			static const ATrace trace = Load();
+			return trace;
+		}
+
+		static ATrace Load()
+		{
+			ATrace trace;
+
+			if (void* library = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL))
+			{
+				trace.IsEnabled = reinterpret_cast<bool (*)()>(dlsym(library, "ATrace_isEnabled"));
+				trace.BeginSection = reinterpret_cast<void (*)(const char*)>(dlsym(library, "ATrace_beginSection"));
+				trace.EndSection = reinterpret_cast<void (*)()>(dlsym(library, "ATrace_endSection"));
+				trace.SetCounter = reinterpret_cast<void (*)(const char*, int64_t)>(dlsym(library, "ATrace_setCounter"));
+			}
+
+			return trace;
+		}
+
+		bool Enabled() const { return IsEnabled && BeginSection && EndSection && IsEnabled(); }
+	};
+#endif
+}
+
+Gears::ProfileZone::ProfileZone(const char* name) :
+	m_Name( name ),
+	m_Start( ProfileNow() )
+{
+#ifdef __ANDROID__
+	// Perfetto and systrace pick these up alongside the system's own tracks
+	const ATrace& trace = ATrace::Get();
+	m_Traced = trace.Enabled();
+
+	if (m_Traced)
+		trace.BeginSection(name);
+#endif
+}
+
+Gears::ProfileZone::~ProfileZone()
+{
+	uint64_t end = ProfileNow();
+	ProfileRecord(ProfileEventType::Zone, m_Name, m_Start, static_cast<int64_t>(end - m_Start));
+
+#ifdef __ANDROID__
+	// Only ends what was begun, tracing may have started or stopped meanwhile
+	if (m_Traced)
+		ATrace::Get().EndSection();
+#endif
+}
+
+uint64_t Gears::ProfileNow()
+{
+	using namespace std::chrono;
+	return duration_cast<nanoseconds>(steady_clock::now() - Profiler::Get().Origin).count();
+}
+
+void Gears::ProfileRecord(ProfileEventType type, const char* name, uint64_t startNs, int64_t value)
+{
+	Record(type, name, startNs, value, false);
+}
+
+void Gears::ProfileCounter(const char* name, int64_t value)
+{
+	ProfileRecord(ProfileEventType::Counter, name, ProfileNow(), value);
+
+#ifdef __ANDROID__
+	const ATrace& trace = ATrace::Get();
+	if (trace.SetCounter && trace.Enabled())
+		trace.SetCounter(name, value);
+#endif
+}
+
+void Gears::ProfileGpuZone(const char* name, uint64_t startNs, int64_t durationNs)
+{
+	// Recorded by whichever thread resolved the queries, but shown on a track of its own
+	Record(ProfileEventType::Zone, name, startNs, durationNs, true);
+}
+
+void Gears::ProfileFrame()
+{
+	int64_t frame = Profiler::Get().FrameNumber.fetch_add(1, std::memory_order_relaxed);
+	ProfileRecord(ProfileEventType::Frame, "Frame", ProfileNow(), frame);
+}
+
+std::vector<Gears::ProfileEvent> Gears::CollectProfileEvents()
+{
+	return Profiler::Get().Collect();
+}
+
+uint64_t Gears::GetDroppedProfileEvents()
+{
+	return Profiler::Get().Dropped.load(std::memory_order_relaxed);
+}
+
+std::string Gears::ProfileToChromeTrace(const std::vector<ProfileEvent>& events)
+{
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	char buffer[160];
+
+	// Names the GPU's track, thread ids are otherwise shown as they are
+	for (const auto& i : events)
+		if (i.ThreadId == PROFILE_GPU_THREAD_ID)
+		{
+			snprintf(buffer, sizeof(buffer), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu32 ",\"args\":{\"name\":\"GPU\"}}",
+				PROFILE_GPU_THREAD_ID);
+			json += buffer;
+			break;
+		}
+
+	for (size_t i = 0; i < events.size(); ++i)
+	{
+		const ProfileEvent& event = events[i];
+
+		if (json.back() != '[')
+			json += ',';
+
+		// Zone names are identifiers, anything needing escapes is dropped rather than breaking the file
+		json += "{\"name\":\"";
+
+		for (const char* c = event.Name; *c; ++c)
+			if (*c != '"' && *c != '\\' && static_cast<unsigned char>(*c) >= 0x20)
+				json += *c;
+
+		// Timestamps in microseconds
+		switch (event.Type)
+		{
+			case ProfileEventType::Zone:
+				snprintf(buffer, sizeof(buffer), "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32 ",\"ts\":%.3f,\"dur\":%.3f}",
+					event.ThreadId, event.StartNs / 1e3, event.Value / 1e3);
+				break;
+			case ProfileEventType::Counter:
+				snprintf(buffer, sizeof(buffer), "\",\"cat\":\"cpu\",\"ph\":\"C\",\"pid\":1,\"tid\":%" PRIu32 ",\"ts\":%.3f,\"args\":{\"value\":%" PRId64 "}}",
+					event.ThreadId, event.StartNs / 1e3, event.Value);
+				break;
+			case ProfileEventType::Frame:
+				snprintf(buffer, sizeof(buffer), "\",\"cat\":\"cpu\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":%" PRIu32 ",\"ts\":%.3f,\"args\":{\"frame\":%" PRId64 "}}",
+					event.ThreadId, event.StartNs / 1e3, event.Value);
+				break;
+		}
+
+		json += buffer;
+	}
+
+	json += "]}";
+	return json;
+}
+
+bool Gears::WriteProfileTrace(const std::string& path)
+{
+	auto events = CollectProfileEvents();
+	std::string json = ProfileToChromeTrace(events);
+	FILE* file = fopen(path.c_str(), "wb");
+
+	if (file == nullptr)
+	{
+		LOGE("GearsError::Could not open %s for writing", path.c_str());
+		return false;
+	}
+
+	bool written = fwrite(json.data(), 1, json.size(), file) == json.size();
+	written = (fclose(file) == 0) && written;
+
+	if (!written)
+		LOGE("GearsError::Failed to write profile trace to %s", path.c_str());
+	else
+		LOGI("Wrote %zu profile events to %s, %" PRIu64 " dropped", events.size(), path.c_str(), GetDroppedProfileEvents());
+
+	return written;
+}
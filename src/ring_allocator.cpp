@@ -0,0 +1,42 @@
+#include "ring_allocator.h"
+
+void Gears::RingAllocator::Init(uint64_t capacity)
+{
+	m_Capacity = capacity;
+	m_Head = 0;
+	m_Tail = 0;
+}
+
+bool Gears::RingAllocator::Allocate(uint64_t size, uint64_t alignment, uint64_t& offset)
+{
+	if (size == 0 || size > m_Capacity)
+		return false;
+
+	uint64_t position = m_Head;
+	uint64_t wrapped = position % m_Capacity;
+	uint64_t aligned = (wrapped + alignment - 1) / alignment * alignment;
+
+	// Skip the tail end of the range when the allocation would straddle it
+	if (aligned + size > m_Capacity)
+	{
+		position += m_Capacity - wrapped;
+		aligned = 0;
+	}
+	else
+	{
+		position += aligned - wrapped;
+	}
+
+	if (position + size - m_Tail > m_Capacity)
+		return false;
+
+	m_Head = position + size;
+	offset = aligned;
+	return true;
+}
+
+void Gears::RingAllocator::Release(uint64_t marker)
+{
+	if (marker > m_Tail && marker <= m_Head)
+		m_Tail = marker;
+}
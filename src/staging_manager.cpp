@@ -0,0 +1,431 @@
+#include "staging_manager.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Covers the optimal copy offset alignment and texel block size of every format we upload
+static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+Gears::StagingManager::~StagingManager()
+{
+	Destroy();
+}
+
+bool Gears::StagingManager::Init(VkDevice device, MemoryAllocator& allocator, uint32_t queueFamily, VkQueue queue,
+	uint32_t dstQueueFamily, std::mutex* queueMutex, VkDeviceSize size, const VkAllocationCallbacks* callbacks)
+{
+	m_Device = device;
+	m_AllocationCallbacks = callbacks;
+	m_Queue = queue;
+	m_QueueMutex = queueMutex;
+	m_QueueFamily = queueFamily;
+	m_DstQueueFamily = dstQueueFamily;
+	m_Allocator = &allocator;
+
+	VkBufferCreateInfo bufferInfo{};
+	bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	bufferInfo.size = size;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	if (vkCreateBuffer(m_Device, &bufferInfo, m_AllocationCallbacks, &m_Buffer) != VK_SUCCESS)
+	{
+		LOGE("GearsError::Failed to create staging buffer");
+		return false;
+	}
+
+	// Coherent memory saves a vkFlushMappedMemoryRanges per flush
+	if (!allocator.AllocateForBuffer(m_Buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_Memory) || m_Memory.Mapped == nullptr)
+	{
+		LOGE("GearsError::Failed to allocate mapped staging memory");
+		return false;
+	}
+
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = queueFamily;
+
+	if (vkCreateCommandPool(m_Device, &poolInfo, m_AllocationCallbacks, &m_CommandPool) != VK_SUCCESS)
+	{
+		LOGE("GearsError::Failed to create staging command pool");
+		return false;
+	}
+
+	m_Ring.Init(size);
+
+	LOGI("Staging ring: %llu bytes on queue family %u", static_cast<unsigned long long>(size), queueFamily);
+	return true;
+}
+
+void Gears::StagingManager::Destroy()
+{
+	if (m_Device == VK_NULL_HANDLE)
+		return;
+
+	WaitIdle();
+
+	for (auto& submission : m_FreeSubmissions)
+		vkDestroyFence(m_Device, submission.Fence, m_AllocationCallbacks);
+
+	m_FreeSubmissions.clear();
+
+	// Destroying the pool frees its command buffers
+	if (m_CommandPool != VK_NULL_HANDLE)
+		vkDestroyCommandPool(m_Device, m_CommandPool, m_AllocationCallbacks);
+
+	if (m_Buffer != VK_NULL_HANDLE)
+		vkDestroyBuffer(m_Device, m_Buffer, m_AllocationCallbacks);
+
+	m_Allocator->Free(m_Memory);
+
+	m_CommandPool = VK_NULL_HANDLE;
+	m_Buffer = VK_NULL_HANDLE;
+	m_Memory = {};
+	m_Device = VK_NULL_HANDLE;
+}
+
+bool Gears::StagingManager::UploadToBuffer(VkBuffer buffer, VkDeviceSize offset, const void* data, VkDeviceSize size)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	VkDeviceSize stagingOffset;
+
+	if (Stage(data, size, STAGING_ALIGNMENT, stagingOffset) == nullptr)
+		return false;
+
+	m_BufferCopies.push_back({ buffer, { stagingOffset, offset, size } });
+	return true;
+}
+
+bool Gears::StagingManager::UploadToImage(VkImage image, VkBufferImageCopy region, const void* data, VkDeviceSize size)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (Stage(data, size, STAGING_ALIGNMENT, region.bufferOffset) == nullptr)
+		return false;
+
+	m_ImageCopies.push_back({ image, region });
+	return true;
+}
+
+void* Gears::StagingManager::Stage(const void* data, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+{
+	if (size > m_Ring.GetCapacity())
+	{
+		LOGE("GearsError::Upload of %llu bytes exceeds the staging ring", static_cast<unsigned long long>(size));
+		return nullptr;
+	}
+
+	uint64_t ringOffset;
+
+	// Full ring: push out what is queued, then retire submissions oldest first until it fits
+	while (!m_Ring.Allocate(size, alignment, ringOffset))
+	{
+		if (!m_BufferCopies.empty() || !m_ImageCopies.empty())
+			FlushLocked();
+
+		if (m_InFlight.empty())
+			return nullptr;
+
+		ReclaimLocked(true);
+	}
+
+	void* destination = static_cast<uint8_t*>(m_Memory.Mapped) + ringOffset;
+	memcpy(destination, data, size);
+
+	offset = ringOffset;
+	return destination;
+}
+
+void Gears::StagingManager::Flush()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	FlushLocked();
+}
+
+void Gears::StagingManager::FlushLocked()
+{
+	if (m_BufferCopies.empty() && m_ImageCopies.empty())
+		return;
+
+	Submission submission;
+
+	if (!AcquireSubmission(submission))
+		return;
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(submission.CommandBuffer, &beginInfo) != VK_SUCCESS)
+	{
+		m_FreeSubmissions.push_back(std::move(submission));
+		return;
+	}
+
+	// Group regions by destination so each buffer gets one vkCmdCopyBuffer
+	std::stable_sort(m_BufferCopies.begin(), m_BufferCopies.end(),
+		[](const BufferCopy& a, const BufferCopy& b) { return a.Buffer < b.Buffer; });
+
+	std::vector<VkBufferCopy> regions;
+	regions.reserve(m_BufferCopies.size());
+
+	for (size_t i = 0; i < m_BufferCopies.size(); )
+	{
+		VkBuffer buffer = m_BufferCopies[i].Buffer;
+		regions.clear();
+
+		for (; i < m_BufferCopies.size() && m_BufferCopies[i].Buffer == buffer; ++i)
+			regions.push_back(m_BufferCopies[i].Region);
+
+		vkCmdCopyBuffer(submission.CommandBuffer, m_Buffer, buffer, static_cast<uint32_t>(regions.size()), regions.data());
+	}
+
+	for (const auto& copy : m_ImageCopies)
+		vkCmdCopyBufferToImage(submission.CommandBuffer, m_Buffer, copy.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.Region);
+
+	if (m_QueueFamily != m_DstQueueFamily)
+	{
+		RecordOwnershipRelease(submission);
+	}
+	else
+	{
+		// Later submissions on this queue see the writes without tracking each resource
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+		vkCmdPipelineBarrier(submission.CommandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+			0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	if (vkEndCommandBuffer(submission.CommandBuffer) != VK_SUCCESS)
+	{
+		m_FreeSubmissions.push_back(std::move(submission));
+		return;
+	}
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &submission.CommandBuffer;
+
+	VkResult result;
+
+	if (m_QueueMutex != nullptr)
+	{
+		std::lock_guard<std::mutex> queueLock(*m_QueueMutex);
+		result = vkQueueSubmit(m_Queue, 1, &submitInfo, submission.Fence);
+	}
+	else
+	{
+		result = vkQueueSubmit(m_Queue, 1, &submitInfo, submission.Fence);
+	}
+
+	if (result != VK_SUCCESS)
+	{
+		LOGE("GearsError::Staging submit failed, dropping %zu uploads", m_BufferCopies.size() + m_ImageCopies.size());
+		m_FreeSubmissions.push_back(std::move(submission));
+
+		// The dropped data still occupies the ring, hand it to whatever retires next
+		if (m_InFlight.empty())
+			m_Ring.Release(m_Ring.GetMarker());
+		else
+			m_InFlight.back().RingMarker = m_Ring.GetMarker();
+	}
+	else
+	{
+		submission.RingMarker = m_Ring.GetMarker();
+		submission.Serial = m_NextSerial++;
+		m_InFlight.push_back(std::move(submission));
+	}
+
+	m_BufferCopies.clear();
+	m_ImageCopies.clear();
+}
+
+// Releases every destination written by this submission to the destination
+// family and keeps the matching acquires for RecordAcquireBarriers
+void Gears::StagingManager::RecordOwnershipRelease(Submission& submission)
+{
+	submission.BufferAcquires.clear();
+	submission.ImageAcquires.clear();
+
+	// Buffer copies are sorted by destination at this point
+	for (size_t i = 0; i < m_BufferCopies.size(); ++i)
+	{
+		if (i > 0 && m_BufferCopies[i].Buffer == m_BufferCopies[i - 1].Buffer)
+			continue;
+
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+		barrier.srcQueueFamilyIndex = m_QueueFamily;
+		barrier.dstQueueFamilyIndex = m_DstQueueFamily;
+		barrier.buffer = m_BufferCopies[i].Buffer;
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+
+		submission.BufferAcquires.push_back(barrier);
+	}
+
+	for (const auto& copy : m_ImageCopies)
+	{
+		const auto& layers = copy.Region.imageSubresource;
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = m_QueueFamily;
+		barrier.dstQueueFamilyIndex = m_DstQueueFamily;
+		barrier.image = copy.Image;
+		barrier.subresourceRange = { layers.aspectMask, layers.mipLevel, 1, layers.baseArrayLayer, layers.layerCount };
+
+		submission.ImageAcquires.push_back(barrier);
+	}
+
+	// The release half is the same barrier with the access masks on the other side
+	std::vector<VkBufferMemoryBarrier> bufferReleases = submission.BufferAcquires;
+	std::vector<VkImageMemoryBarrier> imageReleases = submission.ImageAcquires;
+
+	for (auto& barrier : bufferReleases)
+	{
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+	}
+
+	for (auto& barrier : imageReleases)
+	{
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+	}
+
+	vkCmdPipelineBarrier(submission.CommandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+		static_cast<uint32_t>(bufferReleases.size()), bufferReleases.data(),
+		static_cast<uint32_t>(imageReleases.size()), imageReleases.data());
+}
+
+void Gears::StagingManager::RecordAcquireBarriers(VkCommandBuffer commandBuffer)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	if (!m_BufferAcquires.empty() || !m_ImageAcquires.empty())
+	{
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr,
+			static_cast<uint32_t>(m_BufferAcquires.size()), m_BufferAcquires.data(),
+			static_cast<uint32_t>(m_ImageAcquires.size()), m_ImageAcquires.data());
+
+		m_BufferAcquires.clear();
+		m_ImageAcquires.clear();
+	}
+
+	// Only now is everything up to the retired serial usable from the destination queue
+	m_CompletedSerial.store(m_RetiredSerial, std::memory_order_release);
+}
+
+uint64_t Gears::StagingManager::GetPendingSerial()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_NextSerial;
+}
+
+void Gears::StagingManager::Reclaim()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	ReclaimLocked(false);
+}
+
+VkDeviceSize Gears::StagingManager::GetUsedBytes() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Ring.GetUsedBytes();
+}
+
+void Gears::StagingManager::WaitIdle()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+
+	FlushLocked();
+
+	while (!m_InFlight.empty())
+		ReclaimLocked(true);
+}
+
+// Submissions retire in order, so the ring tail only ever moves forward.
+// With wait set, blocks on the oldest fence and retires at least that one.
+void Gears::StagingManager::ReclaimLocked(bool wait)
+{
+	while (!m_InFlight.empty())
+	{
+		Submission& oldest = m_InFlight.front();
+
+		if (wait)
+		{
+			vkWaitForFences(m_Device, 1, &oldest.Fence, VK_TRUE, UINT64_MAX);
+			wait = false;
+		}
+		else if (vkGetFenceStatus(m_Device, oldest.Fence) != VK_SUCCESS)
+		{
+			break;
+		}
+
+		m_Ring.Release(oldest.RingMarker);
+		m_RetiredSerial = oldest.Serial;
+
+		m_BufferAcquires.insert(m_BufferAcquires.end(), oldest.BufferAcquires.begin(), oldest.BufferAcquires.end());
+		m_ImageAcquires.insert(m_ImageAcquires.end(), oldest.ImageAcquires.begin(), oldest.ImageAcquires.end());
+		oldest.BufferAcquires.clear();
+		oldest.ImageAcquires.clear();
+
+		vkResetFences(m_Device, 1, &oldest.Fence);
+		vkResetCommandBuffer(oldest.CommandBuffer, 0);
+
+		m_FreeSubmissions.push_back(std::move(oldest));
+		m_InFlight.pop_front();
+	}
+}
+
+bool Gears::StagingManager::AcquireSubmission(Submission& submission)
+{
+	if (!m_FreeSubmissions.empty())
+	{
+		submission = std::move(m_FreeSubmissions.back());
+		m_FreeSubmissions.pop_back();
+		return true;
+	}
+
+	VkCommandBufferAllocateInfo allocateInfo{};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocateInfo.commandPool = m_CommandPool;
+	allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocateInfo.commandBufferCount = 1;
+
+	if (vkAllocateCommandBuffers(m_Device, &allocateInfo, &submission.CommandBuffer) != VK_SUCCESS)
+	{
+		LOGE("GearsError::Failed to allocate staging command buffer");
+		return false;
+	}
+
+	VkFenceCreateInfo fenceInfo{};
+	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	if (vkCreateFence(m_Device, &fenceInfo, m_AllocationCallbacks, &submission.Fence) != VK_SUCCESS)
+	{
+		vkFreeCommandBuffers(m_Device, m_CommandPool, 1, &submission.CommandBuffer);
+		LOGE("GearsError::Failed to create staging fence");
+		return false;
+	}
+
+	submission.RingMarker = 0;
+	return true;
+}
@@ -0,0 +1,138 @@
+#include "startup_timeline.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+namespace
+{
+	thread_local uint32_t t_Depth = 0;
+
+	uint32_t CurrentThreadId()
+	{
+		return static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+	}
+}
+
+Gears::StartupTimeline::Scope::Scope(StartupTimeline& timeline, const char* name) :
+	m_Timeline( timeline ),
+	m_Name( name ),
+	m_Start( Clock::now() ),
+	m_Depth( t_Depth++ )
+{
+	if (timeline.m_Progress)
+		timeline.m_Progress->Step.store(name, std::memory_order_relaxed);
+}
+
+Gears::StartupTimeline::Scope::~Scope()
+{
+	--t_Depth;
+	m_Timeline.Record(m_Name, m_Start, Clock::now(), m_Depth);
+
+	if (m_Timeline.m_Progress)
+		m_Timeline.m_Progress->Completed.fetch_add(1, std::memory_order_relaxed);
+}
+
+Gears::StartupTimeline::StartupTimeline() :
+	m_Origin( Clock::now() )
+{
+}
+
+void Gears::StartupTimeline::Record(const char* name, Clock::time_point start, Clock::time_point end, uint32_t depth)
+{
+	using std::chrono::duration_cast;
+	using std::chrono::nanoseconds;
+
+	TimelineEvent event;
+	event.Name = name;
+	event.StartNs = start > m_Origin ? duration_cast<nanoseconds>(start - m_Origin).count() : 0;
+	event.DurationNs = end > start ? duration_cast<nanoseconds>(end - start).count() : 0;
+	event.ThreadId = CurrentThreadId();
+	event.Depth = depth;
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Events.push_back(event);
+}
+
+std::vector<Gears::TimelineEvent> Gears::StartupTimeline::GetEvents() const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Events;
+}
+
+double Gears::StartupTimeline::GetDurationMs(const char* name) const
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	uint64_t total = 0;
+
+	for (const auto& i : m_Events)
+		if (std::strcmp(i.Name, name) == 0)
+			total += i.DurationNs;
+
+	return total / 1e6;
+}
+
+std::string Gears::StartupTimeline::ToChromeTrace() const
+{
+	auto events = GetEvents();
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	char buffer[128];
+
+	for (size_t i = 0; i < events.size(); ++i)
+	{
+		if (i > 0)
+			json += ',';
+
+		// Step names are identifiers, anything needing escapes is dropped rather than breaking the file
+		json += "{\"name\":\"";
+
+		for (const char* c = events[i].Name; *c; ++c)
+			if (*c != '"' && *c != '\\' && static_cast<unsigned char>(*c) >= 0x20)
+				json += *c;
+
+		// Complete events, timestamps in microseconds
+		snprintf(buffer, sizeof(buffer), "\",\"cat\":\"startup\",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32 ",\"ts\":%.3f,\"dur\":%.3f}",
+			events[i].ThreadId, events[i].StartNs / 1e3, events[i].DurationNs / 1e3);
+
+		json += buffer;
+	}
+
+	json += "]}";
+	return json;
+}
+
+bool Gears::StartupTimeline::WriteChromeTrace(const std::string& path) const
+{
+	std::string json = ToChromeTrace();
+	FILE* file = fopen(path.c_str(), "wb");
+
+	if (file == nullptr)
+	{
+		LOGE("GearsError::Could not open %s for writing", path.c_str());
+		return false;
+	}
+
+	bool written = fwrite(json.data(), 1, json.size(), file) == json.size();
+	written = (fclose(file) == 0) && written;
+
+	if (!written)
+		LOGE("GearsError::Failed to write startup trace to %s", path.c_str());
+
+	return written;
+}
+
+void Gears::StartupTimeline::LogSummary() const
+{
+	static const char* indent = "          ";
+	const size_t maxIndent = std::strlen(indent);
+
+	for (const auto& i : GetEvents())
+	{
+		size_t width = std::min<size_t>(i.Depth * 2, maxIndent);
+		LOGI("Startup %s%s: %.3f ms", indent + maxIndent - width, i.Name, i.DurationNs / 1e6);
+	}
+}
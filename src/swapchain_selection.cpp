@@ -0,0 +1,95 @@
+#include "swapchain_selection.h"
+
+#include <algorithm>
+
+VkSurfaceFormatKHR Gears::ChooseSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& formats)
+{
+	static const VkFormat preferred[] = {
+		VK_FORMAT_B8G8R8A8_SRGB,
+		VK_FORMAT_R8G8B8A8_SRGB,
+		VK_FORMAT_B8G8R8A8_UNORM,
+		VK_FORMAT_R8G8B8A8_UNORM
+	};
+
+	// A lone UNDEFINED entry means any format is accepted
+	if (formats.size() == 1 && formats[0].format == VK_FORMAT_UNDEFINED)
+		return { preferred[0], VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+
+	for (VkFormat format : preferred)
+		for (const auto& i : formats)
+			if (i.format == format && i.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+				return i;
+
+	if (!formats.empty())
+		return formats[0];
+
+	return { VK_FORMAT_UNDEFINED, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+}
+
+VkPresentModeKHR Gears::ChoosePresentMode(const std::vector<VkPresentModeKHR>& modes, PresentPolicy policy)
+{
+	VkPresentModeKHR wanted = VK_PRESENT_MODE_FIFO_KHR;
+
+	switch (policy)
+	{
+		case PresentPolicy::LowLatency: wanted = VK_PRESENT_MODE_MAILBOX_KHR; break;
+		case PresentPolicy::Vsync:      wanted = VK_PRESENT_MODE_FIFO_KHR; break;
+		case PresentPolicy::Adaptive:   wanted = VK_PRESENT_MODE_FIFO_RELAXED_KHR; break;
+	}
+
+	if (std::find(modes.begin(), modes.end(), wanted) != modes.end())
+		return wanted;
+
+	return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+uint32_t Gears::ChooseImageCount(const VkSurfaceCapabilitiesKHR& capabilities, VkPresentModeKHR mode)
+{
+	uint32_t count = capabilities.minImageCount + 1;
+
+	if (mode == VK_PRESENT_MODE_MAILBOX_KHR)
+		count = std::max(count, 3u);
+
+	// A maximum of 0 means there is none
+	if (capabilities.maxImageCount > 0)
+		count = std::min(count, capabilities.maxImageCount);
+
+	return count;
+}
+
+VkExtent2D Gears::ChooseExtent(const VkSurfaceCapabilitiesKHR& capabilities, VkExtent2D windowExtent)
+{
+	if (capabilities.currentExtent.width != UINT32_MAX)
+		return capabilities.currentExtent;
+
+	return {
+		std::clamp(windowExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width),
+		std::clamp(windowExtent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height) };
+}
+
+VkCompositeAlphaFlagBitsKHR Gears::ChooseCompositeAlpha(const VkSurfaceCapabilitiesKHR& capabilities)
+{
+	// Android surfaces often only offer INHERIT, desktop ones OPAQUE
+	static const VkCompositeAlphaFlagBitsKHR preferred[] = {
+		VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
+		VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR,
+		VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR,
+		VK_COMPOSITE_ALPHA_POST_MULTIPLIED_BIT_KHR
+	};
+
+	for (auto alpha : preferred)
+		if (capabilities.supportedCompositeAlpha & alpha)
+			return alpha;
+
+	return VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+}
+
+VkImageUsageFlags Gears::ChooseImageUsage(const VkSurfaceCapabilitiesKHR& capabilities)
+{
+	const VkImageUsageFlags required = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+	if ((capabilities.supportedUsageFlags & required) != required)
+		return 0;
+
+	return required;
+}
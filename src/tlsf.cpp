@@ -0,0 +1,272 @@
+#include "tlsf.h"
+
+namespace
+{
+	void Mapping(uint64_t size, uint32_t& fl, uint32_t& sl)
+	{
+		// Sizes below one full second-level row get exact bins in row 0
+		if (size < Gears::TLSF_SL_COUNT)
+		{
+			fl = 0;
+			sl = static_cast<uint32_t>(size);
+			return;
+		}
+
+		uint32_t log2 = 63 - static_cast<uint32_t>(__builtin_clzll(size));
+		fl = log2 - Gears::TLSF_SL_LOG2 + 1;
+		sl = static_cast<uint32_t>(size >> (log2 - Gears::TLSF_SL_LOG2)) ^ Gears::TLSF_SL_COUNT;
+	}
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+void Gears::Tlsf::Init(uint64_t size)
+{
+	m_Nodes.clear();
+	m_UnusedNodes.clear();
+	m_FlBitmap = 0;
+	m_Size = size;
+	m_UsedSize = 0;
+	m_AllocationCount = 0;
+
+	for (uint32_t fl = 0; fl < TLSF_FL_COUNT; ++fl)
+	{
+		m_SlBitmaps[fl] = 0;
+
+		for (uint32_t sl = 0; sl < TLSF_SL_COUNT; ++sl)
+			m_FreeHeads[fl][sl] = TLSF_NULL_NODE;
+	}
+
+	uint32_t node = NewNode();
+	m_Nodes[node] = { 0, size, TLSF_NULL_NODE, TLSF_NULL_NODE, TLSF_NULL_NODE, TLSF_NULL_NODE, true };
+	InsertFree(node);
+}
+
+bool Gears::Tlsf::Allocate(uint64_t size, uint64_t alignment, TlsfAllocation& allocation)
+{
+	if (size == 0)
+		return false;
+
+	if (alignment == 0)
+		alignment = 1;
+
+	// Asking for the worst-case padding keeps the search a single bitmap lookup
+	uint32_t node = FindFree(size + alignment - 1);
+
+	if (node == TLSF_NULL_NODE)
+		return false;
+
+	RemoveFree(node);
+
+	uint64_t padding = AlignUp(m_Nodes[node].Offset, alignment) - m_Nodes[node].Offset;
+
+	// Neighbours of a free block are always in use, so split-off pieces never need merging
+	if (padding > 0)
+	{
+		uint32_t aligned = Split(node, padding);
+		InsertFree(node);
+		node = aligned;
+	}
+
+	if (m_Nodes[node].Size > size)
+		InsertFree(Split(node, size));
+
+	m_Nodes[node].Free = false;
+	m_UsedSize += size;
+	++m_AllocationCount;
+
+	allocation.Offset = m_Nodes[node].Offset;
+	allocation.Size = size;
+	allocation.Node = node;
+
+	return true;
+}
+
+void Gears::Tlsf::Free(const TlsfAllocation& allocation)
+{
+	uint32_t node = allocation.Node;
+
+	if (node == TLSF_NULL_NODE || m_Nodes[node].Free)
+		return;
+
+	m_Nodes[node].Free = true;
+	m_UsedSize -= m_Nodes[node].Size;
+	--m_AllocationCount;
+
+	uint32_t prev = m_Nodes[node].PrevPhysical;
+
+	if (prev != TLSF_NULL_NODE && m_Nodes[prev].Free)
+	{
+		RemoveFree(prev);
+		m_Nodes[prev].Size += m_Nodes[node].Size;
+		m_Nodes[prev].NextPhysical = m_Nodes[node].NextPhysical;
+
+		if (m_Nodes[node].NextPhysical != TLSF_NULL_NODE)
+			m_Nodes[m_Nodes[node].NextPhysical].PrevPhysical = prev;
+
+		ReleaseNode(node);
+		node = prev;
+	}
+
+	uint32_t next = m_Nodes[node].NextPhysical;
+
+	if (next != TLSF_NULL_NODE && m_Nodes[next].Free)
+	{
+		RemoveFree(next);
+		m_Nodes[node].Size += m_Nodes[next].Size;
+		m_Nodes[node].NextPhysical = m_Nodes[next].NextPhysical;
+
+		if (m_Nodes[next].NextPhysical != TLSF_NULL_NODE)
+			m_Nodes[m_Nodes[next].NextPhysical].PrevPhysical = node;
+
+		ReleaseNode(next);
+	}
+
+	InsertFree(node);
+}
+
+Gears::TlsfStats Gears::Tlsf::GetStats() const
+{
+	TlsfStats stats{};
+	stats.TotalSize = m_Size;
+	stats.UsedSize = m_UsedSize;
+	stats.AllocationCount = m_AllocationCount;
+
+	for (uint32_t fl = 0; fl < TLSF_FL_COUNT; ++fl)
+	{
+		for (uint32_t sl = 0; sl < TLSF_SL_COUNT; ++sl)
+		{
+			for (uint32_t node = m_FreeHeads[fl][sl]; node != TLSF_NULL_NODE; node = m_Nodes[node].NextFree)
+			{
+				stats.FreeSize += m_Nodes[node].Size;
+				++stats.FreeBlockCount;
+
+				if (m_Nodes[node].Size > stats.LargestFreeBlock)
+					stats.LargestFreeBlock = m_Nodes[node].Size;
+			}
+		}
+	}
+
+	return stats;
+}
+
+uint32_t Gears::Tlsf::NewNode()
+{
+	if (!m_UnusedNodes.empty())
+	{
+		uint32_t node = m_UnusedNodes.back();
+		m_UnusedNodes.pop_back();
+		return node;
+	}
+
+	m_Nodes.push_back({});
+	return static_cast<uint32_t>(m_Nodes.size() - 1);
+}
+
+void Gears::Tlsf::ReleaseNode(uint32_t node)
+{
+	m_UnusedNodes.push_back(node);
+}
+
+void Gears::Tlsf::InsertFree(uint32_t node)
+{
+	uint32_t fl, sl;
+	Mapping(m_Nodes[node].Size, fl, sl);
+
+	uint32_t head = m_FreeHeads[fl][sl];
+
+	m_Nodes[node].Free = true;
+	m_Nodes[node].PrevFree = TLSF_NULL_NODE;
+	m_Nodes[node].NextFree = head;
+
+	if (head != TLSF_NULL_NODE)
+		m_Nodes[head].PrevFree = node;
+
+	m_FreeHeads[fl][sl] = node;
+	m_FlBitmap |= 1ull << fl;
+	m_SlBitmaps[fl] |= 1u << sl;
+}
+
+void Gears::Tlsf::RemoveFree(uint32_t node)
+{
+	uint32_t fl, sl;
+	Mapping(m_Nodes[node].Size, fl, sl);
+
+	uint32_t prev = m_Nodes[node].PrevFree;
+	uint32_t next = m_Nodes[node].NextFree;
+
+	if (prev != TLSF_NULL_NODE)
+		m_Nodes[prev].NextFree = next;
+	else
+		m_FreeHeads[fl][sl] = next;
+
+	if (next != TLSF_NULL_NODE)
+		m_Nodes[next].PrevFree = prev;
+
+	if (m_FreeHeads[fl][sl] == TLSF_NULL_NODE)
+	{
+		m_SlBitmaps[fl] &= ~(1u << sl);
+
+		if (m_SlBitmaps[fl] == 0)
+			m_FlBitmap &= ~(1ull << fl);
+	}
+
+	m_Nodes[node].Free = false;
+}
+
+uint32_t Gears::Tlsf::FindFree(uint64_t size) const
+{
+	// Round up to the next bin so any block found is guaranteed to fit
+	if (size >= TLSF_SL_COUNT)
+	{
+		uint32_t log2 = 63 - static_cast<uint32_t>(__builtin_clzll(size));
+		uint64_t round = (1ull << (log2 - TLSF_SL_LOG2)) - 1;
+
+		if (size > UINT64_MAX - round)
+			return TLSF_NULL_NODE;
+
+		size += round;
+	}
+
+	uint32_t fl, sl;
+	Mapping(size, fl, sl);
+
+	uint32_t slMap = m_SlBitmaps[fl] & (~0u << sl);
+
+	if (slMap == 0)
+	{
+		uint64_t flMap = fl + 1 < 64 ? m_FlBitmap & (~0ull << (fl + 1)) : 0;
+
+		if (flMap == 0)
+			return TLSF_NULL_NODE;
+
+		fl = static_cast<uint32_t>(__builtin_ctzll(flMap));
+		slMap = m_SlBitmaps[fl];
+	}
+
+	return m_FreeHeads[fl][__builtin_ctz(slMap)];
+}
+
+uint32_t Gears::Tlsf::Split(uint32_t node, uint64_t size)
+{
+	uint32_t rest = NewNode(); // May grow m_Nodes, so index rather than hold references
+
+	m_Nodes[rest].Offset = m_Nodes[node].Offset + size;
+	m_Nodes[rest].Size = m_Nodes[node].Size - size;
+	m_Nodes[rest].PrevPhysical = node;
+	m_Nodes[rest].NextPhysical = m_Nodes[node].NextPhysical;
+	m_Nodes[rest].PrevFree = TLSF_NULL_NODE;
+	m_Nodes[rest].NextFree = TLSF_NULL_NODE;
+	m_Nodes[rest].Free = false;
+
+	if (m_Nodes[node].NextPhysical != TLSF_NULL_NODE)
+		m_Nodes[m_Nodes[node].NextPhysical].PrevPhysical = rest;
+
+	m_Nodes[node].NextPhysical = rest;
+	m_Nodes[node].Size = size;
+
+	return rest;
+}
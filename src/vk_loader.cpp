@@ -0,0 +1,75 @@
+#include "vk_loader.h"
+#include "Logger.h"
+
+#include <dlfcn.h>
+
+#define GEARS_VK_DEFINE(name) PFN_##name name = nullptr;
+
+PFN_vkGetInstanceProcAddr vkGetInstanceProcAddr = nullptr;
+
+GEARS_VK_GLOBAL_FUNCTIONS(GEARS_VK_DEFINE)
+GEARS_VK_INSTANCE_FUNCTIONS(GEARS_VK_DEFINE)
+GEARS_VK_DEVICE_FUNCTIONS(GEARS_VK_DEFINE)
+
+bool Gears::LoadVulkan()
+{
+	// Runs once, the loader stays open for the life of the process
+	static const bool loaded = []()
+	{
+#if defined(__ANDROID__)
+		const char* names[] = { "libvulkan.so" };
+#else
+		const char* names[] = { "libvulkan.so.1", "libvulkan.so" };
+#endif
+		void* library = nullptr;
+
+		for (const char* name : names)
+			if ((library = dlopen(name, RTLD_NOW | RTLD_LOCAL)) != nullptr)
+				break;
+
+		if (library == nullptr)
+		{
+			LOGE("GearsError::Could not load the Vulkan loader: %s", dlerror());
+			return false;
+		}
+
+		vkGetInstanceProcAddr = reinterpret_cast<PFN_vkGetInstanceProcAddr>(dlsym(library, "vkGetInstanceProcAddr"));
+
+		if (vkGetInstanceProcAddr == nullptr)
+		{
+			LOGE("GearsError::Vulkan loader does not export vkGetInstanceProcAddr");
+			return false;
+		}
+
+#define GEARS_VK_LOAD_GLOBAL(name) name = reinterpret_cast<PFN_##name>(vkGetInstanceProcAddr(VK_NULL_HANDLE, #name));
+		GEARS_VK_GLOBAL_FUNCTIONS(GEARS_VK_LOAD_GLOBAL)
+#undef GEARS_VK_LOAD_GLOBAL
+
+		return true;
+	}();
+
+	return loaded;
+}
+
+void Gears::LoadInstanceFunctions(VkInstance instance)
+{
+#define GEARS_VK_LOAD_INSTANCE(name) name = reinterpret_cast<PFN_##name>(vkGetInstanceProcAddr(instance, #name));
+	GEARS_VK_INSTANCE_FUNCTIONS(GEARS_VK_LOAD_INSTANCE)
+	GEARS_VK_DEVICE_FUNCTIONS(GEARS_VK_LOAD_INSTANCE)
+#undef GEARS_VK_LOAD_INSTANCE
+}
+
+void Gears::LoadDeviceFunctions(VkDevice device)
+{
+	uint32_t missing = 0;
+
+#define GEARS_VK_LOAD_DEVICE(name) \
+	name = reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(device, #name)); \
+	missing += name == nullptr;
+	GEARS_VK_DEVICE_FUNCTIONS(GEARS_VK_LOAD_DEVICE)
+#undef GEARS_VK_LOAD_DEVICE
+
+	// Entry points of extensions the device was created without come back null, which is fine until called
+	if (missing > 0)
+		LOGD("%u device functions unavailable", missing);
+}
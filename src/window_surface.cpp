@@ -0,0 +1,176 @@
+#include "window_surface.h"
+#include "Logger.h"
+
+#define VK_CHECK(x) if(x != VK_SUCCESS) { LOGE("GearsError::Vulkan error occured at line: %d", __LINE__); return false; }
+
+Gears::WindowSurface::~WindowSurface()
+{
+	Destroy();
+}
+
+bool Gears::WindowSurface::Create(VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device,
+	uint32_t presentFamily, const Platform& platform, PresentPolicy policy, const VkAllocationCallbacks* callbacks)
+{
+	m_Instance = instance;
+	m_PhysicalDevice = physicalDevice;
+	m_Device = device;
+	m_Platform = &platform;
+	m_Policy = policy;
+	m_AllocationCallbacks = callbacks;
+
+	LOGI("Creating %s surface", platform.GetName());
+	VK_CHECK(platform.CreateSurface(instance, m_AllocationCallbacks, &m_Surface));
+
+	// Queues were picked before any surface existed, the graphics family almost always presents
+	VkBool32 supported = VK_FALSE;
+	VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, presentFamily, m_Surface, &supported));
+
+	if (!supported)
+	{
+		LOGE("GearsError::Queue family %u cannot present to this surface", presentFamily);
+		Destroy();
+		return false;
+	}
+
+	if (!QueryCapabilities())
+	{
+		Destroy();
+		return false;
+	}
+
+	if (ChooseImageUsage(m_Capabilities) == 0)
+	{
+		LOGE("GearsError::Swapchain images cannot be cleared, the surface only supports usage 0x%x",
+			m_Capabilities.supportedUsageFlags);
+		Destroy();
+		return false;
+	}
+
+	// Formats and present modes are fixed for the life of the surface
+	uint32_t count;
+
+	VK_CHECK(vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, m_Surface, &count, nullptr));
+	m_SurfaceFormats = std::vector<VkSurfaceFormatKHR>(count);
+	VK_CHECK(vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, m_Surface, &count, m_SurfaceFormats.data()));
+
+	VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, m_Surface, &count, nullptr));
+	m_PresentModes = std::vector<VkPresentModeKHR>(count);
+	VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(physicalDevice, m_Surface, &count, m_PresentModes.data()));
+
+	LOGI("Surface formats: %zu, present modes: %zu", m_SurfaceFormats.size(), m_PresentModes.size());
+
+	// A window without area yet still gets its surface, the swapchain follows on the first frame it has one
+	m_Dirty = !CreateSwapchain(0);
+	return true;
+}
+
+void Gears::WindowSurface::Destroy()
+{
+	if (m_Device != VK_NULL_HANDLE)
+	{
+		DestroyRetired(UINT64_MAX);
+
+		if (m_Swapchain != VK_NULL_HANDLE)
+			vkDestroySwapchainKHR(m_Device, m_Swapchain, m_AllocationCallbacks);
+	}
+
+	if (m_Surface != VK_NULL_HANDLE)
+		vkDestroySurfaceKHR(m_Instance, m_Surface, m_AllocationCallbacks);
+
+	m_Swapchain = VK_NULL_HANDLE;
+	m_Surface = VK_NULL_HANDLE;
+	m_Images.clear();
+	m_SurfaceFormats.clear();
+	m_PresentModes.clear();
+	m_Dirty = false;
+}
+
+bool Gears::WindowSurface::Recreate(uint64_t frameIndex)
+{
+	if (!QueryCapabilities() || !CreateSwapchain(frameIndex))
+		return false;
+
+	m_Dirty = false;
+	return true;
+}
+
+void Gears::WindowSurface::DestroyRetired(uint64_t completedFrames)
+{
+	while (!m_Retired.empty() && m_Retired.front().FrameIndex <= completedFrames)
+	{
+		vkDestroySwapchainKHR(m_Device, m_Retired.front().Swapchain, m_AllocationCallbacks);
+		m_Retired.erase(m_Retired.begin());
+	}
+}
+
+bool Gears::WindowSurface::QueryCapabilities()
+{
+	VK_CHECK(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_PhysicalDevice, m_Surface, &m_Capabilities));
+	return true;
+}
+
+bool Gears::WindowSurface::CreateSwapchain(uint64_t frameIndex)
+{
+	VkExtent2D extent = ChooseExtent(m_Capabilities, m_Platform->GetWindowExtent());
+
+	// Minimized, or the window is not laid out yet
+	if (extent.width == 0 || extent.height == 0)
+		return false;
+
+	// Create checked this, but capabilities are queried again on every recreate
+	if (ChooseImageUsage(m_Capabilities) == 0)
+	{
+		LOGE("GearsError::Surface no longer supports usage 0x%x", m_Capabilities.supportedUsageFlags);
+		return false;
+	}
+
+	m_Format = ChooseSurfaceFormat(m_SurfaceFormats);
+	m_PresentMode = ChoosePresentMode(m_PresentModes, m_Policy);
+	m_Extent = extent;
+
+	VkSwapchainKHR oldSwapchain = m_Swapchain;
+
+	VkSwapchainCreateInfoKHR info{};
+	info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+	info.surface = m_Surface;
+	info.minImageCount = ChooseImageCount(m_Capabilities, m_PresentMode);
+	info.imageFormat = m_Format.format;
+	info.imageColorSpace = m_Format.colorSpace;
+	info.imageExtent = m_Extent;
+	info.imageArrayLayers = 1; // 2 for Stereo Applications
+	info.imageUsage = ChooseImageUsage(m_Capabilities);
+	info.imageSharingMode = VkSharingMode::VK_SHARING_MODE_EXCLUSIVE;
+
+	// Matching the display's rotation spares the compositor a rotation pass on Android
+	info.preTransform = m_Capabilities.currentTransform;
+	info.compositeAlpha = ChooseCompositeAlpha(m_Capabilities);
+	info.presentMode = m_PresentMode;
+	info.clipped = VK_TRUE;
+
+	// Lets the driver hand over resources, and images already queued keep presenting
+	info.oldSwapchain = oldSwapchain;
+
+	VkSwapchainKHR swapchain;
+	VkResult result = vkCreateSwapchainKHR(m_Device, &info, m_AllocationCallbacks, &swapchain);
+
+	// The old swapchain is retired even if creation fails. Frames in flight
+	// finish on it, so no vkDeviceWaitIdle is needed.
+	if (oldSwapchain != VK_NULL_HANDLE)
+		m_Retired.push_back({ oldSwapchain, frameIndex });
+
+	m_Swapchain = result == VK_SUCCESS ? swapchain : VK_NULL_HANDLE;
+	m_Images.clear();
+
+	VK_CHECK(result);
+
+	uint32_t count;
+
+	VK_CHECK(vkGetSwapchainImagesKHR(m_Device, m_Swapchain, &count, nullptr));
+	m_Images = std::vector<VkImage>(count);
+	VK_CHECK(vkGetSwapchainImagesKHR(m_Device, m_Swapchain, &count, m_Images.data()));
+
+	LOGI("Swapchain %ux%u, format %d, present mode %d, %u images",
+		m_Extent.width, m_Extent.height, m_Format.format, m_PresentMode, count);
+
+	return true;
+}
@@ -0,0 +1,205 @@
+#include <vector>
+
+#include "catch.h"
+#include "app_lifecycle.h"
+
+namespace
+{
+    using Gears::LifecycleEvent;
+    using Gears::StepResult;
+
+    struct ScriptedEvent
+    {
+        LifecycleEvent Event;
+        uint32_t       AfterPolls; // Non-blocking polls that pass before it arrives
+    };
+
+    // Plays back a fixed event sequence. Blocking polls skip ahead to the
+    // next event, as the OS would wake the thread for it; timed polls only
+    // count down. Every return from PollOnce is one wakeup of the thread.
+    class FakeLooper : public Gears::Looper
+    {
+        public:
+
+        FakeLooper(Gears::AppLifecycle& lifecycle, std::vector<ScriptedEvent> script) :
+            m_Lifecycle( lifecycle ),
+            m_Script( std::move(script) )
+        {
+        }
+
+        bool PollOnce(int timeoutMs) override
+        {
+            ++Wakeups;
+
+            if (m_Next == m_Script.size())
+            {
+                // Would sleep forever, end the run instead of hanging the test
+                if (timeoutMs < 0)
+                {
+                    BlockedForever = true;
+                    m_Lifecycle.OnEvent(LifecycleEvent::Destroy);
+                    return true;
+                }
+
+                ++EmptyWakeups;
+                return false;
+            }
+
+            if (timeoutMs >= 0 && m_Polls < m_Script[m_Next].AfterPolls)
+            {
+                ++m_Polls;
+                ++EmptyWakeups;
+
+                if (timeoutMs > 0)
+                    ++TimedWakeups;
+
+                return false;
+            }
+
+            m_Polls = 0;
+            m_Lifecycle.OnEvent(m_Script[m_Next++].Event);
+            return true;
+        }
+
+        uint32_t Wakeups = 0;
+        uint32_t EmptyWakeups = 0;  // Woke up with nothing to dispatch
+        uint32_t TimedWakeups = 0;  // Of those, ones that waited out a timeout
+        bool     BlockedForever = false;
+
+        private:
+
+        Gears::AppLifecycle&       m_Lifecycle;
+        std::vector<ScriptedEvent> m_Script;
+        size_t                     m_Next = 0;
+        uint32_t                   m_Polls = 0;
+    };
+}
+
+TEST_CASE( "Rendering needs both resume and a window, in either order", "[lifecycle]" )
+{
+    Gears::AppLifecycle lifecycle;
+
+    lifecycle.OnEvent(LifecycleEvent::Start);
+    lifecycle.OnEvent(LifecycleEvent::Resume);
+    REQUIRE_FALSE( lifecycle.ShouldRender() );
+    REQUIRE( lifecycle.GetPollTimeout(StepResult::Idle) == -1 );
+
+    lifecycle.OnEvent(LifecycleEvent::WindowCreated);
+    REQUIRE( lifecycle.ShouldRender() );
+    REQUIRE( lifecycle.GetPollTimeout(StepResult::Rendered) == 0 );
+
+    // Allowed to render is not enough, only a frame that came out keeps the loop spinning
+    REQUIRE( lifecycle.GetPollTimeout(StepResult::Pending) == Gears::PENDING_POLL_MS );
+    REQUIRE( lifecycle.GetPollTimeout(StepResult::Idle) == -1 );
+
+    lifecycle.OnEvent(LifecycleEvent::Pause);
+    REQUIRE_FALSE( lifecycle.ShouldRender() );
+    REQUIRE( lifecycle.HasWindow() );
+    REQUIRE( lifecycle.GetPollTimeout(StepResult::Rendered) == -1 );
+    REQUIRE( lifecycle.GetPollTimeout(StepResult::Pending) == Gears::PENDING_POLL_MS );
+
+    lifecycle.OnEvent(LifecycleEvent::Resume);
+    lifecycle.OnEvent(LifecycleEvent::Stop);
+    REQUIRE_FALSE( lifecycle.IsResumed() );
+    REQUIRE_FALSE( lifecycle.IsStarted() );
+
+    lifecycle.OnEvent(LifecycleEvent::Destroy);
+    REQUIRE( lifecycle.IsDestroyRequested() );
+    REQUIRE( lifecycle.GetPollTimeout(StepResult::Idle) == 0 );
+}
+
+TEST_CASE( "Event loop renders only while resumed with a window", "[lifecycle]" )
+{
+    Gears::AppLifecycle lifecycle;
+
+    FakeLooper looper{ lifecycle, {
+        { LifecycleEvent::Start,           0 },
+        { LifecycleEvent::Resume,          0 },
+        { LifecycleEvent::WindowCreated,   0 },
+        { LifecycleEvent::Pause,           10 },
+        { LifecycleEvent::WindowDestroyed, 0 },
+        { LifecycleEvent::Stop,            0 },
+        { LifecycleEvent::Destroy,         0 } } };
+
+    uint32_t frames = 0;
+    uint32_t steps = 0;
+
+    Gears::RunEventLoop(looper, lifecycle, [&]() {
+        ++steps;
+
+        if (!lifecycle.ShouldRender())
+            return StepResult::Idle;
+
+        ++frames;
+        return StepResult::Rendered;
+    });
+
+    REQUIRE_FALSE( looper.BlockedForever );
+    REQUIRE( frames == 10 );
+
+    // Each frame costs one empty poll, paused time costs none
+    REQUIRE( looper.EmptyWakeups == frames );
+    REQUIRE( looper.TimedWakeups == 0 );
+    REQUIRE( looper.Wakeups == frames + 7 );
+}
+
+TEST_CASE( "Paused loop wakes on a timeout only while work is pending", "[lifecycle]" )
+{
+    Gears::AppLifecycle lifecycle;
+
+    FakeLooper looper{ lifecycle, {
+        { LifecycleEvent::Start,   0 },
+        { LifecycleEvent::Destroy, 100 } } };
+
+    uint32_t pendingSteps = 3;
+
+    Gears::RunEventLoop(looper, lifecycle, [&]() {
+        REQUIRE_FALSE( lifecycle.ShouldRender() );
+
+        if (pendingSteps == 0)
+            return StepResult::Idle;
+
+        --pendingSteps;
+        return StepResult::Pending;
+    });
+
+    // The first step runs after Start is drained, then three timed waits
+    // while work is pending, then the thread sleeps until Destroy
+    REQUIRE( pendingSteps == 0 );
+    REQUIRE( looper.TimedWakeups == 3 );
+    REQUIRE( looper.EmptyWakeups == 4 );
+    REQUIRE_FALSE( looper.BlockedForever );
+}
+
+TEST_CASE( "Resumed with a window but no graphics does not spin", "[lifecycle]" )
+{
+    Gears::AppLifecycle lifecycle;
+
+    // Destroy only comes after many polls, a spinning loop would use them all up
+    FakeLooper looper{ lifecycle, {
+        { LifecycleEvent::Start,         0 },
+        { LifecycleEvent::Resume,        0 },
+        { LifecycleEvent::WindowCreated, 0 },
+        { LifecycleEvent::Destroy,       1000 } } };
+
+    uint32_t initSteps = 3;
+
+    // Init runs for three steps and fails, leaving nothing to render
+    Gears::RunEventLoop(looper, lifecycle, [&]() {
+        REQUIRE( lifecycle.ShouldRender() );
+
+        if (initSteps == 0)
+            return StepResult::Idle;
+
+        --initSteps;
+        return StepResult::Pending;
+    });
+
+    // One drain poll per event burst, timed waits while init is pending,
+    // then the thread sleeps until Destroy instead of polling 1000 times
+    REQUIRE( initSteps == 0 );
+    REQUIRE( looper.TimedWakeups == 3 );
+    REQUIRE( looper.EmptyWakeups == 4 );
+    REQUIRE( looper.Wakeups == 4 + 4 );
+    REQUIRE_FALSE( looper.BlockedForever );
+}
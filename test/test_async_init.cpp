@@ -0,0 +1,85 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "catch.h"
+#include "async_init.h"
+
+TEST_CASE( "Async init hands its result over once ready", "[init]" )
+{
+    Gears::AsyncInit<int> init;
+    std::atomic<bool> release{ false };
+    std::thread::id worker;
+
+    REQUIRE( init.GetState() == Gears::InitState::Idle );
+
+    init.Start([&]() {
+        worker = std::this_thread::get_id();
+
+        while (!release.load())
+            std::this_thread::yield();
+
+        return std::make_unique<int>(42);
+    });
+
+    // Polling never waits for the work
+    REQUIRE( init.IsRunning() );
+    REQUIRE( init.Take() == nullptr );
+
+    release = true;
+
+    while (init.IsRunning())
+        std::this_thread::yield();
+
+    REQUIRE( init.GetState() == Gears::InitState::Ready );
+
+    auto result = init.Take();
+
+    REQUIRE( result );
+    REQUIRE( *result == 42 );
+    REQUIRE( worker != std::this_thread::get_id() );
+    REQUIRE( init.GetState() == Gears::InitState::Idle );
+}
+
+TEST_CASE( "Async init can start again after a failure", "[init]" )
+{
+    Gears::AsyncInit<int> init;
+
+    init.Start([]() { return std::unique_ptr<int>(); });
+    init.Wait();
+
+    REQUIRE( init.GetState() == Gears::InitState::Failed );
+
+    // A second start is ignored until the failure is taken
+    init.Start([]() { return std::make_unique<int>(1); });
+    REQUIRE( init.GetState() == Gears::InitState::Failed );
+
+    REQUIRE( init.Take() == nullptr );
+    REQUIRE( init.GetState() == Gears::InitState::Idle );
+
+    init.Start([]() { return std::make_unique<int>(2); });
+    init.Wait();
+
+    auto result = init.Take();
+
+    REQUIRE( result );
+    REQUIRE( *result == 2 );
+}
+
+TEST_CASE( "Async init joins a running worker on destruction", "[init]" )
+{
+    std::atomic<bool> finished{ false };
+
+    {
+        Gears::AsyncInit<int> init;
+
+        init.Start([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            finished = true;
+            return std::make_unique<int>(0);
+        });
+    }
+
+    REQUIRE( finished.load() );
+}
@@ -0,0 +1,147 @@
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "catch.h"
+#include "capability_snapshot.h"
+
+namespace
+{
+    Gears::CapabilitySnapshot MakeSnapshot()
+    {
+        Gears::CapabilitySnapshot snapshot;
+        snapshot.InstanceVersion = VK_API_VERSION_1_1;
+        snapshot.Build = 2;
+        snapshot.Layers = { "VK_LAYER_KHRONOS_validation" };
+        snapshot.InstanceExtensions = { "VK_KHR_surface", "VK_EXT_debug_report" };
+
+        Gears::CachedDevice device;
+        device.VendorID = 0x13B5;
+        device.DeviceID = 0x92020010;
+        device.DriverVersion = 38;
+        device.Score = 12345;
+        device.Suitable = true;
+        device.Extensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+
+        for (uint8_t i = 0; i < VK_UUID_SIZE; ++i)
+            device.PipelineCacheUUID[i] = i;
+
+        VkQueueFamilyProperties family{};
+        family.queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+        family.queueCount = 2;
+        device.Queues = { family, family };
+
+        snapshot.Devices.push_back(device);
+
+        device.DeviceID++;
+        device.Suitable = false;
+        device.Reason = "no graphics queue";
+        device.Queues.clear();
+        snapshot.Devices.push_back(device);
+
+        return snapshot;
+    }
+
+    std::vector<VkPhysicalDeviceProperties> MakeProperties(const Gears::CapabilitySnapshot& snapshot)
+    {
+        std::vector<VkPhysicalDeviceProperties> properties(snapshot.Devices.size());
+
+        for (size_t i = 0; i < properties.size(); ++i)
+        {
+            properties[i].vendorID = snapshot.Devices[i].VendorID;
+            properties[i].deviceID = snapshot.Devices[i].DeviceID;
+            properties[i].driverVersion = snapshot.Devices[i].DriverVersion;
+            std::memcpy(properties[i].pipelineCacheUUID, snapshot.Devices[i].PipelineCacheUUID, VK_UUID_SIZE);
+        }
+
+        return properties;
+    }
+}
+
+TEST_CASE( "Capability snapshots round trip", "[capabilities]" )
+{
+    auto snapshot = MakeSnapshot();
+    auto data = Gears::SerializeCapabilities(snapshot);
+
+    Gears::CapabilitySnapshot loaded;
+    REQUIRE( Gears::DeserializeCapabilities(data.data(), data.size(), loaded) );
+
+    REQUIRE( loaded.InstanceVersion == snapshot.InstanceVersion );
+    REQUIRE( loaded.Build == snapshot.Build );
+    REQUIRE( loaded.Layers == snapshot.Layers );
+    REQUIRE( loaded.InstanceExtensions == snapshot.InstanceExtensions );
+    REQUIRE( loaded.Devices.size() == 2 );
+    REQUIRE( loaded.Devices[0].Score == 12345 );
+    REQUIRE( loaded.Devices[0].Suitable );
+    REQUIRE( loaded.Devices[0].Extensions == snapshot.Devices[0].Extensions );
+    REQUIRE( loaded.Devices[0].Queues.size() == 2 );
+    REQUIRE( loaded.Devices[0].Queues[1].queueCount == 2 );
+    REQUIRE_FALSE( loaded.Devices[1].Suitable );
+    REQUIRE( loaded.Devices[1].Reason == "no graphics queue" );
+    REQUIRE( loaded.Devices[1].Queues.empty() );
+}
+
+TEST_CASE( "Damaged capability snapshots are rejected", "[capabilities]" )
+{
+    auto data = Gears::SerializeCapabilities(MakeSnapshot());
+    Gears::CapabilitySnapshot loaded;
+
+    SECTION( "flipped bits" )
+    {
+        data[data.size() / 2] ^= 0x1;
+        REQUIRE_FALSE( Gears::DeserializeCapabilities(data.data(), data.size(), loaded) );
+    }
+
+    SECTION( "truncation" )
+    {
+        for (size_t size : { size_t(0), size_t(8), data.size() - 1 })
+            REQUIRE_FALSE( Gears::DeserializeCapabilities(data.data(), size, loaded) );
+    }
+
+    SECTION( "format version bump" )
+    {
+        data[4]++;
+        REQUIRE_FALSE( Gears::DeserializeCapabilities(data.data(), data.size(), loaded) );
+    }
+
+    // Scores cached under other rules would pick the device the old rules liked
+    SECTION( "scoring version bump" )
+    {
+        data[8]++;
+        REQUIRE_FALSE( Gears::DeserializeCapabilities(data.data(), data.size(), loaded) );
+    }
+
+    REQUIRE( loaded.Devices.empty() );
+}
+
+TEST_CASE( "Capability snapshots only match the devices that wrote them", "[capabilities]" )
+{
+    auto snapshot = MakeSnapshot();
+    auto properties = MakeProperties(snapshot);
+
+    REQUIRE( Gears::MatchesDevices(snapshot, properties) );
+
+    SECTION( "driver updates invalidate the snapshot" )
+    {
+        properties[1].driverVersion++;
+        REQUIRE_FALSE( Gears::MatchesDevices(snapshot, properties) );
+    }
+
+    SECTION( "a different UUID invalidates the snapshot" )
+    {
+        properties[0].pipelineCacheUUID[7] ^= 0xFF;
+        REQUIRE_FALSE( Gears::MatchesDevices(snapshot, properties) );
+    }
+
+    SECTION( "reordered devices invalidate the snapshot" )
+    {
+        std::swap(properties[0], properties[1]);
+        REQUIRE_FALSE( Gears::MatchesDevices(snapshot, properties) );
+    }
+
+    SECTION( "added devices invalidate the snapshot" )
+    {
+        properties.push_back(properties[0]);
+        REQUIRE_FALSE( Gears::MatchesDevices(snapshot, properties) );
+    }
+}
@@ -0,0 +1,55 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "catch.h"
+#include "debug_report.h"
+#include "Logger.h"
+
+TEST_CASE( "Repeated validation messages are counted, not re-logged", "[debug]" )
+{
+    auto report = std::make_unique<Gears::DebugReportAggregator>();
+
+    constexpr int threadCount = 4;
+    constexpr int perThread = 5000;
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; ++t)
+        threads.emplace_back([&report, t]() {
+            for (int i = 0; i < perThread; ++i)
+                report->Report(VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT,
+                    i % 8, t == 0 && i < 8 ? "first" : "later");
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE( report->GetDistinctCount() == 8 );
+    REQUIRE( report->GetTotalPerformanceWarnings() == threadCount * perThread );
+
+    for (int code = 0; code < 8; ++code)
+        REQUIRE( report->GetCount(code, VK_DEBUG_REPORT_OBJECT_TYPE_COMMAND_BUFFER_EXT) == threadCount * perThread / 8 );
+
+    REQUIRE( report->GetCount(0, VK_DEBUG_REPORT_OBJECT_TYPE_IMAGE_EXT) == 0 );
+
+    report->LogSummary();
+    Gears::FlushLog();
+}
+
+TEST_CASE( "Performance warnings are totalled per frame", "[debug]" )
+{
+    auto report = std::make_unique<Gears::DebugReportAggregator>();
+
+    for (int i = 0; i < 3; ++i)
+        report->Report(VK_DEBUG_REPORT_PERFORMANCE_WARNING_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_PIPELINE_EXT, 42, "slow path");
+
+    report->Report(VK_DEBUG_REPORT_ERROR_BIT_EXT, VK_DEBUG_REPORT_OBJECT_TYPE_PIPELINE_EXT, 7, "not a perf warning");
+    report->EndFrame();
+
+    REQUIRE( report->GetLastFramePerformanceWarnings() == 3 );
+
+    report->EndFrame();
+    REQUIRE( report->GetLastFramePerformanceWarnings() == 0 );
+    REQUIRE( report->GetTotalPerformanceWarnings() == 3 );
+}
@@ -0,0 +1,113 @@
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "catch.h"
+#include "deletion_queue.h"
+
+namespace
+{
+    std::vector<uint64_t> s_Destroyed;
+
+    template<typename T>
+    T MakeHandle(uint64_t value)
+    {
+        T handle{};
+        static_assert(sizeof(T) <= sizeof(value), "Unexpected handle size");
+        memcpy(&handle, &value, sizeof(T));
+        return handle;
+    }
+
+    template<typename T>
+    uint64_t HandleValue(T handle)
+    {
+        uint64_t value = 0;
+        memcpy(&value, &handle, sizeof(T));
+        return value;
+    }
+
+    // Stand in for the driver, the loader's entry points are plain globals
+    struct FakeDestroy
+    {
+        PFN_vkDestroyBuffer   Buffer   = vkDestroyBuffer;
+        PFN_vkDestroyImage    Image    = vkDestroyImage;
+        PFN_vkDestroyPipeline Pipeline = vkDestroyPipeline;
+
+        FakeDestroy()
+        {
+            s_Destroyed.clear();
+            vkDestroyBuffer = [](VkDevice, VkBuffer b, const VkAllocationCallbacks*) { s_Destroyed.push_back(HandleValue(b)); };
+            vkDestroyImage = [](VkDevice, VkImage i, const VkAllocationCallbacks*) { s_Destroyed.push_back(HandleValue(i)); };
+            vkDestroyPipeline = [](VkDevice, VkPipeline p, const VkAllocationCallbacks*) { s_Destroyed.push_back(HandleValue(p)); };
+        }
+
+        ~FakeDestroy()
+        {
+            vkDestroyBuffer = Buffer;
+            vkDestroyImage = Image;
+            vkDestroyPipeline = Pipeline;
+        }
+    };
+}
+
+TEST_CASE( "Retired resources are destroyed once their value is reached", "[deletion]" )
+{
+    FakeDestroy fake;
+    Gears::DeletionQueue queue;
+    queue.Init(VK_NULL_HANDLE, nullptr);
+
+    queue.RetireBuffer(MakeHandle<VkBuffer>(1), {}, 1);
+    queue.RetireImage(MakeHandle<VkImage>(2), {}, 2);
+    queue.RetirePipeline(MakeHandle<VkPipeline>(3), 2);
+    queue.RetireBuffer(MakeHandle<VkBuffer>(4), {}, 5);
+
+    REQUIRE( queue.Collect(0) == 0 );
+    REQUIRE( s_Destroyed.empty() );
+
+    REQUIRE( queue.Collect(2) == 3 );
+    REQUIRE( s_Destroyed == std::vector<uint64_t>{ 1, 2, 3 } );
+    REQUIRE( queue.GetPendingCount() == 1 );
+
+    REQUIRE( queue.Collect(4) == 0 );
+
+    queue.Flush();
+    REQUIRE( s_Destroyed.size() == 4 );
+    REQUIRE( queue.GetPendingCount() == 0 );
+}
+
+TEST_CASE( "A smaller retire value waits for the ones before it", "[deletion]" )
+{
+    FakeDestroy fake;
+    Gears::DeletionQueue queue;
+    queue.Init(VK_NULL_HANDLE, nullptr);
+
+    queue.RetireBuffer(MakeHandle<VkBuffer>(1), {}, 10);
+    queue.RetireBuffer(MakeHandle<VkBuffer>(2), {}, 3);
+
+    // Releasing out of order would need a scan of the whole queue every frame
+    REQUIRE( queue.Collect(3) == 0 );
+    REQUIRE( queue.Collect(10) == 2 );
+    REQUIRE( s_Destroyed == std::vector<uint64_t>{ 1, 2 } );
+}
+
+TEST_CASE( "Resources can be retired from several threads", "[deletion]" )
+{
+    FakeDestroy fake;
+    Gears::DeletionQueue queue;
+    queue.Init(VK_NULL_HANDLE, nullptr);
+
+    std::vector<std::thread> threads;
+
+    for (uint64_t t = 0; t < 4; ++t)
+        threads.emplace_back([&queue, t]() {
+            for (uint64_t i = 0; i < 100; ++i)
+                queue.RetireImage(MakeHandle<VkImage>(t * 100 + i + 1), {}, 1);
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE( queue.GetPendingCount() == 400 );
+    REQUIRE( queue.Collect(1) == 400 );
+    REQUIRE( s_Destroyed.size() == 400 );
+}
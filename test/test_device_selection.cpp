@@ -0,0 +1,80 @@
+#include <cstring>
+
+#include "catch.h"
+#include "device_selection.h"
+
+namespace
+{
+    Gears::DeviceCandidate MakeCandidate(VkPhysicalDeviceType type, uint64_t localMemory)
+    {
+        Gears::DeviceCandidate candidate;
+        candidate.Properties.deviceType = type;
+        candidate.Properties.limits.maxImageDimension2D = 16384;
+        candidate.Properties.limits.maxColorAttachments = 8;
+
+        candidate.Memory.memoryHeapCount = 1;
+        candidate.Memory.memoryHeaps[0].size = localMemory;
+        candidate.Memory.memoryHeaps[0].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+
+        VkQueueFamilyProperties family{};
+        family.queueFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
+        family.queueCount = 1;
+        candidate.Queues.push_back(family);
+
+        candidate.Extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        return candidate;
+    }
+}
+
+TEST_CASE( "Discrete GPU beats a software rasterizer with more memory", "[device]" )
+{
+    const std::vector<const char*> required = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+
+    // lavapipe reports host RAM as device-local
+    auto lavapipe = MakeCandidate(VK_PHYSICAL_DEVICE_TYPE_CPU, 64ull << 30);
+    auto discrete = MakeCandidate(VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 8ull << 30);
+
+    std::vector<Gears::DeviceScore> scores = { Gears::ScoreDevice(lavapipe, required), Gears::ScoreDevice(discrete, required) };
+    scores[0].Index = 0;
+    scores[1].Index = 1;
+
+    REQUIRE( scores[0].Suitable );
+    REQUIRE( scores[1].Suitable );
+    REQUIRE( Gears::SelectDevice(scores) == 1 );
+
+    // An explicit override wins over the score
+    REQUIRE( Gears::SelectDevice(scores, 0) == 0 );
+    REQUIRE( Gears::SelectDevice(scores, 7) == 1 );
+}
+
+TEST_CASE( "Devices missing requirements are never selected", "[device]" )
+{
+    const std::vector<const char*> required = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+
+    auto noSwapchain = MakeCandidate(VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 8ull << 30);
+    noSwapchain.Extensions.clear();
+
+    auto computeOnly = MakeCandidate(VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, 8ull << 30);
+    computeOnly.Queues[0].queueFlags = VK_QUEUE_COMPUTE_BIT;
+
+    std::vector<Gears::DeviceScore> scores = { Gears::ScoreDevice(noSwapchain, required), Gears::ScoreDevice(computeOnly, required) };
+    scores[1].Index = 1;
+
+    REQUIRE_FALSE( scores[0].Suitable );
+    REQUIRE_FALSE( scores[1].Suitable );
+    REQUIRE( Gears::SelectDevice(scores) == UINT32_MAX );
+    REQUIRE( Gears::SelectDevice(scores, 0) == UINT32_MAX );
+}
+
+TEST_CASE( "Dedicated queues break ties between equal devices", "[device]" )
+{
+    auto plain = MakeCandidate(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 2ull << 30);
+    auto async = MakeCandidate(VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU, 2ull << 30);
+
+    VkQueueFamilyProperties transfer{};
+    transfer.queueFlags = VK_QUEUE_TRANSFER_BIT;
+    transfer.queueCount = 1;
+    async.Queues.push_back(transfer);
+
+    REQUIRE( Gears::ScoreDevice(async, {}).Score > Gears::ScoreDevice(plain, {}).Score );
+}
@@ -0,0 +1,22 @@
+#include "catch.h"
+#include "frame_arena.h"
+
+TEST_CASE( "Frame arena allocates linearly and resets", "[frame]" )
+{
+    Gears::FrameArena arena;
+    arena.Reserve(256);
+
+    auto* a = static_cast<uint8_t*>(arena.Allocate(3, 1));
+    auto* b = arena.AllocateArray<uint64_t>(2);
+
+    REQUIRE( a != nullptr );
+    REQUIRE( b != nullptr );
+    REQUIRE( reinterpret_cast<uintptr_t>(b) % alignof(uint64_t) == 0 );
+    REQUIRE( arena.GetUsedBytes() == 8 + 2 * sizeof(uint64_t) );
+
+    REQUIRE( arena.Allocate(512) == nullptr );
+
+    arena.Reset();
+    REQUIRE( arena.GetUsedBytes() == 0 );
+    REQUIRE( arena.Allocate(256, 1) == a );
+}
@@ -0,0 +1,150 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "catch.h"
+#include "gpu_profiler.h"
+
+namespace
+{
+    // Ticks the fake GPU writes, indexed by query
+    std::vector<uint64_t> s_Timestamps;
+    std::vector<uint32_t> s_Written;
+    uint32_t              s_Pools = 0;
+
+    // Stand in for the driver, the loader's entry points are plain globals
+    struct FakeQueries
+    {
+        PFN_vkCreateQueryPool     Create  = vkCreateQueryPool;
+        PFN_vkDestroyQueryPool    Destroy = vkDestroyQueryPool;
+        PFN_vkCmdResetQueryPool   Reset   = vkCmdResetQueryPool;
+        PFN_vkCmdWriteTimestamp   Write   = vkCmdWriteTimestamp;
+        PFN_vkGetQueryPoolResults Results = vkGetQueryPoolResults;
+
+        FakeQueries()
+        {
+            s_Timestamps.assign(64, 0);
+            s_Written.clear();
+            s_Pools = 0;
+
+            vkCreateQueryPool = [](VkDevice, const VkQueryPoolCreateInfo*, const VkAllocationCallbacks*, VkQueryPool* pool) {
+                uint64_t value = ++s_Pools;
+                memcpy(pool, &value, sizeof(*pool));
+                return VK_SUCCESS;
+            };
+            vkDestroyQueryPool = [](VkDevice, VkQueryPool, const VkAllocationCallbacks*) { --s_Pools; };
+            vkCmdResetQueryPool = [](VkCommandBuffer, VkQueryPool, uint32_t, uint32_t) { s_Written.clear(); };
+            vkCmdWriteTimestamp = [](VkCommandBuffer, VkPipelineStageFlagBits, VkQueryPool, uint32_t query) { s_Written.push_back(query); };
+            vkGetQueryPoolResults = [](VkDevice, VkQueryPool, uint32_t first, uint32_t count, size_t, void* data, VkDeviceSize, VkQueryResultFlags) {
+                memcpy(data, &s_Timestamps[first], count * sizeof(uint64_t));
+                return VK_SUCCESS;
+            };
+        }
+
+        ~FakeQueries()
+        {
+            vkCreateQueryPool = Create;
+            vkDestroyQueryPool = Destroy;
+            vkCmdResetQueryPool = Reset;
+            vkCmdWriteTimestamp = Write;
+            vkGetQueryPoolResults = Results;
+        }
+    };
+}
+
+TEST_CASE( "Timestamp deltas convert ticks and wrap within the valid bits", "[gpu_profiler]" )
+{
+    REQUIRE( Gears::TimestampDeltaNs(100, 350, 64, 1.0f) == 250 );
+    REQUIRE( Gears::TimestampDeltaNs(100, 350, 64, 2.5f) == 625 );
+
+    // A 36-bit counter that wrapped between the two queries
+    const uint64_t top = (uint64_t(1) << 36) - 10;
+    REQUIRE( Gears::TimestampDeltaNs(top, 5, 36, 1.0f) == 15 );
+}
+
+TEST_CASE( "Zones are resolved once their slot comes around again", "[gpu_profiler]" )
+{
+    FakeQueries fake;
+    Gears::GpuProfiler profiler;
+    REQUIRE( profiler.Init(VK_NULL_HANDLE, 2, 8, 2.0f, 64) );
+    REQUIRE( s_Pools == 2 );
+
+    profiler.BeginFrame(VK_NULL_HANDLE, 0);
+    {
+        GEARS_GPU_ZONE(profiler, VK_NULL_HANDLE, "Shadows");
+    }
+    {
+        GEARS_GPU_ZONE(profiler, VK_NULL_HANDLE, "Lighting");
+    }
+    profiler.EndFrame(VK_NULL_HANDLE);
+    profiler.MarkSubmitted();
+
+    // Frame, shadows and lighting, each a begin and an end
+    REQUIRE( s_Written == std::vector<uint32_t>{ 0, 2, 3, 4, 5, 1 } );
+
+    s_Timestamps[0] = 1000;
+    s_Timestamps[1] = 1500;
+    s_Timestamps[2] = 1010;
+    s_Timestamps[3] = 1110;
+    s_Timestamps[4] = 1110;
+    s_Timestamps[5] = 1400;
+
+    // The other slot is still in flight, nothing resolved yet
+    profiler.BeginFrame(VK_NULL_HANDLE, 1);
+    profiler.EndFrame(VK_NULL_HANDLE);
+    profiler.MarkSubmitted();
+    REQUIRE( profiler.GetLastTimings().empty() );
+
+    profiler.BeginFrame(VK_NULL_HANDLE, 2);
+    profiler.EndFrame(VK_NULL_HANDLE);
+
+    const auto& timings = profiler.GetLastTimings();
+    REQUIRE( profiler.GetLastFrameIndex() == 0 );
+    REQUIRE( timings.size() == 3 );
+    REQUIRE( std::string(timings[0].Name) == "GpuFrame" );
+    REQUIRE( timings[0].DurationNs == 1000 );
+    REQUIRE( std::string(timings[1].Name) == "Shadows" );
+    REQUIRE( timings[1].StartNs == 20 );
+    REQUIRE( timings[1].DurationNs == 200 );
+    REQUIRE( std::string(timings[2].Name) == "Lighting" );
+    REQUIRE( timings[2].StartNs == 220 );
+    REQUIRE( timings[2].DurationNs == 580 );
+
+    profiler.Destroy();
+    REQUIRE( s_Pools == 0 );
+}
+
+TEST_CASE( "Unsubmitted frames and zones past the limit are never read", "[gpu_profiler]" )
+{
+    FakeQueries fake;
+    Gears::GpuProfiler profiler;
+    REQUIRE( profiler.Init(VK_NULL_HANDLE, 1, 2, 1.0f, 64) );
+
+    // Outside a frame there is nowhere to write
+    REQUIRE( profiler.BeginZone(VK_NULL_HANDLE, "Early") == Gears::GPU_ZONE_NONE );
+
+    profiler.BeginFrame(VK_NULL_HANDLE, 0);
+    REQUIRE( profiler.BeginZone(VK_NULL_HANDLE, "Fits") == 1 );
+    REQUIRE( profiler.BeginZone(VK_NULL_HANDLE, "Dropped") == Gears::GPU_ZONE_NONE );
+    profiler.EndFrame(VK_NULL_HANDLE);
+
+    // Recorded but never submitted, e.g. the frame failed halfway
+    profiler.BeginFrame(VK_NULL_HANDLE, 1);
+    REQUIRE( profiler.GetLastTimings().empty() );
+
+    profiler.Destroy();
+}
+
+TEST_CASE( "A queue without timestamps leaves the profiler disabled", "[gpu_profiler]" )
+{
+    FakeQueries fake;
+    Gears::GpuProfiler profiler;
+
+    REQUIRE_FALSE( profiler.Init(VK_NULL_HANDLE, 2, 8, 1.0f, 0) );
+    REQUIRE_FALSE( profiler.IsEnabled() );
+    REQUIRE( s_Pools == 0 );
+
+    profiler.BeginFrame(VK_NULL_HANDLE, 0);
+    REQUIRE( profiler.BeginZone(VK_NULL_HANDLE, "Pass") == Gears::GPU_ZONE_NONE );
+    REQUIRE( s_Written.empty() );
+}
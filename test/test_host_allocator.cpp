@@ -0,0 +1,151 @@
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "catch.h"
+#include "host_allocator.h"
+
+namespace
+{
+    // Calls through the callbacks exactly as a driver would
+    void* Allocate(const VkAllocationCallbacks* callbacks, size_t size, size_t alignment, VkSystemAllocationScope scope)
+    {
+        return callbacks->pfnAllocation(callbacks->pUserData, size, alignment, scope);
+    }
+
+    void Free(const VkAllocationCallbacks* callbacks, void* memory)
+    {
+        callbacks->pfnFree(callbacks->pUserData, memory);
+    }
+
+    bool IsAligned(const void* memory, size_t alignment)
+    {
+        return reinterpret_cast<uintptr_t>(memory) % alignment == 0;
+    }
+}
+
+TEST_CASE( "Driver allocations are tracked per scope", "[host_allocator]" )
+{
+    Gears::HostAllocator allocator;
+    const VkAllocationCallbacks* callbacks = allocator.GetCallbacks();
+
+    void* device = Allocate(callbacks, 1000, 8, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+    void* object = Allocate(callbacks, 200, 64, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+    void* command = Allocate(callbacks, 300, 256, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+
+    REQUIRE( IsAligned(object, 64) );
+    REQUIRE( IsAligned(command, 256) );
+
+    REQUIRE( allocator.GetStats(VK_SYSTEM_ALLOCATION_SCOPE_DEVICE).LiveBytes == 1000 );
+    REQUIRE( allocator.GetStats(VK_SYSTEM_ALLOCATION_SCOPE_OBJECT).LiveBytes == 200 );
+    REQUIRE( allocator.GetStats(VK_SYSTEM_ALLOCATION_SCOPE_COMMAND).LiveBytes == 300 );
+    REQUIRE( allocator.GetStats(VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE).Allocations == 0 );
+    REQUIRE( allocator.GetTotal().LiveBytes == 1500 );
+    REQUIRE( allocator.GetTotal().LiveAllocations == 3 );
+
+    Free(callbacks, command);
+    Free(callbacks, object);
+
+    // Peaks stay where they were, the total's is of the sum
+    Gears::HostAllocationStats total = allocator.GetTotal();
+    REQUIRE( total.LiveBytes == 1000 );
+    REQUIRE( total.PeakBytes == 1500 );
+    REQUIRE( total.Allocations == 3 );
+    REQUIRE( allocator.GetStats(VK_SYSTEM_ALLOCATION_SCOPE_COMMAND).PeakBytes == 300 );
+    REQUIRE( allocator.GetStats(VK_SYSTEM_ALLOCATION_SCOPE_COMMAND).LiveAllocations == 0 );
+
+    Free(callbacks, device);
+    Free(callbacks, nullptr);
+    REQUIRE( allocator.GetTotal().LiveBytes == 0 );
+}
+
+TEST_CASE( "Reallocation keeps the contents and moves the accounting", "[host_allocator]" )
+{
+    Gears::HostAllocator allocator;
+    const VkAllocationCallbacks* callbacks = allocator.GetCallbacks();
+
+    auto* memory = static_cast<uint8_t*>(callbacks->pfnReallocation(callbacks->pUserData, nullptr, 16, 16, VK_SYSTEM_ALLOCATION_SCOPE_CACHE));
+    REQUIRE( memory != nullptr );
+
+    for (uint8_t i = 0; i < 16; ++i)
+        memory[i] = i;
+
+    auto* grown = static_cast<uint8_t*>(callbacks->pfnReallocation(callbacks->pUserData, memory, 4096, 16, VK_SYSTEM_ALLOCATION_SCOPE_CACHE));
+    REQUIRE( grown != nullptr );
+
+    for (uint8_t i = 0; i < 16; ++i)
+        REQUIRE( grown[i] == i );
+
+    Gears::HostAllocationStats cache = allocator.GetStats(VK_SYSTEM_ALLOCATION_SCOPE_CACHE);
+    REQUIRE( cache.LiveBytes == 4096 );
+    REQUIRE( cache.LiveAllocations == 1 );
+    REQUIRE( cache.Allocations == 2 );
+
+    // A size of zero frees
+    REQUIRE( callbacks->pfnReallocation(callbacks->pUserData, grown, 0, 16, VK_SYSTEM_ALLOCATION_SCOPE_CACHE) == nullptr );
+    REQUIRE( allocator.GetTotal().LiveAllocations == 0 );
+}
+
+TEST_CASE( "Pooled allocations fall back to the heap once the pool is full", "[host_allocator]" )
+{
+    Gears::HostAllocator allocator;
+    allocator.Init(4096);
+    const VkAllocationCallbacks* callbacks = allocator.GetCallbacks();
+
+    std::vector<void*> allocations;
+
+    // Far more than the pool holds, every one must still be usable and aligned
+    for (int i = 0; i < 64; ++i)
+    {
+        void* memory = Allocate(callbacks, 256, 32, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+        REQUIRE( memory != nullptr );
+        REQUIRE( IsAligned(memory, 32) );
+        memset(memory, i, 256);
+        allocations.push_back(memory);
+    }
+
+    for (int i = 0; i < 64; ++i)
+        REQUIRE( static_cast<uint8_t*>(allocations[i])[255] == i );
+
+    for (void* memory : allocations)
+        Free(callbacks, memory);
+
+    REQUIRE( allocator.GetTotal().LiveBytes == 0 );
+    REQUIRE( allocator.GetTotal().PeakBytes == 64 * 256 );
+}
+
+TEST_CASE( "Internal driver allocations are only reported", "[host_allocator]" )
+{
+    Gears::HostAllocator allocator;
+    const VkAllocationCallbacks* callbacks = allocator.GetCallbacks();
+
+    callbacks->pfnInternalAllocation(callbacks->pUserData, 4096, VK_INTERNAL_ALLOCATION_TYPE_EXECUTABLE, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+    REQUIRE( allocator.GetStats(VK_SYSTEM_ALLOCATION_SCOPE_DEVICE).InternalBytes == 4096 );
+    REQUIRE( allocator.GetTotal().LiveBytes == 0 );
+
+    callbacks->pfnInternalFree(callbacks->pUserData, 4096, VK_INTERNAL_ALLOCATION_TYPE_EXECUTABLE, VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+    REQUIRE( allocator.GetTotal().InternalBytes == 0 );
+}
+
+TEST_CASE( "The callbacks may be called from several threads", "[host_allocator]" )
+{
+    Gears::HostAllocator allocator;
+    allocator.Init(64 * 1024);
+    const VkAllocationCallbacks* callbacks = allocator.GetCallbacks();
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([callbacks]() {
+            for (int i = 0; i < 1000; ++i)
+                Free(callbacks, Allocate(callbacks, 64 + i % 512, 16, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND));
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    Gears::HostAllocationStats command = allocator.GetStats(VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+    REQUIRE( command.Allocations == 4000 );
+    REQUIRE( command.LiveBytes == 0 );
+}
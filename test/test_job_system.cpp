@@ -0,0 +1,107 @@
+#include <atomic>
+#include <vector>
+
+#include "catch.h"
+#include "job_system.h"
+
+TEST_CASE( "Parallel for visits every index once", "[jobs]" )
+{
+    Gears::JobSystem jobs{ 3 };
+    std::vector<std::atomic<uint32_t>> visits(10000);
+
+    jobs.ParallelFor(static_cast<uint32_t>(visits.size()), [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+            visits[i].fetch_add(1);
+    });
+
+    for (auto& v : visits)
+        REQUIRE( v.load() == 1 );
+}
+
+TEST_CASE( "Dependencies run after the jobs they depend on", "[jobs]" )
+{
+    Gears::JobSystem jobs{ 3 };
+
+    for (int iteration = 0; iteration < 100; ++iteration)
+    {
+        std::atomic<int> stage{ 0 };
+        std::atomic<bool> ordered{ true };
+
+        Gears::Job* first  = jobs.Create([&]() { stage = 1; });
+        Gears::Job* second = jobs.Create([&]() { if (stage != 1) ordered = false; stage = 2; });
+        Gears::Job* third  = jobs.Create([&]() { if (stage != 2) ordered = false; stage = 3; });
+
+        jobs.AddDependency(third, second);
+        jobs.AddDependency(second, first);
+
+        jobs.Run(third);
+        jobs.Run(second);
+        jobs.Run(first);
+        jobs.Wait(third);
+
+        REQUIRE( ordered );
+        REQUIRE( stage == 3 );
+    }
+}
+
+TEST_CASE( "Parents complete only after their children", "[jobs]" )
+{
+    Gears::JobSystem jobs{ 2 };
+    std::atomic<int> counter{ 0 };
+
+    Gears::Job* root = jobs.CreateEmpty();
+
+    for (int i = 0; i < 64; ++i)
+    {
+        Gears::Job* child = jobs.Create([&jobs, &counter, root]() {
+            jobs.Run(jobs.Create([&counter]() { counter.fetch_add(1); }, root));
+            counter.fetch_add(1);
+        }, root);
+
+        jobs.Run(child);
+    }
+
+    jobs.Run(root);
+    jobs.Wait(root);
+
+    REQUIRE( counter == 128 );
+}
+
+TEST_CASE( "Dependencies beyond the continuation limit still run", "[jobs]" )
+{
+    Gears::JobSystem jobs{ 2 };
+    std::atomic<int> counter{ 0 };
+    std::atomic<int> slotRanAt{ -1 };
+    std::atomic<int> lastRanAt{ -1 };
+
+    Gears::Job* first = jobs.CreateEmpty();
+    std::vector<Gears::Job*> dependents;
+
+    // The first one takes a continuation slot of first and is timed below
+    dependents.push_back(jobs.Create([&counter, &slotRanAt]() { slotRanAt = counter.fetch_add(1); }));
+    jobs.AddDependency(dependents.back(), first);
+
+    for (uint32_t i = 1; i < Gears::JOB_MAX_CONTINUATIONS * 3; ++i)
+    {
+        dependents.push_back(jobs.Create([&counter]() { counter.fetch_add(1); }));
+        jobs.AddDependency(dependents.back(), first);
+    }
+
+    // Past the limit, and the job in the first slot has a pending dependency
+    // on it: it must not end up waiting on that slot's job in turn
+    Gears::Job* last = jobs.Create([&counter, &lastRanAt]() { lastRanAt = counter.fetch_add(1); });
+    jobs.AddDependency(last, first);
+    jobs.AddDependency(dependents.front(), last);
+
+    for (auto* job : dependents)
+        jobs.Run(job);
+
+    jobs.Run(last);
+    jobs.Run(first);
+
+    for (auto* job : dependents)
+        jobs.Wait(job);
+
+    REQUIRE( counter == static_cast<int>(Gears::JOB_MAX_CONTINUATIONS * 3 + 1) );
+    REQUIRE( slotRanAt > lastRanAt );
+}
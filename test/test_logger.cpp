@@ -0,0 +1,128 @@
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.h"
+#include "Logger.h"
+
+namespace
+{
+    template<typename... Args>
+    std::string Format(const char* format, Args... args)
+    {
+        Gears::LogRecord record{};
+        record.Format = format;
+
+        Gears::LogEncoder encoder{ record };
+        (encoder.Add(args), ...);
+
+        char buffer[Gears::LOG_MESSAGE_SIZE];
+        size_t length = Gears::FormatLogRecord(record, buffer, sizeof(buffer));
+        return std::string(buffer, length);
+    }
+
+    template<typename... Args>
+    std::string Printf(const char* format, Args... args)
+    {
+        char buffer[Gears::LOG_MESSAGE_SIZE];
+        snprintf(buffer, sizeof(buffer), format, args...);
+        return buffer;
+    }
+
+    class CaptureSink : public Gears::LogSink
+    {
+        public:
+
+        std::mutex               Mutex;
+        std::vector<std::string> Lines;
+
+        void Write(Gears::LogLevel, const char* message, size_t length) override
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Lines.emplace_back(message, length);
+        }
+    };
+}
+
+TEST_CASE( "Deferred formatting matches printf", "[log]" )
+{
+    enum class Kind : uint32_t { Discrete = 2 };
+    char name[16] = "lavapipe";
+    int local = 0;
+
+    REQUIRE( Format("%d %u %x", -5, 7u, 0xBEEFu) == Printf("%d %u %x", -5, 7u, 0xBEEFu) );
+    REQUIRE( Format("%u %x", -1, -1) == Printf("%u %x", static_cast<unsigned>(-1), static_cast<unsigned>(-1)) );
+    REQUIRE( Format("%lld %llu %zu", -1ll << 40, ~0ull, size_t(12)) == Printf("%lld %llu %zu", -1ll << 40, ~0ull, size_t(12)) );
+    REQUIRE( Format("%5.2f|%-6s|%.3s|%c|%%", 3.14159, "ab", "abcdef", 'z') == Printf("%5.2f|%-6s|%.3s|%c|%%", 3.14159, "ab", "abcdef", 'z') );
+    REQUIRE( Format("%s on %u", name, Kind::Discrete) == "lavapipe on 2" );
+    REQUIRE( Format("%p", &local) == Printf("%p", static_cast<void*>(&local)) );
+    REQUIRE( Format("%s", static_cast<const char*>(nullptr)) == "(null)" );
+}
+
+TEST_CASE( "Star width and precision consume their own argument", "[log]" )
+{
+    REQUIRE( Format("%*d|%-*d|%.*s|%d", 5, 42, 4, 7, 3, "abcdef", 9) == Printf("%*d|%-*d|%.*s|%d", 5, 42, 4, 7, 3, "abcdef", 9) );
+    REQUIRE( Format("%*.*f|%s", 8, 2, 3.14159, "next") == Printf("%*.*f|%s", 8, 2, 3.14159, "next") );
+    REQUIRE( Format("%*d|%.*d", -4, 1, -1, 2) == Printf("%*d|%.*d", -4, 1, -1, 2) );
+}
+
+TEST_CASE( "Oversized arguments are truncated, not overflowed", "[log]" )
+{
+    std::string large(1000, 'x');
+
+    std::string out = Format("%s|%d", large.c_str(), 42);
+
+    REQUIRE( out.size() < large.size() );
+    REQUIRE( out.compare(0, 100, large, 0, 100) == 0 );
+    REQUIRE( out.substr(out.size() - 4) == "|<?>" );
+}
+
+TEST_CASE( "Records from many threads all reach the sink in order", "[log]" )
+{
+    // Captured alone, thousands of lines would otherwise land on stderr
+    auto sink = std::make_unique<CaptureSink>();
+    CaptureSink* capture = sink.get();
+
+    Gears::FlushLog();
+    std::vector<std::unique_ptr<Gears::LogSink>> sinks;
+    sinks.push_back(std::move(sink));
+    sinks = Gears::SwapLogSinks(std::move(sinks));
+
+    constexpr int threadCount = 4;
+    constexpr int perThread = 1000; // Several times the ring size, so producers have to wait on the writer
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; ++t)
+        threads.emplace_back([t]() {
+            for (int i = 0; i < perThread; ++i)
+                Gears::Log(Gears::LogLevel::Debug, "test-thread %d line %d", t, i);
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    Gears::FlushLog();
+
+    // Restores the default sinks, the capture is handed back and outlives the checks below
+    sinks = Gears::SwapLogSinks(std::move(sinks));
+
+    std::lock_guard<std::mutex> lock(capture->Mutex);
+    std::vector<int> next(threadCount, 0);
+
+    for (const auto& line : capture->Lines)
+    {
+        int t, i;
+
+        if (sscanf(line.c_str(), "test-thread %d line %d", &t, &i) != 2)
+            continue;
+
+        REQUIRE( i == next[t] );
+        ++next[t];
+    }
+
+    for (int t = 0; t < threadCount; ++t)
+        REQUIRE( next[t] == perThread );
+}
@@ -0,0 +1,70 @@
+#include <cstring>
+#include <vector>
+
+#include "catch.h"
+#include "pipeline_cache.h"
+
+namespace
+{
+    VkPhysicalDeviceProperties MakeProperties()
+    {
+        VkPhysicalDeviceProperties properties{};
+        properties.vendorID = 0x13B5;
+        properties.deviceID = 0x92020010;
+        properties.driverVersion = 38;
+
+        for (uint8_t i = 0; i < VK_UUID_SIZE; ++i)
+            properties.pipelineCacheUUID[i] = i;
+
+        return properties;
+    }
+
+    // Mimics the VkPipelineCacheHeaderVersionOne a driver puts in front of its blob
+    std::vector<uint8_t> MakeBlob(const VkPhysicalDeviceProperties& properties)
+    {
+        std::vector<uint8_t> blob(128, 0xAB);
+        uint32_t header[4] = { 32, VK_PIPELINE_CACHE_HEADER_VERSION_ONE, properties.vendorID, properties.deviceID };
+
+        std::memcpy(blob.data(), header, sizeof(header));
+        std::memcpy(blob.data() + sizeof(header), properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        return blob;
+    }
+}
+
+TEST_CASE( "Pipeline cache blobs validate against the device that wrote them", "[pipeline_cache]" )
+{
+    auto properties = MakeProperties();
+    auto blob = MakeBlob(properties);
+    auto header = Gears::PipelineCache::MakeHeader(properties, blob.data(), blob.size());
+
+    REQUIRE( Gears::PipelineCache::Validate(header, properties, blob.data(), blob.size()) );
+
+    SECTION( "driver updates invalidate the cache" )
+    {
+        properties.driverVersion++;
+        REQUIRE_FALSE( Gears::PipelineCache::Validate(header, properties, blob.data(), blob.size()) );
+    }
+
+    SECTION( "a different UUID invalidates the cache" )
+    {
+        properties.pipelineCacheUUID[3] ^= 0xFF;
+        REQUIRE_FALSE( Gears::PipelineCache::Validate(header, properties, blob.data(), blob.size()) );
+    }
+
+    SECTION( "torn writes are rejected" )
+    {
+        blob[100] ^= 0x1;
+        REQUIRE_FALSE( Gears::PipelineCache::Validate(header, properties, blob.data(), blob.size()) );
+        REQUIRE_FALSE( Gears::PipelineCache::Validate(header, properties, blob.data(), blob.size() - 1) );
+    }
+
+    SECTION( "a driver header for another device is rejected" )
+    {
+        uint32_t otherDevice = properties.deviceID + 1;
+        std::memcpy(blob.data() + 12, &otherDevice, sizeof(otherDevice));
+        header = Gears::PipelineCache::MakeHeader(properties, blob.data(), blob.size());
+
+        REQUIRE_FALSE( Gears::PipelineCache::Validate(header, properties, blob.data(), blob.size()) );
+    }
+}
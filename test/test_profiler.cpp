@@ -0,0 +1,120 @@
+#define GEARS_PROFILER_ENABLED 1
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.h"
+#include "profiler.h"
+
+namespace
+{
+    std::vector<Gears::ProfileEvent> EventsNamed(const std::vector<Gears::ProfileEvent>& events, const std::string& name)
+    {
+        std::vector<Gears::ProfileEvent> named;
+
+        for (const auto& i : events)
+            if (name == i.Name)
+                named.push_back(i);
+
+        return named;
+    }
+}
+
+TEST_CASE( "Profile zones nest by time and are drained once", "[profiler]" )
+{
+    Gears::CollectProfileEvents();
+
+    {
+        GEARS_PROFILE_ZONE("TestOuter");
+        GEARS_PROFILE_ZONE("TestInner");
+        GEARS_PROFILE_COUNTER("TestCounter", 7);
+    }
+
+    auto events = Gears::CollectProfileEvents();
+    auto outer = EventsNamed(events, "TestOuter");
+    auto inner = EventsNamed(events, "TestInner");
+    auto counter = EventsNamed(events, "TestCounter");
+
+    REQUIRE( outer.size() == 1 );
+    REQUIRE( inner.size() == 1 );
+    REQUIRE( counter.size() == 1 );
+    REQUIRE( counter[0].Type == Gears::ProfileEventType::Counter );
+    REQUIRE( counter[0].Value == 7 );
+
+    // The outer zone spans the inner one
+    REQUIRE( outer[0].StartNs <= inner[0].StartNs );
+    REQUIRE( outer[0].StartNs + outer[0].Value >= inner[0].StartNs + inner[0].Value );
+
+    REQUIRE( EventsNamed(Gears::CollectProfileEvents(), "TestOuter").empty() );
+}
+
+TEST_CASE( "Every thread records into its own timeline", "[profiler]" )
+{
+    Gears::CollectProfileEvents();
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([]() {
+            for (int i = 0; i < 100; ++i)
+                GEARS_PROFILE_ZONE("TestWorker");
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    auto workers = EventsNamed(Gears::CollectProfileEvents(), "TestWorker");
+    REQUIRE( workers.size() == 400 );
+
+    std::vector<uint32_t> threadIds;
+
+    for (const auto& i : workers)
+        if (std::find(threadIds.begin(), threadIds.end(), i.ThreadId) == threadIds.end())
+            threadIds.push_back(i.ThreadId);
+
+    REQUIRE( threadIds.size() == 4 );
+}
+
+TEST_CASE( "A full ring drops events instead of blocking", "[profiler]" )
+{
+    Gears::CollectProfileEvents();
+    uint64_t dropped = Gears::GetDroppedProfileEvents();
+
+    for (uint32_t i = 0; i < Gears::PROFILE_RING_SIZE + 10; ++i)
+        GEARS_PROFILE_COUNTER("TestFill", i);
+
+    REQUIRE( Gears::GetDroppedProfileEvents() == dropped + 10 );
+    REQUIRE( EventsNamed(Gears::CollectProfileEvents(), "TestFill").size() == Gears::PROFILE_RING_SIZE );
+}
+
+TEST_CASE( "Profile events export as Chrome trace events", "[profiler]" )
+{
+    std::vector<Gears::ProfileEvent> events = {
+        { "RenderFrame", 1000, 2500000, 3, Gears::ProfileEventType::Zone },
+        { "StagingBytes", 2000, 4096, 3, Gears::ProfileEventType::Counter },
+        { "Frame", 500, 12, 0, Gears::ProfileEventType::Frame }
+    };
+
+    std::string json = Gears::ProfileToChromeTrace(events);
+
+    REQUIRE( json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0 );
+    REQUIRE( json.find("\"name\":\"RenderFrame\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":3,\"ts\":1.000,\"dur\":2500.000") != std::string::npos );
+    REQUIRE( json.find("\"ph\":\"C\",\"pid\":1,\"tid\":3,\"ts\":2.000,\"args\":{\"value\":4096}") != std::string::npos );
+    REQUIRE( json.find("\"ph\":\"i\",\"s\":\"g\"") != std::string::npos );
+    REQUIRE( json.substr(json.size() - 2) == "]}" );
+}
+
+TEST_CASE( "GPU zones land on a named track of their own", "[profiler]" )
+{
+    Gears::CollectProfileEvents();
+    Gears::ProfileGpuZone("TestGpuPass", 100, 50);
+
+    auto gpu = EventsNamed(Gears::CollectProfileEvents(), "TestGpuPass");
+    REQUIRE( gpu.size() == 1 );
+    REQUIRE( gpu[0].ThreadId == Gears::PROFILE_GPU_THREAD_ID );
+
+    std::string json = Gears::ProfileToChromeTrace(gpu);
+    REQUIRE( json.find("\"ph\":\"M\",\"pid\":1,\"tid\":4294967295,\"args\":{\"name\":\"GPU\"}},{\"name\":\"TestGpuPass\"") != std::string::npos );
+}
@@ -0,0 +1,65 @@
+#include "catch.h"
+#include "ring_allocator.h"
+
+TEST_CASE( "Ring allocator wraps and reuses released space", "[staging]" )
+{
+    Gears::RingAllocator ring;
+    ring.Init(256);
+
+    uint64_t a, b, c;
+
+    REQUIRE( ring.Allocate(100, 16, a) );
+    REQUIRE( ring.Allocate(100, 16, b) );
+    REQUIRE( a == 0 );
+    REQUIRE( b == 112 );
+
+    uint64_t firstSubmission = ring.GetMarker();
+
+    // Would straddle the end and nothing has been released yet
+    REQUIRE_FALSE( ring.Allocate(100, 16, c) );
+    REQUIRE( ring.GetUsedBytes() == 212 );
+
+    ring.Release(firstSubmission);
+    REQUIRE( ring.GetUsedBytes() == 0 );
+
+    REQUIRE( ring.Allocate(100, 16, c) );
+    REQUIRE( c == 0 );
+    REQUIRE( ring.GetUsedBytes() == 256 - 212 + 100 );
+}
+
+TEST_CASE( "Ring allocator never hands out overlapping live ranges", "[staging]" )
+{
+    Gears::RingAllocator ring;
+    ring.Init(1024);
+
+    struct Live { uint64_t Offset, Size, Marker; };
+    Live live[64];
+    uint32_t head = 0, tail = 0;
+    uint32_t seed = 7;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        uint64_t size = 1 + (seed >> 8) % 200;
+        uint64_t offset;
+
+        if (head - tail < 64 && ring.Allocate(size, 8, offset))
+        {
+            REQUIRE( offset % 8 == 0 );
+            REQUIRE( offset + size <= 1024 );
+
+            for (uint32_t j = tail; j < head; ++j)
+            {
+                const Live& other = live[j % 64];
+                REQUIRE( (offset + size <= other.Offset || other.Offset + other.Size <= offset) );
+            }
+
+            live[head++ % 64] = { offset, size, ring.GetMarker() };
+        }
+        else
+        {
+            REQUIRE( head != tail );
+            ring.Release(live[tail++ % 64].Marker);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include <string>
+#include <thread>
+
+#include "catch.h"
+#include "startup_timeline.h"
+
+TEST_CASE( "Startup scopes nest and record in completion order", "[timeline]" )
+{
+    Gears::StartupTimeline timeline;
+
+    {
+        Gears::StartupTimeline::Scope total{ timeline, "Graphics" };
+        { Gears::StartupTimeline::Scope step{ timeline, "CreateInstance" }; }
+        { Gears::StartupTimeline::Scope step{ timeline, "CreateLogicalDevice" }; }
+    }
+
+    auto events = timeline.GetEvents();
+
+    REQUIRE( events.size() == 3 );
+    REQUIRE( std::string(events[0].Name) == "CreateInstance" );
+    REQUIRE( std::string(events[2].Name) == "Graphics" );
+    REQUIRE( events[0].Depth == 1 );
+    REQUIRE( events[2].Depth == 0 );
+
+    // The parent spans both children
+    REQUIRE( events[2].StartNs <= events[0].StartNs );
+    REQUIRE( events[2].StartNs + events[2].DurationNs >= events[1].StartNs + events[1].DurationNs );
+}
+
+TEST_CASE( "Startup durations are summed by name", "[timeline]" )
+{
+    using namespace std::chrono;
+
+    Gears::StartupTimeline timeline;
+    auto start = Gears::StartupTimeline::Clock::now();
+
+    timeline.Record("CreateSwapChain", start, start + milliseconds(2));
+    timeline.Record("CreateSwapChain", start, start + milliseconds(3));
+    timeline.Record("CreateSurface", start, start + milliseconds(1));
+
+    REQUIRE( timeline.GetDurationMs("CreateSwapChain") == Approx(5.0) );
+    REQUIRE( timeline.GetDurationMs("CreateSurface") == Approx(1.0) );
+    REQUIRE( timeline.GetDurationMs("CreateInstance") == 0.0 );
+}
+
+TEST_CASE( "Startup timeline exports Chrome trace events", "[timeline]" )
+{
+    Gears::StartupTimeline timeline;
+    auto start = Gears::StartupTimeline::Clock::now();
+
+    timeline.Record("CreateInstance", start, start + std::chrono::microseconds(1500));
+    std::thread([&]() { Gears::StartupTimeline::Scope step{ timeline, "Bad\"Name" }; }).join();
+
+    std::string json = timeline.ToChromeTrace();
+
+    REQUIRE( json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0 );
+    REQUIRE( json.find("\"name\":\"CreateInstance\",\"cat\":\"startup\",\"ph\":\"X\"") != std::string::npos );
+    REQUIRE( json.find("\"dur\":1500.000") != std::string::npos );
+    REQUIRE( json.find("\"name\":\"BadName\"") != std::string::npos );
+    REQUIRE( json.substr(json.size() - 2) == "]}" );
+}
+
+TEST_CASE( "Startup progress follows scopes while attached", "[timeline]" )
+{
+    Gears::StartupTimeline timeline;
+    Gears::StartupProgress progress;
+
+    timeline.SetProgress(&progress);
+
+    {
+        Gears::StartupTimeline::Scope total{ timeline, "Graphics" };
+        REQUIRE( std::string(progress.Step.load()) == "Graphics" );
+
+        { Gears::StartupTimeline::Scope step{ timeline, "CreateInstance" }; }
+        REQUIRE( std::string(progress.Step.load()) == "CreateInstance" );
+        REQUIRE( progress.Completed.load() == 1 );
+    }
+
+    REQUIRE( progress.Completed.load() == 2 );
+
+    timeline.SetProgress(nullptr);
+    { Gears::StartupTimeline::Scope step{ timeline, "AttachWindow" }; }
+
+    REQUIRE( progress.Completed.load() == 2 );
+    REQUIRE( timeline.GetEvents().size() == 3 );
+}
@@ -0,0 +1,115 @@
+#include <vector>
+
+#include "catch.h"
+#include "swapchain_selection.h"
+
+namespace
+{
+    VkSurfaceCapabilitiesKHR MakeCapabilities()
+    {
+        VkSurfaceCapabilitiesKHR capabilities{};
+        capabilities.minImageCount = 2;
+        capabilities.maxImageCount = 8;
+        capabilities.currentExtent = { UINT32_MAX, UINT32_MAX };
+        capabilities.minImageExtent = { 1, 1 };
+        capabilities.maxImageExtent = { 4096, 4096 };
+        capabilities.supportedCompositeAlpha = VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR;
+        capabilities.supportedUsageFlags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        return capabilities;
+    }
+}
+
+TEST_CASE( "Surface format prefers 8-bit sRGB", "[swapchain]" )
+{
+    std::vector<VkSurfaceFormatKHR> formats = {
+        { VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+        { VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR },
+        { VK_FORMAT_R8G8B8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR }
+    };
+
+    REQUIRE( Gears::ChooseSurfaceFormat(formats).format == VK_FORMAT_R8G8B8A8_SRGB );
+
+    formats.pop_back();
+    REQUIRE( Gears::ChooseSurfaceFormat(formats).format == VK_FORMAT_R8G8B8A8_UNORM );
+
+    formats.pop_back();
+    REQUIRE( Gears::ChooseSurfaceFormat(formats).format == VK_FORMAT_A2B10G10R10_UNORM_PACK32 );
+
+    SECTION( "an undefined format leaves the choice to us" )
+    {
+        formats = { { VK_FORMAT_UNDEFINED, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR } };
+        REQUIRE( Gears::ChooseSurfaceFormat(formats).format == VK_FORMAT_B8G8R8A8_SRGB );
+    }
+}
+
+TEST_CASE( "Present mode follows the policy and falls back to FIFO", "[swapchain]" )
+{
+    std::vector<VkPresentModeKHR> modes = { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR };
+
+    REQUIRE( Gears::ChoosePresentMode(modes, Gears::PresentPolicy::LowLatency) == VK_PRESENT_MODE_MAILBOX_KHR );
+    REQUIRE( Gears::ChoosePresentMode(modes, Gears::PresentPolicy::Vsync) == VK_PRESENT_MODE_FIFO_KHR );
+    REQUIRE( Gears::ChoosePresentMode(modes, Gears::PresentPolicy::Adaptive) == VK_PRESENT_MODE_FIFO_KHR );
+
+    modes = { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR };
+
+    REQUIRE( Gears::ChoosePresentMode(modes, Gears::PresentPolicy::LowLatency) == VK_PRESENT_MODE_FIFO_KHR );
+    REQUIRE( Gears::ChoosePresentMode(modes, Gears::PresentPolicy::Adaptive) == VK_PRESENT_MODE_FIFO_RELAXED_KHR );
+}
+
+TEST_CASE( "Image count leaves room for mailbox within the surface limits", "[swapchain]" )
+{
+    auto capabilities = MakeCapabilities();
+
+    REQUIRE( Gears::ChooseImageCount(capabilities, VK_PRESENT_MODE_FIFO_KHR) == 3 );
+
+    capabilities.minImageCount = 1;
+    REQUIRE( Gears::ChooseImageCount(capabilities, VK_PRESENT_MODE_FIFO_KHR) == 2 );
+    REQUIRE( Gears::ChooseImageCount(capabilities, VK_PRESENT_MODE_MAILBOX_KHR) == 3 );
+
+    capabilities.maxImageCount = 2;
+    REQUIRE( Gears::ChooseImageCount(capabilities, VK_PRESENT_MODE_MAILBOX_KHR) == 2 );
+
+    capabilities.maxImageCount = 0;
+    capabilities.minImageCount = 4;
+    REQUIRE( Gears::ChooseImageCount(capabilities, VK_PRESENT_MODE_FIFO_KHR) == 5 );
+}
+
+TEST_CASE( "Extent follows the surface or is clamped from the window", "[swapchain]" )
+{
+    auto capabilities = MakeCapabilities();
+
+    VkExtent2D extent = Gears::ChooseExtent(capabilities, { 8000, 720 });
+    REQUIRE( extent.width == 4096 );
+    REQUIRE( extent.height == 720 );
+
+    capabilities.currentExtent = { 1080, 2400 };
+    extent = Gears::ChooseExtent(capabilities, { 8000, 720 });
+    REQUIRE( extent.width == 1080 );
+    REQUIRE( extent.height == 2400 );
+
+    REQUIRE( Gears::ChooseCompositeAlpha(capabilities) == VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR );
+}
+
+TEST_CASE( "Image usage requires a clearable color attachment", "[swapchain]" )
+{
+    auto capabilities = MakeCapabilities();
+
+    const VkImageUsageFlags required = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    REQUIRE( Gears::ChooseImageUsage(capabilities) == required );
+
+    // Extra usages are offered but not requested
+    capabilities.supportedUsageFlags |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
+    REQUIRE( Gears::ChooseImageUsage(capabilities) == required );
+
+    SECTION( "without transfer destination the frame cannot be cleared" )
+    {
+        capabilities.supportedUsageFlags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        REQUIRE( Gears::ChooseImageUsage(capabilities) == 0 );
+    }
+
+    SECTION( "without color attachment nothing can render to it" )
+    {
+        capabilities.supportedUsageFlags = VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        REQUIRE( Gears::ChooseImageUsage(capabilities) == 0 );
+    }
+}
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "catch.h"
+#include "tlsf.h"
+
+TEST_CASE( "TLSF honours alignment and never overlaps", "[tlsf]" )
+{
+    Gears::Tlsf tlsf;
+    tlsf.Init(1 << 20);
+
+    std::mt19937 rng{ 7 };
+    std::vector<Gears::TlsfAllocation> live;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        if (!live.empty() && rng() % 3 == 0)
+        {
+            size_t index = rng() % live.size();
+            tlsf.Free(live[index]);
+            live.erase(live.begin() + index);
+            continue;
+        }
+
+        uint64_t size = 1 + rng() % 4096;
+        uint64_t alignment = 1ull << (rng() % 9);
+
+        Gears::TlsfAllocation allocation;
+        if (tlsf.Allocate(size, alignment, allocation))
+        {
+            REQUIRE( allocation.Offset % alignment == 0 );
+            REQUIRE( allocation.Offset + allocation.Size <= tlsf.GetSize() );
+            live.push_back(allocation);
+        }
+    }
+
+    std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) { return a.Offset < b.Offset; });
+
+    for (size_t i = 1; i < live.size(); ++i)
+        REQUIRE( live[i - 1].Offset + live[i - 1].Size <= live[i].Offset );
+
+    for (auto& allocation : live)
+        tlsf.Free(allocation);
+
+    auto stats = tlsf.GetStats();
+    REQUIRE( tlsf.IsEmpty() );
+    REQUIRE( stats.FreeBlockCount == 1 );
+    REQUIRE( stats.LargestFreeBlock == tlsf.GetSize() );
+    REQUIRE( stats.Fragmentation() == 0.0f );
+}
+
+TEST_CASE( "TLSF reports fragmentation and fails cleanly when full", "[tlsf]" )
+{
+    Gears::Tlsf tlsf;
+    tlsf.Init(1024);
+
+    Gears::TlsfAllocation blocks[8];
+    for (auto& block : blocks)
+        REQUIRE( tlsf.Allocate(128, 1, block) );
+
+    Gears::TlsfAllocation overflow;
+    REQUIRE_FALSE( tlsf.Allocate(1, 1, overflow) );
+
+    // Free every other block, leaving four separate 128 byte holes
+    for (int i = 0; i < 8; i += 2)
+        tlsf.Free(blocks[i]);
+
+    auto stats = tlsf.GetStats();
+    REQUIRE( stats.FreeSize == 512 );
+    REQUIRE( stats.FreeBlockCount == 4 );
+    REQUIRE( stats.LargestFreeBlock == 128 );
+    REQUIRE( stats.Fragmentation() == Approx(0.75f) );
+    REQUIRE_FALSE( tlsf.Allocate(256, 1, overflow) );
+
+    tlsf.Free(blocks[1]);
+    REQUIRE( tlsf.Allocate(256, 1, overflow) );
+    REQUIRE( overflow.Offset == 0 );
+}